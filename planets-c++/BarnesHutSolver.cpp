@@ -0,0 +1,159 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include "BarnesHutSolver.h"
+#include "Profiler.h"
+#include <math.h>
+
+namespace planets {
+
+BarnesHutSolver::BarnesHutSolver(double theta, int leafSize) :
+		openingAngle(theta), maxLeafSize(leafSize) {
+
+}
+
+BarnesHutSolver::~BarnesHutSolver() {
+
+}
+
+double BarnesHutSolver::theta() const {
+	return openingAngle;
+}
+
+void BarnesHutSolver::theta(const double & _theta) {
+	openingAngle = _theta;
+}
+
+std::vector<double> BarnesHutSolver::getPotentials(
+		const BodySystem & system) const {
+	PLANETS_TIMER("BarnesHutSolver::getPotentials");
+	int numBodies = system.size();
+	std::vector<double> potentials(numBodies);
+	if (numBodies == 0) {
+		return potentials;
+	}
+
+	Octree tree(system, maxLeafSize);
+	const auto & m = tree.m();
+
+	// Walk the tree once for every body, in the sorted order so that
+	// neighboring walks touch the same cells.
+	parallelFor(numBodies, blockSize(), [&](int begin, int end, int) {
+		std::vector<int> stack;
+		long interactions = 0;
+		for (int i = begin; i < end; i++) {
+			double pot = 0.0;
+			interactions += walk(tree, i, stack,
+					[&](double mass, double, double, double, double dist2) {
+						pot += mass / sqrt(dist2);
+					});
+			// Scale by G and M
+			potentials[tree.order()[i]] = -G * m[i] * pot;
+		}
+		PLANETS_COUNT(Interactions, interactions);
+	});
+
+	return potentials;
+}
+
+void BarnesHutSolver::getAccelerations(const BodySystem & system,
+		double * ax, double * ay, double * az) const {
+	PLANETS_TIMER("BarnesHutSolver::getAccelerations");
+	int numBodies = system.size();
+	if (numBodies == 0) {
+		return;
+	}
+
+	Octree tree(system, maxLeafSize);
+
+	parallelFor(numBodies, blockSize(), [&](int begin, int end, int) {
+		std::vector<int> stack;
+		long interactions = 0;
+		for (int i = begin; i < end; i++) {
+			double accX = 0.0, accY = 0.0, accZ = 0.0;
+			// The offsets point from the source to the body, so subtract
+			interactions += walk(tree, i, stack,
+					[&](double mass, double dx, double dy, double dz,
+							double dist2) {
+						double inv = 1.0 / sqrt(dist2);
+						double mInv3 = mass * inv * inv * inv;
+						accX -= mInv3 * dx;
+						accY -= mInv3 * dy;
+						accZ -= mInv3 * dz;
+					});
+			int index = tree.order()[i];
+			ax[index] = G * accX;
+			ay[index] = G * accY;
+			az[index] = G * accZ;
+		}
+		PLANETS_COUNT(Interactions, interactions);
+	});
+}
+
+void BarnesHutSolver::getAccelerations(const BodySystem & system,
+		const std::vector<int> & targets, double * ax, double * ay,
+		double * az) const {
+	PLANETS_TIMER("BarnesHutSolver::getAccelerations");
+	int numBodies = system.size();
+	if (numBodies == 0 || targets.empty()) {
+		return;
+	}
+
+	// Find where each target ended up in the sorted order of the tree
+	Octree tree(system, maxLeafSize);
+	std::vector<int> sortedIndex(numBodies);
+	for (int i = 0; i < numBodies; i++) {
+		sortedIndex[tree.order()[i]] = i;
+	}
+
+	parallelFor(targets.size(), blockSize(), [&](int begin, int end, int) {
+		std::vector<int> stack;
+		long interactions = 0;
+		for (int k = begin; k < end; k++) {
+			double accX = 0.0, accY = 0.0, accZ = 0.0;
+			interactions += walk(tree, sortedIndex[targets[k]], stack,
+					[&](double mass, double dx, double dy, double dz,
+							double dist2) {
+						double inv = 1.0 / sqrt(dist2);
+						double mInv3 = mass * inv * inv * inv;
+						accX -= mInv3 * dx;
+						accY -= mInv3 * dy;
+						accZ -= mInv3 * dz;
+					});
+			ax[k] = G * accX;
+			ay[k] = G * accY;
+			az[k] = G * accZ;
+		}
+		PLANETS_COUNT(Interactions, interactions);
+	});
+}
+
+} /* namespace planets */
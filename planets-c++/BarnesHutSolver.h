@@ -0,0 +1,167 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef BARNESHUTSOLVER_H_
+#define BARNESHUTSOLVER_H_
+
+#include "PotentialSolver.h"
+#include "Octree.h"
+
+namespace planets {
+
+/**
+ * The BarnesHutSolver computes the gravitational potential of every body in
+ * a system using the Barnes-Hut tree algorithm. The bodies are sorted into
+ * an Octree and distant cells are replaced by a point mass at their center of
+ * mass, which reduces the cost from O(N^2) for direct summation to
+ * O(N log N).
+ *
+ * A cell of edge length s at distance d from a body is accepted as a point
+ * mass if s/d < theta. The opening angle theta controls the trade between
+ * accuracy and speed. With theta = 0 every cell is opened and the result is
+ * the same as direct summation.
+ *
+ * The same walk computes the accelerations, which makes the Barnes-Hut
+ * solver the usual force backend for integrating large systems.
+ */
+class BarnesHutSolver: public PotentialSolver {
+
+	/// The opening angle
+	double openingAngle;
+
+	/// The maximum number of bodies in a leaf of the tree
+	int maxLeafSize;
+
+	/**
+	 * This operation walks the tree for body i of the sorted tree and calls
+	 * interact(mass, dx, dy, dz, dist2) for every accepted cell and every
+	 * body in an opened leaf, where (dx, dy, dz) is the offset of body i
+	 * from the source and dist2 is its squared length.
+	 * @param tree the tree
+	 * @param i the index of the body in the sorted order of the tree
+	 * @param stack scratch space for the walk
+	 * @param interact the function that adds the contribution of a source
+	 * @return the number of interactions
+	 */
+	template<typename Interaction>
+	long walk(const Octree & tree, int i, std::vector<int> & stack,
+			Interaction interact) const {
+		const auto & cells = tree.nodes();
+		const auto & x = tree.x();
+		const auto & y = tree.y();
+		const auto & z = tree.z();
+		const auto & m = tree.m();
+		double theta2 = openingAngle * openingAngle;
+		double dx = 0.0, dy = 0.0, dz = 0.0, dist2 = 0.0;
+		long interactions = 0;
+		stack.push_back(0);
+		while (!stack.empty()) {
+			const OctreeNode & cell = cells[stack.back()];
+			stack.pop_back();
+			// Cells that contain this body must always be opened to avoid
+			// the singularity.
+			bool containsBody = (i >= cell.begin && i < cell.end);
+			if (!containsBody) {
+				dx = x[i] - cell.com[0];
+				dy = y[i] - cell.com[1];
+				dz = z[i] - cell.com[2];
+				dist2 = dx * dx + dy * dy + dz * dz;
+				double width = 2.0 * cell.halfWidth;
+				if (width * width < theta2 * dist2) {
+					interact(cell.mass, dx, dy, dz, dist2);
+					interactions++;
+					continue;
+				}
+			}
+			if (cell.leaf) {
+				interactions += cell.end - cell.begin - (containsBody ? 1 : 0);
+				for (int j = cell.begin; j < cell.end; j++) {
+					if (j != i) {
+						dx = x[i] - x[j];
+						dy = y[i] - y[j];
+						dz = z[i] - z[j];
+						interact(m[j], dx, dy, dz,
+								dx * dx + dy * dy + dz * dz);
+					}
+				}
+			} else {
+				for (int k = 0; k < 8; k++) {
+					if (cell.child[k] >= 0) {
+						stack.push_back(cell.child[k]);
+					}
+				}
+			}
+		}
+		return interactions;
+	}
+
+public:
+
+	/**
+	 * Constructor
+	 * @param theta the opening angle
+	 * @param leafSize the maximum number of bodies in a leaf of the tree
+	 */
+	BarnesHutSolver(double theta = 0.5, int leafSize = 8);
+
+	/**
+	 * Destructor
+	 */
+	virtual ~BarnesHutSolver();
+
+	/**
+	 * This operation returns the opening angle.
+	 * @return the opening angle
+	 */
+	double theta() const;
+
+	/**
+	 * This operation sets the opening angle.
+	 * @param _theta the new opening angle
+	 */
+	void theta(const double & _theta);
+
+	using PotentialSolver::getPotentials;
+
+	virtual std::vector<double> getPotentials(
+			const BodySystem & system) const;
+
+	virtual void getAccelerations(const BodySystem & system, double * ax,
+			double * ay, double * az) const;
+
+	virtual void getAccelerations(const BodySystem & system,
+			const std::vector<int> & targets, double * ax, double * ay,
+			double * az) const;
+};
+
+} /* namespace planets */
+
+#endif /* BARNESHUTSOLVER_H_ */
@@ -0,0 +1,100 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include <algorithm>
+#include "BinaryBodyParser.h"
+#include "BodySnapshot.h"
+#include "Profiler.h"
+
+namespace planets {
+
+BinaryBodyParser::BinaryBodyParser() {
+
+}
+
+BinaryBodyParser::~BinaryBodyParser() {
+
+}
+
+std::vector<CelestialBody> BinaryBodyParser::parseBodies(
+		const std::string & inputFile) const {
+
+	// Map the snapshot. This throws if the file is not valid.
+	PLANETS_TIMER("BinaryBodyParser::parse");
+	BodySnapshot snapshot(inputFile);
+	PLANETS_COUNT(BytesRead, snapshot.fileSize());
+	PLANETS_COUNT(BodiesParsed, snapshot.size());
+
+	// Create the bodies
+	int numBodies = snapshot.size();
+	std::vector<CelestialBody> bodies;
+	bodies.reserve(numBodies);
+	for (int i = 0; i < numBodies; i++) {
+		bodies.push_back(CelestialBody(snapshot.data(i)));
+	}
+
+	return bodies;
+}
+
+BodySystem BinaryBodyParser::parseSystem(
+		const std::string & inputFile) const {
+	PLANETS_TIMER("BinaryBodyParser::parse");
+	BodySnapshot snapshot(inputFile);
+	PLANETS_COUNT(BytesRead, snapshot.fileSize());
+	PLANETS_COUNT(BodiesParsed, snapshot.size());
+	return snapshot.system();
+}
+
+void BinaryBodyParser::parseBodies(const std::string & inputFile,
+		int batchSize, const BatchHandler & handler) const {
+
+	// Map the snapshot. This throws if the file is not valid.
+	PLANETS_TIMER("BinaryBodyParser::parse");
+	BodySnapshot snapshot(inputFile);
+	PLANETS_COUNT(BytesRead, snapshot.fileSize());
+	PLANETS_COUNT(BodiesParsed, snapshot.size());
+
+	// Hand out the bodies a batch at a time
+	int numBodies = snapshot.size();
+	batchSize = std::max(batchSize, 1);
+	std::vector<CelestialBody> batch;
+	batch.reserve(std::min(batchSize, numBodies));
+	for (int i = 0; i < numBodies; i += batchSize) {
+		int batchEnd = std::min(i + batchSize, numBodies);
+		batch.clear();
+		for (int j = i; j < batchEnd; j++) {
+			batch.push_back(CelestialBody(snapshot.data(j)));
+		}
+		handler(batch);
+	}
+}
+
+} /* namespace planets */
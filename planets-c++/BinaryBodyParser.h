@@ -0,0 +1,80 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef BINARYBODYPARSER_H_
+#define BINARYBODYPARSER_H_
+
+#include "IBodyParser.h"
+
+namespace planets {
+
+/**
+ * This is an implementation of IBodyParser that reads the bodies from a
+ * binary snapshot file, as described on BodySnapshot. Snapshots can be
+ * created from CSV files with the csv2snapshot tool.
+ *
+ * Only the labels need to be converted, so this is much faster than
+ * parsing text. Clients that only need the positions, velocities and
+ * masses should use BodySnapshot directly, which reads them in place
+ * without any copies.
+ */
+class BinaryBodyParser: public IBodyParser {
+
+public:
+
+	/**
+	 * Constructor
+	 */
+	BinaryBodyParser();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~BinaryBodyParser();
+
+	virtual std::vector<CelestialBody> parseBodies(
+			const std::string & inputFile) const;
+
+	virtual BodySystem parseSystem(const std::string & inputFile) const;
+
+	/**
+	 * This operation parses an input file in batches, as described on
+	 * IBodyParser. The columns are read in place, so memory use is bounded by
+	 * the batch size no matter how big the snapshot is.
+	 */
+	virtual void parseBodies(const std::string & inputFile, int batchSize,
+			const BatchHandler & handler) const;
+
+};
+
+} /* namespace planets */
+
+#endif /* BINARYBODYPARSER_H_ */
@@ -0,0 +1,169 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include "BlockTimestepIntegrator.h"
+#include <math.h>
+#include <algorithm>
+
+namespace planets {
+
+BlockTimestepIntegrator::BlockTimestepIntegrator(
+		const PotentialSolver & forces, double epsilon, double eta,
+		int maxLevel) :
+		Integrator(forces), lengthScale(epsilon), accuracy(eta),
+		finestLevel(0) {
+	this->maxLevel(maxLevel);
+}
+
+BlockTimestepIntegrator::~BlockTimestepIntegrator() {
+
+}
+
+double BlockTimestepIntegrator::epsilon() const {
+	return lengthScale;
+}
+
+void BlockTimestepIntegrator::epsilon(const double & _epsilon) {
+	lengthScale = _epsilon;
+}
+
+double BlockTimestepIntegrator::eta() const {
+	return accuracy;
+}
+
+void BlockTimestepIntegrator::eta(const double & _eta) {
+	accuracy = _eta;
+}
+
+int BlockTimestepIntegrator::maxLevel() const {
+	return finestLevel;
+}
+
+void BlockTimestepIntegrator::maxLevel(const int & _maxLevel) {
+	finestLevel = std::min(std::max(_maxLevel, 0), 30);
+}
+
+const std::vector<int> & BlockTimestepIntegrator::levels() const {
+	return bodyLevels;
+}
+
+int BlockTimestepIntegrator::chooseLevel(int i, double dt) const {
+	double acc = sqrt(ax[i] * ax[i] + ay[i] * ay[i] + az[i] * az[i]);
+	double idealDt = sqrt(2.0 * accuracy * lengthScale / acc);
+	// Halve the step until it is small enough. Bodies without forces keep
+	// the largest step.
+	int level = 0;
+	while (level < finestLevel && dt / (1 << level) > idealDt) {
+		level++;
+	}
+	return level;
+}
+
+void BlockTimestepIntegrator::advance(BodySystem & system, double dt) {
+	int numBodies = system.size();
+	if (!accelerationsValid) {
+		computeAccelerations(system);
+	}
+
+	double * x = system.x(), * y = system.y(), * z = system.z();
+	double * vx = system.vx(), * vy = system.vy(), * vz = system.vz();
+	int numSubsteps = 1 << finestLevel;
+	double minDt = dt / numSubsteps;
+
+	// Pick the levels and open the steps of all bodies
+	bodyLevels.resize(numBodies);
+	for (int i = 0; i < numBodies; i++) {
+		bodyLevels[i] = chooseLevel(i, dt);
+		double halfDt = 0.5 * dt / (1 << bodyLevels[i]);
+		vx[i] += halfDt * ax[i];
+		vy[i] += halfDt * ay[i];
+		vz[i] += halfDt * az[i];
+	}
+
+	for (int s = 1; s <= numSubsteps; s++) {
+		// Drift everything
+		for (int i = 0; i < numBodies; i++) {
+			x[i] += minDt * vx[i];
+			y[i] += minDt * vy[i];
+			z[i] += minDt * vz[i];
+		}
+
+		// Find the bodies whose steps end now. A body on level k takes
+		// 2^(maxLevel - k) substeps.
+		active.clear();
+		for (int i = 0; i < numBodies; i++) {
+			if (s % (1 << (finestLevel - bodyLevels[i])) == 0) {
+				active.push_back(i);
+			}
+		}
+
+		// Compute their forces. When everybody is active, the solvers can
+		// skip the bookkeeping for subsets.
+		int numActive = active.size();
+		if (numActive == numBodies) {
+			computeAccelerations(system);
+		} else if (numActive > 0) {
+			activeX.resize(numActive);
+			activeY.resize(numActive);
+			activeZ.resize(numActive);
+			solver.getAccelerations(system, active, activeX.data(),
+					activeY.data(), activeZ.data());
+			countForceEvaluations(numActive);
+			for (int k = 0; k < numActive; k++) {
+				ax[active[k]] = activeX[k];
+				ay[active[k]] = activeY[k];
+				az[active[k]] = activeZ[k];
+			}
+		}
+
+		// Close their steps and, unless this is the end, open new ones
+		for (int i : active) {
+			double halfDt = 0.5 * dt / (1 << bodyLevels[i]);
+			vx[i] += halfDt * ax[i];
+			vy[i] += halfDt * ay[i];
+			vz[i] += halfDt * az[i];
+			if (s < numSubsteps) {
+				// Larger steps must start on a boundary of their block
+				int level = chooseLevel(i, dt);
+				while (s % (1 << (finestLevel - level)) != 0) {
+					level++;
+				}
+				bodyLevels[i] = level;
+				halfDt = 0.5 * dt / (1 << level);
+				vx[i] += halfDt * ax[i];
+				vy[i] += halfDt * ay[i];
+				vz[i] += halfDt * az[i];
+			}
+		}
+	}
+}
+
+} /* namespace planets */
@@ -0,0 +1,158 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef BLOCKTIMESTEPINTEGRATOR_H_
+#define BLOCKTIMESTEPINTEGRATOR_H_
+
+#include "Integrator.h"
+
+namespace planets {
+
+/**
+ * The BlockTimestepIntegrator is a kick-drift-kick leapfrog where every
+ * body takes its own time step, so that slow bodies do not pay for the
+ * orbits of fast ones. The steps are restricted to power-of-two fractions
+ * of the step given to step(), dt_k = dt/2^k for levels k = 0 ... maxLevel,
+ * which keeps the bodies in blocks that start and end together.
+ *
+ * Each call to step() is split into 2^maxLevel substeps of the smallest
+ * step. Every substep drifts all of the bodies, which is cheap, but only
+ * the active bodies whose own step ends on the substep get new forces, a
+ * closing half kick, a new level and an opening half kick. Forces on the
+ * active bodies use the drifted positions of the inactive ones. At the end
+ * of step() every body is active, so the system is synchronized again.
+ *
+ * The step of a body is picked with the criterion from GADGET,
+ * dt_i = sqrt(2 eta epsilon / |a_i|), where epsilon is a length that sets
+ * the scale of the problem, usually the softening length, and eta is the
+ * accuracy parameter. A body may always move to a smaller step, but only
+ * moves to a larger one when the larger step would start on a boundary of
+ * its block.
+ *
+ * With maxLevel = 0 this is exactly the LeapfrogIntegrator.
+ */
+class BlockTimestepIntegrator: public Integrator {
+
+	/// The length scale of the time step criterion
+	double lengthScale;
+
+	/// The accuracy parameter of the time step criterion
+	double accuracy;
+
+	/// The finest level
+	int finestLevel;
+
+	/// The level of every body
+	std::vector<int> bodyLevels;
+
+	/// The bodies that are active in a substep
+	std::vector<int> active;
+
+	/// The accelerations of the active bodies
+	std::vector<double> activeX, activeY, activeZ;
+
+	/**
+	 * This operation picks the level of a body from its acceleration.
+	 * @param i the index of the body
+	 * @param dt the step given to step()
+	 * @return the level
+	 */
+	int chooseLevel(int i, double dt) const;
+
+protected:
+
+	virtual void advance(BodySystem & system, double dt);
+
+public:
+
+	/**
+	 * Constructor
+	 * @param forces the solver that computes the accelerations
+	 * @param epsilon the length scale of the time step criterion
+	 * @param eta the accuracy parameter of the time step criterion
+	 * @param maxLevel the finest level
+	 */
+	BlockTimestepIntegrator(const PotentialSolver & forces, double epsilon,
+			double eta = 0.025, int maxLevel = 8);
+
+	/**
+	 * Destructor
+	 */
+	virtual ~BlockTimestepIntegrator();
+
+	/**
+	 * This operation returns the length scale of the time step criterion.
+	 * @return the length
+	 */
+	double epsilon() const;
+
+	/**
+	 * This operation sets the length scale of the time step criterion.
+	 * @param _epsilon the new length
+	 */
+	void epsilon(const double & _epsilon);
+
+	/**
+	 * This operation returns the accuracy parameter of the time step
+	 * criterion.
+	 * @return the accuracy parameter
+	 */
+	double eta() const;
+
+	/**
+	 * This operation sets the accuracy parameter of the time step criterion.
+	 * @param _eta the new accuracy parameter
+	 */
+	void eta(const double & _eta);
+
+	/**
+	 * This operation returns the finest level.
+	 * @return the level
+	 */
+	int maxLevel() const;
+
+	/**
+	 * This operation sets the finest level. Levels above 30 are not allowed.
+	 * @param _maxLevel the new finest level
+	 */
+	void maxLevel(const int & _maxLevel);
+
+	/**
+	 * This operation returns the level of every body in its last substep of
+	 * the last step.
+	 * @return the levels, one per body
+	 */
+	const std::vector<int> & levels() const;
+};
+
+} /* namespace planets */
+
+#endif /* BLOCKTIMESTEPINTEGRATOR_H_ */
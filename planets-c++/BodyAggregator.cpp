@@ -0,0 +1,157 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include "BodyAggregator.h"
+#include "DwarfPlanet.h"
+#include <algorithm>
+
+namespace planets {
+
+namespace {
+
+/// The number of body types
+const int numTypes = 3;
+
+/// The density in kg/m^3 of a body with a density of 1 g/cm^3
+const double kilogramsPerCubicMeter = 1000.0;
+
+} /* anonymous namespace */
+
+BodyAggregator::BodyAggregator() :
+		numThreads(1), bodyBlockSize(1 << 14) {
+
+}
+
+BodyAggregator::~BodyAggregator() {
+
+}
+
+int BodyAggregator::threads() const {
+	return numThreads;
+}
+
+void BodyAggregator::threads(const int & _threads) {
+	pool = ThreadPool::create(_threads);
+	numThreads = pool ? pool->size() : 1;
+}
+
+int BodyAggregator::blockSize() const {
+	return bodyBlockSize;
+}
+
+void BodyAggregator::blockSize(const int & _blockSize) {
+	bodyBlockSize = (_blockSize > 0) ? _blockSize : 1;
+}
+
+double BodyAggregator::density(const CelestialBodyType & type) {
+	// DwarfPlanet gives the density in g/cm^3, but the radii are in meters
+	return (type == DwarfPlanetary) ?
+			DwarfPlanet::density * kilogramsPerCubicMeter : 0.0;
+}
+
+void BodyAggregator::volumes(const BodySystem & system,
+		const CelestialBodyType & type, double * volumes,
+		double * impliedMasses) const {
+	int numMembers = system.count(type);
+	const double * radii = system.radii(type);
+	double typeDensity = density(type);
+	ThreadPool::parallelFor(pool, numMembers, bodyBlockSize, [&](int first, int last, int) {
+		for (int k = first; k < last; k++) {
+			double r = radii ? radii[k] : 0.0;
+			volumes[k] = DwarfPlanet::sphereFactor * r * r * r;
+		}
+		if (impliedMasses) {
+			for (int k = first; k < last; k++) {
+				impliedMasses[k] = typeDensity * volumes[k];
+			}
+		}
+	});
+}
+
+std::vector<BodyTotals> BodyAggregator::totals(
+		const BodySystem & system) const {
+
+	// Number the blocks of all types one after the other
+	int firstBlock[numTypes + 1] = {0};
+	for (int t = 0; t < numTypes; t++) {
+		int numMembers = system.count((CelestialBodyType) t);
+		firstBlock[t + 1] = firstBlock[t]
+				+ (numMembers + bodyBlockSize - 1) / bodyBlockSize;
+	}
+	int numBlocks = firstBlock[numTypes];
+
+	// Sum each block. The sums of the cubed radii are only multiplied by
+	// the constant factors once per block, which keeps the loop minimal.
+	std::vector<double> blockMasses(numBlocks), blockCubes(numBlocks);
+	const double * m = system.m();
+	ThreadPool::parallelFor(pool, numBlocks, 1, [&](int first, int last, int) {
+		for (int b = first; b < last; b++) {
+			int t = 0;
+			while (b >= firstBlock[t + 1]) {
+				t++;
+			}
+			CelestialBodyType type = (CelestialBodyType) t;
+			const int * members = system.members(type);
+			const double * radii = system.radii(type);
+			int begin = (b - firstBlock[t]) * bodyBlockSize;
+			int end = std::min(begin + bodyBlockSize, system.count(type));
+			double mass = 0.0, cubes = 0.0;
+			for (int k = begin; k < end; k++) {
+				mass += m[members[k]];
+			}
+			if (radii) {
+				for (int k = begin; k < end; k++) {
+					cubes += radii[k] * radii[k] * radii[k];
+				}
+			}
+			blockMasses[b] = mass;
+			blockCubes[b] = cubes;
+		}
+	});
+
+	// Add the blocks up in order
+	std::vector<BodyTotals> totals(numTypes);
+	for (int t = 0; t < numTypes; t++) {
+		BodyTotals & total = totals[t];
+		double cubes = 0.0;
+		for (int b = firstBlock[t]; b < firstBlock[t + 1]; b++) {
+			total.mass += blockMasses[b];
+			cubes += blockCubes[b];
+		}
+		total.count = system.count((CelestialBodyType) t);
+		total.volume = DwarfPlanet::sphereFactor * cubes;
+		total.impliedMass = density((CelestialBodyType) t) * total.volume;
+	}
+
+	return totals;
+}
+
+} /* namespace planets */
@@ -0,0 +1,149 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef BODYAGGREGATOR_H_
+#define BODYAGGREGATOR_H_
+
+#include <vector>
+#include <memory>
+#include "BodySystem.h"
+#include "ThreadPool.h"
+
+namespace planets {
+
+/**
+ * The totals of the bodies of one type.
+ */
+struct BodyTotals {
+	/// The number of bodies
+	int count = 0;
+	/// The sum of the masses of the bodies in kg
+	double mass = 0.0;
+	/// The sum of the volumes of the bodies with a planetary radius in m^3
+	double volume = 0.0;
+	/// The sum of the masses in kg implied by the volumes and the density of
+	/// the type, for types with a known density
+	double impliedMass = 0.0;
+};
+
+/**
+ * The BodyAggregator computes volumes, masses implied by a density and
+ * totals of a whole BodySystem, grouped by CelestialBodyType. It works on
+ * the per-type radius columns of the system, so every pass is a dense scan
+ * that the compiler can vectorize instead of a call on every body.
+ *
+ * The members of each type are split into fixed blocks. With several
+ * threads, the threads claim the blocks dynamically, but the partial sums
+ * of the blocks are always added in the same order, so the totals do not
+ * depend on the number of threads.
+ */
+class BodyAggregator {
+
+	/// The number of threads
+	int numThreads;
+
+	/// The number of bodies in a block of work
+	int bodyBlockSize;
+
+	/// The threads, or null for a single thread
+	std::shared_ptr<ThreadPool> pool;
+
+public:
+
+	/**
+	 * Constructor
+	 */
+	BodyAggregator();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~BodyAggregator();
+
+	/**
+	 * This operation returns the number of threads.
+	 * @return the number of threads
+	 */
+	int threads() const;
+
+	/**
+	 * This operation sets the number of threads.
+	 * @param _threads the number of threads, or 0 for one per core
+	 */
+	void threads(const int & _threads);
+
+	/**
+	 * This operation returns the number of bodies in a block of work.
+	 * @return the block size
+	 */
+	int blockSize() const;
+
+	/**
+	 * This operation sets the number of bodies in a block of work. The
+	 * totals are summed per block, so changing it changes their round-off.
+	 * @param _blockSize the new block size
+	 */
+	void blockSize(const int & _blockSize);
+
+	/**
+	 * This operation returns the density of a type of body. It is converted
+	 * from the g/cm^3 of DwarfPlanet::density to kg/m^3, so that multiplying
+	 * it by a volume in m^3 gives a mass in kg.
+	 * @param type the type
+	 * @return the density in kg/m^3, or zero if it is not known
+	 */
+	static double density(const CelestialBodyType & type);
+
+	/**
+	 * This operation computes the volume and the implied mass of every
+	 * member of a type, in the order of BodySystem::members().
+	 * @param system the system
+	 * @param type the type
+	 * @param volumes the volumes in m^3, one per member. They are zero for
+	 * types without a radius.
+	 * @param impliedMasses the implied masses in kg, one per member, or null
+	 * if they are not needed
+	 */
+	void volumes(const BodySystem & system, const CelestialBodyType & type,
+			double * volumes, double * impliedMasses = nullptr) const;
+
+	/**
+	 * This operation computes the totals of every type in one pass over the
+	 * system.
+	 * @param system the system
+	 * @return the totals, indexed by CelestialBodyType
+	 */
+	std::vector<BodyTotals> totals(const BodySystem & system) const;
+};
+
+} /* namespace planets */
+
+#endif /* BODYAGGREGATOR_H_ */
@@ -0,0 +1,356 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include "BodySnapshot.h"
+
+namespace planets {
+
+namespace {
+
+/// The magic string at the start of every snapshot
+const char magic[8] = { 'P', 'L', 'A', 'N', 'E', 'T', 'S', '\0' };
+
+/// The alignment of the columns in bytes
+const std::uint64_t alignment = 64;
+
+/// The columns in the order that they appear in the file
+enum Column {
+	XColumn,
+	YColumn,
+	ZColumn,
+	VXColumn,
+	VYColumn,
+	VZColumn,
+	MassColumn,
+	TypeColumn,
+	LabelOffsetColumn,
+	LabelCharColumn,
+	NumColumns
+};
+
+/**
+ * The header of a snapshot file. The sizes of the columns are stored along
+ * with their offsets so that damaged files can be detected.
+ */
+struct SnapshotHeader {
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t headerSize;
+	std::uint64_t numBodies;
+	std::uint64_t fileSize;
+	std::uint64_t offsets[NumColumns];
+	std::uint64_t sizes[NumColumns];
+};
+
+/// The size of the header, padded to the column alignment
+const std::uint64_t headerSize = (sizeof(SnapshotHeader) + alignment - 1)
+		/ alignment * alignment;
+
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "Binary snapshots are only supported on little-endian processors."
+#endif
+
+} /* anonymous namespace */
+
+BodySnapshot::BodySnapshot(const std::string & fileName) :
+		file(fileName), numBodies(0) {
+
+	// Check the header
+	SnapshotHeader header;
+	if (file.size() < headerSize) {
+		throw "Invalid snapshot file!";
+	}
+	memcpy(&header, file.data(), sizeof(header));
+	if (memcmp(header.magic, magic, sizeof(magic)) != 0
+			|| header.headerSize != headerSize
+			|| header.fileSize != file.size()
+			|| header.numBodies > (std::uint64_t) INT32_MAX) {
+		throw "Invalid snapshot file!";
+	}
+	if (header.version != version) {
+		throw "Unsupported snapshot version!";
+	}
+	numBodies = header.numBodies;
+
+	// Check that the columns have the right sizes and fit in the file
+	for (int i = 0; i < NumColumns; i++) {
+		std::uint64_t expectedSize = numBodies * sizeof(double);
+		if (i == TypeColumn) {
+			expectedSize = numBodies * sizeof(std::int32_t);
+		} else if (i == LabelOffsetColumn) {
+			expectedSize = (numBodies + 1) * sizeof(std::uint64_t);
+		} else if (i == LabelCharColumn) {
+			expectedSize = header.sizes[i];
+		}
+		if (header.sizes[i] != expectedSize
+				|| header.offsets[i] % alignment != 0
+				|| header.offsets[i] < headerSize
+				|| header.offsets[i] > file.size()
+				|| header.sizes[i] > file.size() - header.offsets[i]) {
+			throw "Invalid snapshot file!";
+		}
+	}
+
+	// Point the columns into the mapping
+	const char * data = file.data();
+	xs = (const double *) (data + header.offsets[XColumn]);
+	ys = (const double *) (data + header.offsets[YColumn]);
+	zs = (const double *) (data + header.offsets[ZColumn]);
+	vxs = (const double *) (data + header.offsets[VXColumn]);
+	vys = (const double *) (data + header.offsets[VYColumn]);
+	vzs = (const double *) (data + header.offsets[VZColumn]);
+	ms = (const double *) (data + header.offsets[MassColumn]);
+	types = (const std::int32_t *) (data + header.offsets[TypeColumn]);
+	labelOffsets = (const std::uint64_t *) (data
+			+ header.offsets[LabelOffsetColumn]);
+	labelChars = data + header.offsets[LabelCharColumn];
+
+	// The last label offset is the number of label characters
+	if (labelOffsets[numBodies] != header.sizes[LabelCharColumn]) {
+		throw "Invalid snapshot file!";
+	}
+}
+
+BodySnapshot::~BodySnapshot() {
+
+}
+
+int BodySnapshot::size() const {
+	return numBodies;
+}
+
+std::size_t BodySnapshot::fileSize() const {
+	return file.size();
+}
+
+const double * BodySnapshot::x() const {
+	return xs;
+}
+
+const double * BodySnapshot::y() const {
+	return ys;
+}
+
+const double * BodySnapshot::z() const {
+	return zs;
+}
+
+const double * BodySnapshot::vx() const {
+	return vxs;
+}
+
+const double * BodySnapshot::vy() const {
+	return vys;
+}
+
+const double * BodySnapshot::vz() const {
+	return vzs;
+}
+
+const double * BodySnapshot::m() const {
+	return ms;
+}
+
+CelestialBodyType BodySnapshot::type(int i) const {
+	int type = types[i];
+	if (type < Star || type > DwarfPlanetary) {
+		throw "Invalid body type in snapshot file!";
+	}
+	return (CelestialBodyType) type;
+}
+
+std::string BodySnapshot::label(int i) const {
+	std::uint64_t begin = labelOffsets[i], end = labelOffsets[i + 1];
+	if (begin > end || end > labelOffsets[numBodies]) {
+		throw "Invalid label in snapshot file!";
+	}
+	return std::string(labelChars + begin, end - begin);
+}
+
+CelestialBodyData BodySnapshot::data(int i) const {
+	CelestialBodyData data;
+	data.pos = { xs[i], ys[i], zs[i] };
+	data.vel = { vxs[i], vys[i], vzs[i] };
+	data.mass = ms[i];
+	data.label = label(i);
+	data.type = type(i);
+	return data;
+}
+
+BodySystem BodySnapshot::system() const {
+	BodySystem system;
+	system.resize(numBodies);
+	if (numBodies > 0) {
+		size_t numBytes = numBodies * sizeof(double);
+		memcpy(system.x(), xs, numBytes);
+		memcpy(system.y(), ys, numBytes);
+		memcpy(system.z(), zs, numBytes);
+		memcpy(system.vx(), vxs, numBytes);
+		memcpy(system.vy(), vys, numBytes);
+		memcpy(system.vz(), vzs, numBytes);
+		memcpy(system.m(), ms, numBytes);
+	}
+	for (int i = 0; i < numBodies; i++) {
+		if (labelOffsets[i] > labelOffsets[i + 1]) {
+			throw "Invalid label in snapshot file!";
+		}
+		system.type(i, type(i));
+	}
+	system.labels().assign(numBodies, labelChars, labelOffsets);
+	return system;
+}
+
+void BodySnapshot::write(const std::string & fileName,
+		const BodySystem & system) {
+	BodySnapshotWriter writer(fileName, system.size());
+	writer.add(system);
+	writer.close();
+}
+
+BodySnapshotWriter::BodySnapshotWriter(const std::string & fileName,
+		std::uint64_t _numBodies) :
+		output(fileName.c_str(), std::ios::binary), numBodies(_numBodies),
+		numWritten(0), numLabelChars(0) {
+	static_assert(numColumns == NumColumns, "The columns do not match!");
+	if (!output.is_open()) {
+		throw "Unable to open snapshot file for writing!";
+	}
+	// Lay out the columns. Only the size of the last one, the label
+	// characters, is not known yet.
+	std::uint64_t offset = headerSize;
+	for (int i = 0; i < NumColumns; i++) {
+		std::uint64_t size = numBodies * sizeof(double);
+		if (i == TypeColumn) {
+			size = numBodies * sizeof(std::int32_t);
+		} else if (i == LabelOffsetColumn) {
+			size = (numBodies + 1) * sizeof(std::uint64_t);
+		}
+		offsets[i] = offset;
+		offset = (offset + size + alignment - 1) / alignment * alignment;
+	}
+	// The first label starts at the first character
+	writeAt(offsets[LabelOffsetColumn], &numLabelChars, sizeof(numLabelChars));
+}
+
+BodySnapshotWriter::~BodySnapshotWriter() {
+
+}
+
+void BodySnapshotWriter::writeAt(std::uint64_t position, const void * bytes,
+		std::uint64_t numBytes) {
+	if (numBytes > 0) {
+		output.seekp(position);
+		output.write((const char *) bytes, numBytes);
+	}
+}
+
+void BodySnapshotWriter::add(const BodySystem & batch) {
+	std::uint64_t n = batch.size();
+	if (numWritten + n > numBodies) {
+		throw "Too many bodies for snapshot file!";
+	}
+
+	// Write the numeric columns in place
+	const double * columns[MassColumn + 1] = { batch.x(), batch.y(),
+			batch.z(), batch.vx(), batch.vy(), batch.vz(), batch.m() };
+	for (int i = XColumn; i <= MassColumn; i++) {
+		writeAt(offsets[i] + numWritten * sizeof(double), columns[i],
+				n * sizeof(double));
+	}
+
+	// Gather and write the cold columns
+	std::vector<std::int32_t> typeColumn(n);
+	std::vector<std::uint64_t> labelOffsetColumn(n);
+	std::string labelCharColumn;
+	const LabelTable & labels = batch.labels();
+	for (std::uint64_t i = 0; i < n; i++) {
+		typeColumn[i] = batch.type(i);
+		labelCharColumn.append(labels.data(i), labels.length(i));
+		labelOffsetColumn[i] = numLabelChars + labelCharColumn.size();
+	}
+	writeAt(offsets[TypeColumn] + numWritten * sizeof(std::int32_t),
+			typeColumn.data(), n * sizeof(std::int32_t));
+	writeAt(offsets[LabelOffsetColumn]
+			+ (numWritten + 1) * sizeof(std::uint64_t),
+			labelOffsetColumn.data(), n * sizeof(std::uint64_t));
+	writeAt(offsets[LabelCharColumn] + numLabelChars, labelCharColumn.data(),
+			labelCharColumn.size());
+	numWritten += n;
+	numLabelChars += labelCharColumn.size();
+	if (!output.good()) {
+		throw "Unable to write snapshot file!";
+	}
+}
+
+void BodySnapshotWriter::close() {
+	if (numWritten != numBodies) {
+		throw "Too few bodies for snapshot file!";
+	}
+
+	// Fill the header in now that the size of the labels is known
+	SnapshotHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, magic, sizeof(magic));
+	header.version = BodySnapshot::version;
+	header.headerSize = headerSize;
+	header.numBodies = numBodies;
+	for (int i = 0; i < NumColumns; i++) {
+		header.offsets[i] = offsets[i];
+		header.sizes[i] = numBodies * sizeof(double);
+		if (i == TypeColumn) {
+			header.sizes[i] = numBodies * sizeof(std::int32_t);
+		} else if (i == LabelOffsetColumn) {
+			header.sizes[i] = (numBodies + 1) * sizeof(std::uint64_t);
+		} else if (i == LabelCharColumn) {
+			header.sizes[i] = numLabelChars;
+		}
+	}
+	header.fileSize = offsets[LabelCharColumn] + numLabelChars;
+
+	// Write the header and zero the gaps, which also makes sure the file
+	// reaches the start of the labels even if they are all empty
+	const char padding[alignment] = { };
+	writeAt(0, &header, sizeof(header));
+	writeAt(sizeof(header), padding, headerSize - sizeof(header));
+	for (int i = 0; i + 1 < NumColumns; i++) {
+		std::uint64_t end = offsets[i] + header.sizes[i];
+		writeAt(end, padding, offsets[i + 1] - end);
+	}
+	output.close();
+	if (output.fail()) {
+		throw "Unable to write snapshot file!";
+	}
+}
+
+} /* namespace planets */
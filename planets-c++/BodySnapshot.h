@@ -0,0 +1,217 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef BODYSNAPSHOT_H_
+#define BODYSNAPSHOT_H_
+
+#include <string>
+#include <cstdint>
+#include <fstream>
+#include "BodySystem.h"
+#include "MappedFile.h"
+
+namespace planets {
+
+/**
+ * A BodySnapshot is a read-only view of a system of bodies stored in the
+ * binary snapshot format. Snapshots are written once, for example from a
+ * CSV file, and then load without any parsing on every later run.
+ *
+ * A snapshot file is laid out as follows, with all numbers little-endian:
+ * a 192 byte header with the magic string "PLANETS", the format version,
+ * the number of bodies and the byte offset of every column, followed by
+ * the columns themselves. The columns are x, y, z, v_x, v_y, v_z and m as
+ * doubles, the types as 32-bit integers, the label offsets as 64-bit
+ * integers and finally the characters of all labels back to back. Label i
+ * is the range [offset i, offset i+1) of the characters. Every column
+ * starts on a 64 byte boundary, so it can be used directly by vectorized
+ * kernels.
+ *
+ * The file is mapped into memory and the columns are read in place, so
+ * opening a snapshot costs the same no matter how many bodies it holds.
+ * Pointers returned by a snapshot must not outlive it.
+ */
+class BodySnapshot {
+
+	/// The mapped snapshot file
+	MappedFile file;
+
+	/// The number of bodies
+	int numBodies;
+
+	/// The columns in the mapped file
+	const double * xs, * ys, * zs, * vxs, * vys, * vzs, * ms;
+	const std::int32_t * types;
+	const std::uint64_t * labelOffsets;
+	const char * labelChars;
+
+public:
+
+	/**
+	 * The version of the format written by this class. Files with other
+	 * versions are rejected.
+	 */
+	static const int version = 1;
+
+	/**
+	 * Constructor. It throws an exception if the file can not be opened or
+	 * is not a valid snapshot.
+	 * @param fileName the name of the snapshot file
+	 */
+	BodySnapshot(const std::string & fileName);
+
+	/**
+	 * Destructor
+	 */
+	virtual ~BodySnapshot();
+
+	/**
+	 * This operation returns the number of bodies in the snapshot.
+	 * @return the number of bodies
+	 */
+	int size() const;
+
+	/**
+	 * This operation returns the size of the snapshot file.
+	 * @return the size in bytes
+	 */
+	std::size_t fileSize() const;
+
+	/**
+	 * These operations return the contiguous arrays of positions,
+	 * velocities and masses.
+	 */
+	const double * x() const;
+	const double * y() const;
+	const double * z() const;
+	const double * vx() const;
+	const double * vy() const;
+	const double * vz() const;
+	const double * m() const;
+
+	/**
+	 * This operation returns the type of a body.
+	 * @param i the index of the body
+	 * @return the type
+	 */
+	CelestialBodyType type(int i) const;
+
+	/**
+	 * This operation returns the label of a body.
+	 * @param i the index of the body
+	 * @return the label
+	 */
+	std::string label(int i) const;
+
+	/**
+	 * This operation returns the physical data of a single body.
+	 * @param i the index of the body
+	 * @return the data
+	 */
+	CelestialBodyData data(int i) const;
+
+	/**
+	 * This operation copies the snapshot into a BodySystem.
+	 * @return the system
+	 */
+	BodySystem system() const;
+
+	/**
+	 * This operation writes a system of bodies to a snapshot file.
+	 * @param fileName the name of the snapshot file
+	 * @param system the bodies
+	 */
+	static void write(const std::string & fileName,
+			const BodySystem & system);
+};
+
+/**
+ * A BodySnapshotWriter writes a snapshot file in batches of bodies, so that
+ * catalogs that do not fit in memory can be written. The number of bodies
+ * must be known up front, because it fixes where every column starts. Each
+ * batch is written into its place in every column, and the header is
+ * written last by close(). A file that was not closed is not a valid
+ * snapshot.
+ */
+class BodySnapshotWriter {
+
+	/// The number of columns in the file
+	static const int numColumns = 10;
+
+	/// The snapshot file
+	std::ofstream output;
+
+	/// The number of bodies in the file and the number written so far
+	std::uint64_t numBodies, numWritten;
+
+	/// The number of label characters written so far
+	std::uint64_t numLabelChars;
+
+	/// The byte offsets of the columns in the file
+	std::uint64_t offsets[numColumns];
+
+	/**
+	 * This operation writes bytes at a position in the file.
+	 */
+	void writeAt(std::uint64_t position, const void * bytes,
+			std::uint64_t numBytes);
+
+public:
+
+	/**
+	 * Constructor. It throws an exception if the file can not be opened.
+	 * @param fileName the name of the snapshot file
+	 * @param numBodies the number of bodies that will be written
+	 */
+	BodySnapshotWriter(const std::string & fileName, std::uint64_t numBodies);
+
+	/**
+	 * Destructor
+	 */
+	virtual ~BodySnapshotWriter();
+
+	/**
+	 * This operation writes the next bodies. It throws an exception if
+	 * there are more bodies than the file was opened for.
+	 * @param batch the bodies
+	 */
+	void add(const BodySystem & batch);
+
+	/**
+	 * This operation writes the header and closes the file. It throws an
+	 * exception if fewer bodies were written than the file was opened for.
+	 */
+	void close();
+};
+
+} /* namespace planets */
+
+#endif /* BODYSNAPSHOT_H_ */
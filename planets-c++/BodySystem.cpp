@@ -0,0 +1,339 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include "BodySystem.h"
+#include <algorithm>
+
+namespace planets {
+
+namespace {
+
+/// The order of the arrays in the storage
+enum Column {
+	XColumn,
+	YColumn,
+	ZColumn,
+	VXColumn,
+	VYColumn,
+	VZColumn,
+	MassColumn,
+	NumColumns
+};
+
+} /* anonymous namespace */
+
+BodySystem::BodySystem() :
+		numBodies(0), stride(0) {
+
+}
+
+BodySystem::BodySystem(const std::vector<CelestialBody> & bodies) :
+		numBodies(0), stride(0) {
+	int numNewBodies = bodies.size();
+	size_t numChars = 0;
+	for (const auto & body : bodies) {
+		numChars += body.name().size();
+	}
+	reserve(numNewBodies);
+	labelTable.reserve(numNewBodies, numChars);
+	numBodies = numNewBodies;
+	for (int i = 0; i < numBodies; i++) {
+		const CelestialBody & body = bodies[i];
+		x()[i] = body.pos()[0];
+		y()[i] = body.pos()[1];
+		z()[i] = body.pos()[2];
+		vx()[i] = body.vel()[0];
+		vy()[i] = body.vel()[1];
+		vz()[i] = body.vel()[2];
+		m()[i] = body.mass();
+		labelTable.add(body.name());
+		types.push_back(body.type());
+		addMember(i, 0.0);
+	}
+}
+
+BodySystem::~BodySystem() {
+
+}
+
+int BodySystem::size() const {
+	return numBodies;
+}
+
+int BodySystem::capacity() const {
+	return stride;
+}
+
+void BodySystem::resize(int _numBodies) {
+	if (_numBodies > stride) {
+		reserve(std::max(_numBodies, 2 * stride));
+	}
+	for (int k = 0; k < NumColumns; k++) {
+		double * column = columns.data() + k * stride;
+		std::fill(column + std::min(numBodies, _numBodies),
+				column + _numBodies, 0.0);
+	}
+	for (int i = numBodies - 1; i >= _numBodies; i--) {
+		removeMember(i);
+	}
+	int oldSize = numBodies;
+	numBodies = _numBodies;
+	labelTable.resize(_numBodies);
+	types.resize(_numBodies, Star);
+	typeSlots.resize(_numBodies);
+	for (int i = oldSize; i < _numBodies; i++) {
+		addMember(i, 0.0);
+	}
+}
+
+void BodySystem::reserve(int _numBodies) {
+	if (_numBodies <= stride) {
+		return;
+	}
+	// Keep every array a multiple of eight doubles, one cache line, long
+	int newStride = (_numBodies + 7) / 8 * 8;
+	decltype(columns) newColumns(NumColumns * (size_t) newStride);
+	for (int k = 0; k < NumColumns; k++) {
+		std::copy(columns.data() + k * stride,
+				columns.data() + k * stride + numBodies,
+				newColumns.data() + k * newStride);
+	}
+	columns.swap(newColumns);
+	stride = newStride;
+	types.reserve(_numBodies);
+	typeSlots.reserve(_numBodies);
+}
+
+void BodySystem::add(const CelestialBodyData & data) {
+	if (numBodies == stride) {
+		reserve(std::max(16, 2 * stride));
+	}
+	int i = numBodies++;
+	x()[i] = data.pos[0];
+	y()[i] = data.pos[1];
+	z()[i] = data.pos[2];
+	vx()[i] = data.vel[0];
+	vy()[i] = data.vel[1];
+	vz()[i] = data.vel[2];
+	m()[i] = data.mass;
+	labelTable.add(data.label);
+	types.push_back(data.type);
+	addMember(i, 0.0);
+}
+
+void BodySystem::append(const BodySystem & other) {
+	if (&other == this) {
+		BodySystem copy(other);
+		append(copy);
+		return;
+	}
+	int oldSize = numBodies, numOtherBodies = other.size();
+	if (oldSize + numOtherBodies > stride) {
+		reserve(std::max(oldSize + numOtherBodies, 2 * stride));
+	}
+	for (int k = 0; k < NumColumns; k++) {
+		const double * column = other.columns.data() + k * other.stride;
+		std::copy(column, column + numOtherBodies,
+				columns.data() + k * stride + oldSize);
+	}
+	numBodies += numOtherBodies;
+	labelTable.append(other.labelTable);
+	types.insert(types.end(), other.types.begin(), other.types.end());
+	for (int j = 0; j < numOtherBodies; j++) {
+		addMember(oldSize + j, other.radius(j));
+	}
+}
+
+CelestialBodyData BodySystem::data(int i) const {
+	CelestialBodyData data;
+	data.pos = {x()[i], y()[i], z()[i]};
+	data.vel = {vx()[i], vy()[i], vz()[i]};
+	data.mass = m()[i];
+	data.label = labelTable.get(i);
+	data.type = types[i];
+	return data;
+}
+
+std::vector<CelestialBody> BodySystem::bodies() const {
+	std::vector<CelestialBody> bodies;
+	int numBodies = size();
+	bodies.reserve(numBodies);
+	for (int i = 0; i < numBodies; i++) {
+		bodies.push_back(CelestialBody(data(i)));
+	}
+	return bodies;
+}
+
+double * BodySystem::x() {
+	return columns.data() + XColumn * stride;
+}
+
+double * BodySystem::y() {
+	return columns.data() + YColumn * stride;
+}
+
+double * BodySystem::z() {
+	return columns.data() + ZColumn * stride;
+}
+
+double * BodySystem::vx() {
+	return columns.data() + VXColumn * stride;
+}
+
+double * BodySystem::vy() {
+	return columns.data() + VYColumn * stride;
+}
+
+double * BodySystem::vz() {
+	return columns.data() + VZColumn * stride;
+}
+
+double * BodySystem::m() {
+	return columns.data() + MassColumn * stride;
+}
+
+const double * BodySystem::x() const {
+	return columns.data() + XColumn * stride;
+}
+
+const double * BodySystem::y() const {
+	return columns.data() + YColumn * stride;
+}
+
+const double * BodySystem::z() const {
+	return columns.data() + ZColumn * stride;
+}
+
+const double * BodySystem::vx() const {
+	return columns.data() + VXColumn * stride;
+}
+
+const double * BodySystem::vy() const {
+	return columns.data() + VYColumn * stride;
+}
+
+const double * BodySystem::vz() const {
+	return columns.data() + VZColumn * stride;
+}
+
+const double * BodySystem::m() const {
+	return columns.data() + MassColumn * stride;
+}
+
+std::string BodySystem::label(int i) const {
+	return labelTable.get(i);
+}
+
+void BodySystem::label(int i, const std::string & _label) {
+	labelTable.set(i, _label.data(), _label.size());
+}
+
+LabelTable & BodySystem::labels() {
+	return labelTable;
+}
+
+const LabelTable & BodySystem::labels() const {
+	return labelTable;
+}
+
+CelestialBodyType BodySystem::type(int i) const {
+	return types[i];
+}
+
+void BodySystem::type(int i, const CelestialBodyType & _type) {
+	if (types[i] != _type) {
+		removeMember(i);
+		types[i] = _type;
+		addMember(i, 0.0);
+	}
+}
+
+void BodySystem::addMember(int i, double radius) {
+	CelestialBodyType _type = types[i];
+	if ((int) typeSlots.size() <= i) {
+		typeSlots.resize(i + 1);
+	}
+	typeSlots[i] = typeMembers[_type].size();
+	typeMembers[_type].push_back(i);
+	if (hasRadius(_type)) {
+		typeRadii[_type].push_back(radius);
+	}
+}
+
+void BodySystem::removeMember(int i) {
+	CelestialBodyType _type = types[i];
+	std::vector<int> & members = typeMembers[_type];
+	int slot = typeSlots[i], last = members.back();
+	members[slot] = last;
+	typeSlots[last] = slot;
+	members.pop_back();
+	if (hasRadius(_type)) {
+		typeRadii[_type][slot] = typeRadii[_type].back();
+		typeRadii[_type].pop_back();
+	}
+}
+
+bool BodySystem::hasRadius(const CelestialBodyType & _type) {
+	return _type == Planetary || _type == DwarfPlanetary;
+}
+
+int BodySystem::count(const CelestialBodyType & _type) const {
+	return typeMembers[_type].size();
+}
+
+const int * BodySystem::members(const CelestialBodyType & _type) const {
+	return typeMembers[_type].data();
+}
+
+int BodySystem::slot(int i) const {
+	return typeSlots[i];
+}
+
+double * BodySystem::radii(const CelestialBodyType & _type) {
+	return hasRadius(_type) ? typeRadii[_type].data() : nullptr;
+}
+
+const double * BodySystem::radii(const CelestialBodyType & _type) const {
+	return hasRadius(_type) ? typeRadii[_type].data() : nullptr;
+}
+
+double BodySystem::radius(int i) const {
+	return hasRadius(types[i]) ? typeRadii[types[i]][typeSlots[i]] : 0.0;
+}
+
+void BodySystem::radius(int i, const double & _radius) {
+	if (!hasRadius(types[i])) {
+		throw "This type of body does not have a radius!";
+	}
+	typeRadii[types[i]][typeSlots[i]] = _radius;
+}
+
+} /* namespace planets */
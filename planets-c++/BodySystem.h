@@ -0,0 +1,320 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef BODYSYSTEM_H_
+#define BODYSYSTEM_H_
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <utility>
+#include "CelestialBody.h"
+#include "LabelTable.h"
+
+namespace planets {
+
+/**
+ * A BodySystem stores a system of celestial bodies as a structure of arrays
+ * (SoA) instead of an array of CelestialBody objects. Each property of the
+ * bodies is kept in its own contiguous array, so that the potential kernels,
+ * which only need the positions and masses, stream through exactly the data
+ * that they use. The labels and types are rarely used by the kernels and are
+ * kept in separate "cold" arrays.
+ *
+ * All seven numeric arrays live in a single allocation, one after the other,
+ * and the labels are packed into a LabelTable, so a system of any size is
+ * stored in a handful of allocations. Like a vector, the storage grows
+ * geometrically as bodies are added, and pointers to the arrays are
+ * invalidated when it does.
+ *
+ * Body i is described by the i-th entry of every array. Bodies can be moved
+ * between a BodySystem and a vector of CelestialBodies in either direction.
+ *
+ * Properties that only some types of bodies have, like the planetary radius
+ * of planets and dwarf planets, are not stored for every body. Instead, the
+ * system keeps a list of the members of each CelestialBodyType and a column
+ * for each such property per type, holding one entry per member. Passes over
+ * one type of body, like the volume of all dwarf planets, are then dense
+ * scans of that type's columns instead of virtual calls on every body.
+ * The position of a body in the list of its type is its slot.
+ */
+class BodySystem {
+
+	/**
+	 * An allocator that leaves new doubles uninitialized instead of zeroing
+	 * them, because the storage is always filled right after it grows.
+	 */
+	template<typename T>
+	struct UninitializedAllocator: std::allocator<T> {
+		template<typename U>
+		struct rebind {
+			typedef UninitializedAllocator<U> other;
+		};
+		UninitializedAllocator() = default;
+		template<typename U>
+		UninitializedAllocator(const UninitializedAllocator<U> &) {
+		}
+		template<typename U>
+		void construct(U * p) {
+			::new ((void *) p) U;
+		}
+		template<typename U, typename ... Args>
+		void construct(U * p, Args && ... args) {
+			::new ((void *) p) U(std::forward<Args>(args)...);
+		}
+	};
+
+	/// The positions, velocities and masses of the bodies. Each of the
+	/// seven arrays takes a stride of the storage.
+	std::vector<double, UninitializedAllocator<double>> columns;
+
+	/// The number of bodies
+	int numBodies;
+
+	/// The number of bodies that fit in each array
+	int stride;
+
+	/// The labels of the bodies
+	LabelTable labelTable;
+
+	/// The types of the bodies
+	std::vector<CelestialBodyType> types;
+
+	/// The number of body types
+	static const int numTypes = 3;
+
+	/// The indices of the members of each type, in no particular order
+	std::vector<int> typeMembers[numTypes];
+
+	/// The slot of each body in the list of members of its type
+	std::vector<int> typeSlots;
+
+	/// The planetary radii of the members of each type that has one
+	std::vector<double> typeRadii[numTypes];
+
+	/**
+	 * This operation adds a body to the end of the list of members of its
+	 * type.
+	 * @param i the index of the body
+	 * @param radius the planetary radius of the body, if its type has one
+	 */
+	void addMember(int i, double radius);
+
+	/**
+	 * This operation removes a body from the list of members of its type by
+	 * moving the last member into its slot.
+	 * @param i the index of the body
+	 */
+	void removeMember(int i);
+
+public:
+
+	/**
+	 * Constructor for an empty system
+	 */
+	BodySystem();
+
+	/**
+	 * Constructor
+	 * @param bodies the bodies that should be copied into the system
+	 */
+	BodySystem(const std::vector<CelestialBody> & bodies);
+
+	/**
+	 * Destructor
+	 */
+	virtual ~BodySystem();
+
+	/**
+	 * This operation returns the number of bodies in the system.
+	 * @return the number of bodies
+	 */
+	int size() const;
+
+	/**
+	 * This operation changes the number of bodies in the system. New bodies
+	 * are zeroed.
+	 * @param numBodies the new number of bodies
+	 */
+	void resize(int numBodies);
+
+	/**
+	 * This operation reserves space for a number of bodies.
+	 * @param numBodies the number of bodies
+	 */
+	void reserve(int numBodies);
+
+	/**
+	 * This operation returns the number of bodies that fit in the system
+	 * before the storage has to grow.
+	 * @return the capacity
+	 */
+	int capacity() const;
+
+	/**
+	 * This operation adds a body to the end of the system.
+	 * @param data the physical data of the body
+	 */
+	void add(const CelestialBodyData & data);
+
+	/**
+	 * This operation adds all of the bodies of another system to the end of
+	 * this one.
+	 * @param other the other system
+	 */
+	void append(const BodySystem & other);
+
+	/**
+	 * This operation returns the physical data of a single body.
+	 * @param i the index of the body
+	 * @return the data
+	 */
+	CelestialBodyData data(int i) const;
+
+	/**
+	 * This operation copies the bodies into a vector of CelestialBodies.
+	 * @return the bodies
+	 */
+	std::vector<CelestialBody> bodies() const;
+
+	/**
+	 * These operations return the contiguous arrays of positions,
+	 * velocities and masses.
+	 */
+	double * x();
+	double * y();
+	double * z();
+	double * vx();
+	double * vy();
+	double * vz();
+	double * m();
+	const double * x() const;
+	const double * y() const;
+	const double * z() const;
+	const double * vx() const;
+	const double * vy() const;
+	const double * vz() const;
+	const double * m() const;
+
+	/**
+	 * This operation returns the label of a body.
+	 * @param i the index of the body
+	 * @return the label
+	 */
+	std::string label(int i) const;
+
+	/**
+	 * This operation sets the label of a body.
+	 * @param i the index of the body
+	 * @param _label the new label
+	 */
+	void label(int i, const std::string & _label);
+
+	/**
+	 * These operations return the table of labels, which gives access to
+	 * the labels in place without copying them into strings.
+	 */
+	LabelTable & labels();
+	const LabelTable & labels() const;
+
+	/**
+	 * This operation returns the type of a body.
+	 * @param i the index of the body
+	 * @return the type
+	 */
+	CelestialBodyType type(int i) const;
+
+	/**
+	 * This operation sets the type of a body.
+	 * @param i the index of the body
+	 * @param _type the new type
+	 */
+	void type(int i, const CelestialBodyType & _type);
+
+	/**
+	 * This operation returns whether bodies of a type have a planetary
+	 * radius. Planets and dwarf planets do, stars do not.
+	 * @param _type the type
+	 * @return true if the type has a radius
+	 */
+	static bool hasRadius(const CelestialBodyType & _type);
+
+	/**
+	 * This operation returns the number of bodies of a type.
+	 * @param _type the type
+	 * @return the number of members
+	 */
+	int count(const CelestialBodyType & _type) const;
+
+	/**
+	 * This operation returns the indices of the bodies of a type. Member k
+	 * of the type is body members(_type)[k]. The members are not sorted.
+	 * @param _type the type
+	 * @return the indices, which stay valid until bodies are added,
+	 * removed or change their type
+	 */
+	const int * members(const CelestialBodyType & _type) const;
+
+	/**
+	 * This operation returns the slot of a body in the list of members of
+	 * its type.
+	 * @param i the index of the body
+	 * @return the slot
+	 */
+	int slot(int i) const;
+
+	/**
+	 * These operations return the planetary radii of the members of a type,
+	 * one per member in the order of members(). Types without a radius
+	 * return null.
+	 */
+	double * radii(const CelestialBodyType & _type);
+	const double * radii(const CelestialBodyType & _type) const;
+
+	/**
+	 * This operation returns the planetary radius of a body.
+	 * @param i the index of the body
+	 * @return the radius, or zero if the type of the body has none
+	 */
+	double radius(int i) const;
+
+	/**
+	 * This operation sets the planetary radius of a body. It throws an
+	 * exception if the type of the body has no radius.
+	 * @param i the index of the body
+	 * @param _radius the new radius
+	 */
+	void radius(int i, const double & _radius);
+};
+
+} /* namespace planets */
+
+#endif /* BODYSYSTEM_H_ */
@@ -29,21 +29,82 @@
 
  Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
  -----------------------------------------------------------------------------*/
-#include <iostream>
-#include <stdlib.h>
-#include <fstream>
 #include <string>
-#include <sstream>
 #include <vector>
-#include <stdlib.h>
+#include <cstring>
+#include <charconv>
+#include <algorithm>
+#include <iterator>
 #include "CSVBodyParser.h"
+#include "MappedFile.h"
+#include "Profiler.h"
 
 using namespace std;
 
 namespace planets {
 
-CSVBodyParser::CSVBodyParser() {
-	// TODO Auto-generated constructor stub
+namespace {
+
+/**
+ * This operation parses a number from the start of a field. Like strtod, it
+ * skips leading white space and returns zero if there is no number.
+ */
+template<typename T>
+T parseNumber(const char * field, const char * fieldEnd) {
+	while (field < fieldEnd && (*field == ' ' || *field == '\t')) {
+		field++;
+	}
+	if (field < fieldEnd && *field == '+') {
+		field++;
+	}
+	T value = 0;
+	from_chars(field, fieldEnd, value);
+	return value;
+}
+
+/**
+ * This operation moves a position in the file forward to the start of the
+ * line that contains it, unless it already is at the start of a line.
+ */
+const char * alignToLine(const char * begin, const char * end,
+		const char * position) {
+	if (position <= begin || position >= end || position[-1] == '\n') {
+		return std::min(std::max(position, begin), end);
+	}
+	const char * newline = (const char *) memchr(position, '\n',
+			end - position);
+	return newline ? newline + 1 : end;
+}
+
+/**
+ * These operations add a body to either kind of list of bodies.
+ */
+void addBody(std::vector<CelestialBody> & bodies,
+		const CelestialBodyData & data) {
+	bodies.push_back(CelestialBody(data));
+}
+
+void addBody(BodySystem & bodies, const CelestialBodyData & data) {
+	bodies.add(data);
+}
+
+/**
+ * These operations move the bodies of a chunk to the end of either kind of
+ * list of bodies.
+ */
+void appendBodies(std::vector<CelestialBody> & bodies,
+		std::vector<CelestialBody> & chunk) {
+	std::move(chunk.begin(), chunk.end(), std::back_inserter(bodies));
+}
+
+void appendBodies(BodySystem & bodies, BodySystem & chunk) {
+	bodies.append(chunk);
+}
+
+} /* anonymous namespace */
+
+CSVBodyParser::CSVBodyParser() :
+		numThreads(1), numChunkBytes(1 << 22) {
 
 }
 
@@ -51,63 +112,205 @@ CSVBodyParser::~CSVBodyParser() {
 	// TODO Auto-generated destructor stub
 }
 
-CelestialBody CSVBodyParser::loadBody(
-		const std::vector<std::string> & lineVec) const {
+int CSVBodyParser::threads() const {
+	return numThreads;
+}
+
+void CSVBodyParser::threads(const int & _threads) {
+	pool = ThreadPool::create(_threads);
+	numThreads = pool ? pool->size() : 1;
+}
+
+long CSVBodyParser::chunkSize() const {
+	return numChunkBytes;
+}
+
+void CSVBodyParser::chunkSize(const long & _chunkSize) {
+	numChunkBytes = (_chunkSize > 0) ? _chunkSize : 1;
+}
+
+bool CSVBodyParser::loadBody(const char * line, const char * lineEnd,
+		CelestialBodyData & data) {
+
+	// Skip empty lines, including bare carriage returns, and comments
+	if (line < lineEnd && lineEnd[-1] == '\r') {
+		lineEnd--;
+	}
+	if (line == lineEnd || *line == '#') {
+		return false;
+	}
 
 	// Create a simple map for the enumerated types. Cheap and fast this way.
-	CelestialBodyType types[3] = {Star, Planetary, DwarfPlanetary};
+	const CelestialBodyType types[3] = {Star, Planetary, DwarfPlanetary};
 
-	// Create the body data. For the purposes of this code sample, it is
-	// sufficient to assume there are no errors in the individual lines.
-	CelestialBodyData data;
-	data.pos[0] = strtod(lineVec[0].c_str(), NULL);
-	data.pos[1] = strtod(lineVec[1].c_str(), NULL);
-	data.pos[2] = strtod(lineVec[2].c_str(), NULL);
-	data.vel[0] = strtod(lineVec[3].c_str(), NULL);
-	data.vel[1] = strtod(lineVec[4].c_str(), NULL);
-	data.vel[2] = strtod(lineVec[5].c_str(), NULL);
-	data.mass = strtod(lineVec[6].c_str(), NULL);
-	data.label = lineVec[7];
+	// Find the start and end of each field. For the purposes of this code
+	// sample, it is sufficient to assume there are no errors in the
+	// individual lines. Missing fields are left empty.
+	const int numFields = 9;
+	const char * starts[numFields], * ends[numFields];
+	const char * start = line;
+	int k = 0;
+	for (const char * c = line; c < lineEnd && k < numFields - 1; c++) {
+		if (*c == ',') {
+			starts[k] = start;
+			ends[k++] = c;
+			start = c + 1;
+		}
+	}
+	// The last field found runs to the next comma or the end of the line
+	const char * fieldEnd = start;
+	while (fieldEnd < lineEnd && *fieldEnd != ',') {
+		fieldEnd++;
+	}
+	starts[k] = start;
+	ends[k++] = fieldEnd;
+	for (; k < numFields; k++) {
+		starts[k] = ends[k] = lineEnd;
+	}
+
+	// Convert the fields
+	data.pos[0] = parseNumber<double>(starts[0], ends[0]);
+	data.pos[1] = parseNumber<double>(starts[1], ends[1]);
+	data.pos[2] = parseNumber<double>(starts[2], ends[2]);
+	data.vel[0] = parseNumber<double>(starts[3], ends[3]);
+	data.vel[1] = parseNumber<double>(starts[4], ends[4]);
+	data.vel[2] = parseNumber<double>(starts[5], ends[5]);
+	data.mass = parseNumber<double>(starts[6], ends[6]);
+	data.label.assign(starts[7], ends[7] - starts[7]);
 	// Pull the data type from the map
-	data.type = types[atoi(lineVec[8].c_str())];
+	int type = parseNumber<int>(starts[8], ends[8]);
+	if (type < 0 || type > 2) {
+		throw "Invalid body type in CSV file!";
+	}
+	data.type = types[type];
 
-	// Load and return the body
-	CelestialBody body(move(data));
+	return true;
+}
 
-	return body;
+template<typename Bodies>
+void CSVBodyParser::parseLines(const char * begin, const char * end,
+		Bodies & bodies) {
+
+	// Count the lines to avoid growing the list over and over
+	size_t numLines = 0;
+	for (const char * c = begin; c < end
+			&& (c = (const char *) memchr(c, '\n', end - c)); c++) {
+		numLines++;
+	}
+	bodies.reserve(bodies.size() + numLines + 1);
+
+	// Pull each line and push it into the list. The label of the data is
+	// reused from line to line, so lines do not allocate anything when
+	// the bodies go into a BodySystem.
+	CelestialBodyData data;
+	const char * line = begin;
+	while (line < end) {
+		const char * lineEnd = (const char *) memchr(line, '\n', end - line);
+		lineEnd = lineEnd ? lineEnd : end;
+		if (loadBody(line, lineEnd, data)) {
+			addBody(bodies, data);
+		}
+		line = lineEnd + 1;
+	}
 }
 
-std::vector<CelestialBody> CSVBodyParser::parseBodies(
-		const std::string & inputFile) const {
-	std::vector<CelestialBody> bodies;
-
-	// Note: "data" has already been initialized by the base class.
-	// Load the contents of the file
-	string delimiter = ",", commentChar = "#";
-	string value, line;
-	ifstream fileStream(inputFile);
-	// Pull each line and push it into the list
-	if (fileStream.is_open()) {
-		// Pull each line from the file
-		while (getline(fileStream,line)) {
-			if (!line.empty() && !line.find(commentChar) == 0) {
-			   istringstream ss(line);
-			   vector<string> lineVec;
-				// Split the line and push each element into the line list.
-			   while (getline(ss,value,*delimiter.c_str())) {
-			       lineVec.push_back(value);
-			   }
-			   // Call a separate function to create the body and put it into
-			   // the vector.
-			   bodies.push_back(loadBody(lineVec));
+template<typename Bodies>
+Bodies CSVBodyParser::parseFile(const std::string & inputFile) const {
+	PLANETS_TIMER("CSVBodyParser::parse");
+	Bodies bodies;
+
+	// Map the file. This throws if the file can not be opened.
+	MappedFile file(inputFile);
+	const char * begin = file.data(), * end = begin + file.size();
+	PLANETS_COUNT(BytesRead, file.size());
+
+	// Small files and single threaded parsers don't need chunks
+	long numChunks = (file.size() + numChunkBytes - 1) / numChunkBytes;
+	if (!pool || numChunks < 2) {
+		parseLines(begin, end, bodies);
+		PLANETS_COUNT(BodiesParsed, bodies.size());
+		return bodies;
+	}
+
+	// Parse the chunks. The pool would rethrow whichever error some thread
+	// hit first, so the errors are kept per chunk instead, and the first
+	// error in file order is the one rethrown afterwards.
+	std::vector<Bodies> chunkBodies(numChunks);
+	std::vector<const char *> errors(numChunks, nullptr);
+	pool->parallelFor(0, numChunks, 1, [&](int first, int last, int) {
+		for (int k = first; k < last; k++) {
+			const char * chunkBegin = alignToLine(begin, end,
+					begin + k * numChunkBytes);
+			const char * chunkEnd = alignToLine(begin, end,
+					begin + (k + 1) * numChunkBytes);
+			try {
+				parseLines(chunkBegin, chunkEnd, chunkBodies[k]);
+			} catch (const char * error) {
+				errors[k] = error;
 			}
 		}
-		fileStream.close();
-	} else {
-		throw "Text file stream not open! Check path?";
+	});
+
+	// Join the chunks in order
+	size_t numBodies = 0;
+	for (long k = 0; k < numChunks; k++) {
+		if (errors[k]) {
+			throw errors[k];
+		}
+		numBodies += chunkBodies[k].size();
 	}
+	bodies.reserve(numBodies);
+	for (auto & chunk : chunkBodies) {
+		appendBodies(bodies, chunk);
+		chunk = Bodies();
+	}
+	PLANETS_COUNT(BodiesParsed, bodies.size());
 
 	return bodies;
 }
 
+std::vector<CelestialBody> CSVBodyParser::parseBodies(
+		const std::string & inputFile) const {
+	return parseFile<std::vector<CelestialBody>>(inputFile);
+}
+
+BodySystem CSVBodyParser::parseSystem(const std::string & inputFile) const {
+	return parseFile<BodySystem>(inputFile);
+}
+
+void CSVBodyParser::parseBodies(const std::string & inputFile,
+		int batchSize, const BatchHandler & handler) const {
+
+	// Map the file. This throws if the file can not be opened.
+	PLANETS_TIMER("CSVBodyParser::parse");
+	MappedFile file(inputFile);
+	const char * begin = file.data(), * end = begin + file.size();
+	PLANETS_COUNT(BytesRead, file.size());
+
+	// Pull each line and hand out the bodies whenever a batch is full
+	batchSize = std::max(batchSize, 1);
+	std::vector<CelestialBody> batch;
+	CelestialBodyData data;
+	const char * line = begin;
+	while (line < end) {
+		const char * lineEnd = (const char *) memchr(line, '\n', end - line);
+		lineEnd = lineEnd ? lineEnd : end;
+		if (loadBody(line, lineEnd, data)) {
+			batch.push_back(CelestialBody(data));
+			if ((int) batch.size() == batchSize) {
+				PLANETS_COUNT(BodiesParsed, batch.size());
+				handler(batch);
+				batch.clear();
+				// Drop the part of the file that is done from memory
+				file.discard(lineEnd - begin);
+			}
+		}
+		line = lineEnd + 1;
+	}
+	if (!batch.empty()) {
+		PLANETS_COUNT(BodiesParsed, batch.size());
+		handler(batch);
+	}
+}
+
 } /* namespace planets */
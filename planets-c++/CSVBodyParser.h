@@ -32,7 +32,9 @@
 #ifndef CSVBODYPARSER_H_
 #define CSVBODYPARSER_H_
 
+#include <memory>
 #include "IBodyParser.h"
+#include "ThreadPool.h"
 
 namespace planets {
 
@@ -55,16 +57,56 @@ namespace planets {
  *
  * The "type" attribute was added specifically to demonstrate processing input
  * logic and would be handled differently in an optimized code.
+ *
+ * Lines that are empty or start with "#" are skipped. The file is mapped into
+ * memory and tokenized in place. Numbers are converted straight from the
+ * mapped bytes with std::from_chars, so no temporary strings are created
+ * for each line.
+ *
+ * Large files can be parsed on several threads. The file is split into
+ * chunks of roughly chunkSize() bytes whose boundaries are moved forward to
+ * the start of the next line, so every line belongs to exactly one chunk.
+ * Each thread parses whole chunks into its own list of bodies and the lists
+ * are joined in file order, so the result is the same for any number of
+ * threads.
  */
 class CSVBodyParser: public IBodyParser {
 
 private:
 
+	/// The number of threads used by the parser
+	int numThreads;
+
+	/// The number of bytes in a chunk of the file
+	long numChunkBytes;
+
+	/// The threads used by the parser, or null for a single thread
+	std::shared_ptr<ThreadPool> pool;
+
+	/**
+	 * This is a private factory function for loading the data of a body from
+	 * a single line of the file, which is given as the range [line, lineEnd)
+	 * without the newline.
+	 * @return false if the line is empty or a comment, true otherwise
+	 */
+	static bool loadBody(const char * line, const char * lineEnd,
+			CelestialBodyData & data);
+
+	/**
+	 * This operation parses all of the lines in [begin, end) and appends the
+	 * bodies to a list, which is either a vector of CelestialBodies or a
+	 * BodySystem.
+	 */
+	template<typename Bodies>
+	static void parseLines(const char * begin, const char * end,
+			Bodies & bodies);
+
 	/**
-	 * This is a private factory function for loading CelestialBodies from a
-	 * vector of strings. It returns by value, evoking move semantics/RVO.
+	 * This operation parses a file into a list of bodies, in chunks if there
+	 * are several threads.
 	 */
-	CelestialBody loadBody(const std::vector<std::string> & lineVec) const;
+	template<typename Bodies>
+	Bodies parseFile(const std::string & inputFile) const;
 
 public:
 
@@ -78,9 +120,45 @@ public:
 	 */
 	virtual ~CSVBodyParser();
 
+	/**
+	 * This operation returns the number of threads used by the parser.
+	 * @return the number of threads
+	 */
+	int threads() const;
+
+	/**
+	 * This operation sets the number of threads used by the parser.
+	 * @param _threads the number of threads, or 0 for one per core
+	 */
+	void threads(const int & _threads);
+
+	/**
+	 * This operation returns the number of bytes in a chunk of the file.
+	 * @return the chunk size
+	 */
+	long chunkSize() const;
+
+	/**
+	 * This operation sets the number of bytes in a chunk of the file. Chunks
+	 * should be large enough that their lists of bodies are cheap to join,
+	 * but small enough to balance the load across the threads.
+	 * @param _chunkSize the new chunk size
+	 */
+	void chunkSize(const long & _chunkSize);
+
 	virtual std::vector<CelestialBody> parseBodies(
 			const std::string & inputFile) const;
 
+	virtual BodySystem parseSystem(const std::string & inputFile) const;
+
+	/**
+	 * This operation parses an input file in batches, as described on
+	 * IBodyParser. The file is read front to back on a single thread, so
+	 * memory use is bounded by the batch size no matter how big the file is.
+	 */
+	virtual void parseBodies(const std::string & inputFile, int batchSize,
+			const BatchHandler & handler) const;
+
 };
 
 } /* namespace planets */
@@ -0,0 +1,331 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include "CatalogGenerator.h"
+#include "BodySnapshot.h"
+#include "PotentialSolver.h"
+#include <random>
+#include <vector>
+#include <cstdio>
+#include <memory>
+#include <algorithm>
+#include <math.h>
+
+namespace planets {
+
+namespace {
+
+/**
+ * A Sampler draws the bodies of a catalog one after the other. It holds
+ * the random number generator and anything that is shared by the bodies,
+ * like the centers of the clusters.
+ */
+class Sampler {
+
+	/// The random number generator
+	std::mt19937 rng;
+
+	/// The settings of the catalog
+	CatalogGenerator::Distribution distribution;
+	double scale, totalMass;
+	long numBodies;
+
+	/// The positions and velocities of the clusters
+	std::vector<double> clusterPos, clusterVel;
+
+	/**
+	 * This operation returns a uniform random number in (0,1).
+	 */
+	double uniform() {
+		return (rng() + 0.5) * (1.0 / 4294967296.0);
+	}
+
+	/**
+	 * This operation returns a random number from the standard normal
+	 * distribution, by the Box-Muller method.
+	 */
+	double normal() {
+		double u = uniform(), v = uniform();
+		return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+	}
+
+	/**
+	 * This operation returns a random unit vector.
+	 */
+	void direction(double & x, double & y, double & z) {
+		z = 2.0 * uniform() - 1.0;
+		double phi = 2.0 * M_PI * uniform(), rho = sqrt(1.0 - z * z);
+		x = rho * cos(phi);
+		y = rho * sin(phi);
+	}
+
+	/**
+	 * This operation draws a position and velocity from a Plummer sphere
+	 * with the given mass and scale radius. The outermost tenth of a
+	 * percent of the mass is left out, so that single bodies do not land
+	 * hundreds of radii away.
+	 */
+	void plummer(double sphereMass, double sphereScale,
+			CelestialBodyData & data) {
+		// Pick the radius from the cumulative mass profile
+		double massFraction = 0.999 * uniform();
+		double r = 1.0 / sqrt(pow(massFraction, -2.0 / 3.0) - 1.0);
+		double x, y, z;
+		direction(x, y, z);
+		data.pos = {sphereScale * r * x, sphereScale * r * y,
+				sphereScale * r * z};
+		// Pick the speed as a fraction q of the escape speed by rejection
+		double q, g;
+		do {
+			q = uniform();
+			g = 0.1 * uniform();
+		} while (g > q * q * pow(1.0 - q * q, 3.5));
+		double speed = q * sqrt(2.0) * pow(1.0 + r * r, -0.25)
+				* sqrt(PotentialSolver::G * sphereMass / sphereScale);
+		direction(x, y, z);
+		data.vel = {speed * x, speed * y, speed * z};
+	}
+
+public:
+
+	/**
+	 * Constructor
+	 */
+	Sampler(const CatalogGenerator & generator, long _numBodies) :
+			rng(generator.seed()), distribution(generator.distribution()),
+			scale(generator.scale()), totalMass(generator.totalMass()),
+			numBodies(_numBodies) {
+		// Place the clusters in a sphere and give each a bulk velocity
+		if (distribution == CatalogGenerator::Clustered) {
+			double speed = 0.5 * sqrt(PotentialSolver::G * totalMass / scale);
+			for (int k = 0; k < generator.clusters(); k++) {
+				double x, y, z;
+				do {
+					x = 2.0 * uniform() - 1.0;
+					y = 2.0 * uniform() - 1.0;
+					z = 2.0 * uniform() - 1.0;
+				} while (x * x + y * y + z * z > 1.0);
+				clusterPos.insert(clusterPos.end(),
+						{scale * x, scale * y, scale * z});
+				clusterVel.insert(clusterVel.end(), {speed * normal(),
+						speed * normal(), speed * normal()});
+			}
+		}
+	}
+
+	/**
+	 * This operation draws the next body.
+	 * @param i the index of the body
+	 * @param data the data of the body
+	 */
+	void sample(long i, CelestialBodyData & data) {
+		switch (distribution) {
+		case CatalogGenerator::Uniform:
+			if (i == 0) {
+				data.pos = {0.0, 0.0, 0.0};
+				data.vel = {0.0, 0.0, 0.0};
+				data.label = "central-star";
+				data.type = Star;
+			} else {
+				data.pos = {(double) rng(), (double) rng(), (double) rng()};
+				data.vel = {(double) rng(), (double) rng(), (double) rng()};
+				data.label = "body-" + std::to_string(i);
+				data.type = (rng() % 2) ? DwarfPlanetary : Planetary;
+			}
+			data.mass = rng();
+			break;
+		case CatalogGenerator::Plummer:
+			plummer(totalMass, scale, data);
+			data.mass = totalMass / numBodies;
+			data.label = "star-" + std::to_string(i);
+			data.type = Star;
+			break;
+		case CatalogGenerator::Disk:
+			if (i == 0) {
+				data.pos = {0.0, 0.0, 0.0};
+				data.vel = {0.0, 0.0, 0.0};
+				data.mass = totalMass;
+				data.label = "central-star";
+				data.type = Star;
+			} else {
+				// Equal numbers of bodies at every radius give a surface
+				// density that falls off as 1/r
+				double r = scale * (0.1 + 0.9 * uniform());
+				double phi = 2.0 * M_PI * uniform();
+				double speed = sqrt(PotentialSolver::G * totalMass / r);
+				data.pos = {r * cos(phi), r * sin(phi), 0.01 * r * normal()};
+				data.vel = {-speed * sin(phi) + 0.01 * speed * normal(),
+						speed * cos(phi) + 0.01 * speed * normal(),
+						0.01 * speed * normal()};
+				// Masses from 1e-9 to 1e-6 of the star, uniform in the
+				// logarithm. The largest hundredth, above 10^-6.03 of the
+				// star, are planets.
+				data.mass = totalMass * 1.0e-9 * pow(10.0, 3.0 * uniform());
+				data.label = "body-" + std::to_string(i);
+				data.type = (data.mass > totalMass * pow(10.0, -6.03)) ?
+						Planetary : DwarfPlanetary;
+			}
+			break;
+		case CatalogGenerator::Clustered: {
+			int numClusters = clusterPos.size() / 3;
+			int k = rng() % numClusters;
+			plummer(totalMass / numClusters, 0.05 * scale, data);
+			for (int d = 0; d < 3; d++) {
+				data.pos[d] += clusterPos[3 * k + d];
+				data.vel[d] += clusterVel[3 * k + d];
+			}
+			data.mass = totalMass / numBodies;
+			data.label = "star-" + std::to_string(i);
+			data.type = Star;
+			break;
+		}
+		}
+	}
+};
+
+} /* anonymous namespace */
+
+CatalogGenerator::CatalogGenerator(unsigned int seed,
+		Distribution distribution) :
+		randomSeed(seed), bodyDistribution(distribution),
+		scaleRadius(3.0857e16), mass(1000.0 * 1.989e30), numClusters(16) {
+
+}
+
+CatalogGenerator::~CatalogGenerator() {
+
+}
+
+unsigned int CatalogGenerator::seed() const {
+	return randomSeed;
+}
+
+void CatalogGenerator::seed(const unsigned int & _seed) {
+	randomSeed = _seed;
+}
+
+CatalogGenerator::Distribution CatalogGenerator::distribution() const {
+	return bodyDistribution;
+}
+
+void CatalogGenerator::distribution(const Distribution & _distribution) {
+	bodyDistribution = _distribution;
+}
+
+double CatalogGenerator::scale() const {
+	return scaleRadius;
+}
+
+void CatalogGenerator::scale(const double & _scale) {
+	if (!(_scale > 0.0) || isinf(_scale)) {
+		throw "The scale radius must be positive!";
+	}
+	scaleRadius = _scale;
+}
+
+double CatalogGenerator::totalMass() const {
+	return mass;
+}
+
+void CatalogGenerator::totalMass(const double & _totalMass) {
+	if (!(_totalMass > 0.0) || isinf(_totalMass)) {
+		throw "The total mass must be positive!";
+	}
+	mass = _totalMass;
+}
+
+int CatalogGenerator::clusters() const {
+	return numClusters;
+}
+
+void CatalogGenerator::clusters(const int & _clusters) {
+	numClusters = std::max(_clusters, 1);
+}
+
+BodySystem CatalogGenerator::generate(int numBodies) const {
+	BodySystem system;
+	system.reserve(numBodies);
+	generate(numBodies, std::max(numBodies, 1), [&](const BodySystem & batch) {
+		system.append(batch);
+	});
+	return system;
+}
+
+void CatalogGenerator::generate(long numBodies, int batchSize,
+		const BatchHandler & handler) const {
+	Sampler sampler(*this, numBodies);
+	batchSize = std::max(batchSize, 1);
+	BodySystem batch;
+	batch.reserve(std::min((long) batchSize, numBodies));
+	CelestialBodyData data;
+	for (long i = 0; i < numBodies; i++) {
+		sampler.sample(i, data);
+		batch.add(data);
+		if (batch.size() == batchSize || i == numBodies - 1) {
+			handler(batch);
+			batch.resize(0);
+		}
+	}
+}
+
+void CatalogGenerator::write(const std::string & fileName,
+		long numBodies) const {
+	std::unique_ptr<FILE, int (*)(FILE *)> file(
+			fopen(fileName.c_str(), "w"), fclose);
+	if (!file) {
+		throw "Unable to open file for writing!";
+	}
+	generate(numBodies, 1 << 16, [&](const BodySystem & batch) {
+		const LabelTable & labels = batch.labels();
+		for (int i = 0; i < batch.size(); i++) {
+			fprintf(file.get(),
+					"%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.*s,%d\n",
+					batch.x()[i], batch.y()[i], batch.z()[i], batch.vx()[i],
+					batch.vy()[i], batch.vz()[i], batch.m()[i],
+					(int) labels.length(i), labels.data(i),
+					(int) batch.type(i));
+		}
+	});
+	if (ferror(file.get())) {
+		throw "Unable to write file!";
+	}
+}
+
+void CatalogGenerator::writeSnapshot(const std::string & fileName,
+		long numBodies) const {
+	BodySnapshotWriter writer(fileName, numBodies);
+	generate(numBodies, 1 << 16, [&](const BodySystem & batch) {
+		writer.add(batch);
+	});
+	writer.close();
+}
+
+} /* namespace planets */
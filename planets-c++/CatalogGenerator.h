@@ -0,0 +1,224 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef CATALOGGENERATOR_H_
+#define CATALOGGENERATOR_H_
+
+#include <string>
+#include <functional>
+#include "BodySystem.h"
+
+namespace planets {
+
+/**
+ * The CatalogGenerator makes synthetic catalogs of bodies for tests,
+ * benchmarks and profiling. The same seed and settings always give the same
+ * catalog, on any platform, because the random numbers are drawn from a
+ * Mersenne twister and converted without the implementation defined
+ * distributions of the standard library.
+ *
+ * The bodies are drawn from one of these distributions:
+ * - Uniform: like planetary-system.csv, a star at the origin followed by
+ * planets and dwarf planets whose positions, velocities and masses are raw
+ * draws from the Mersenne twister. It is junk, but cheap.
+ * - Plummer: a Plummer sphere of stars with the given total mass and scale
+ * radius, with velocities drawn from its equilibrium distribution
+ * (Aarseth, Henon and Wielen 1974).
+ * - Disk: a star of the given mass at the origin, with planets and dwarf
+ * planets on nearly circular orbits in a thin disk out to the scale radius.
+ * - Clustered: a number of small Plummer spheres of stars scattered through
+ * a sphere of the scale radius, which gives trees very uneven depths.
+ *
+ * All physical quantities are in SI units, using PotentialSolver::G.
+ *
+ * Catalogs can be generated in batches and written to CSV or snapshot
+ * files without ever holding all of the bodies in memory.
+ */
+class CatalogGenerator {
+
+public:
+
+	/**
+	 * The distributions that bodies can be drawn from
+	 */
+	enum Distribution {
+		Uniform,
+		Plummer,
+		Disk,
+		Clustered
+	};
+
+	/**
+	 * A function that is called with every batch of generated bodies. The
+	 * batch is reused for the next one after the call.
+	 */
+	typedef std::function<void(const BodySystem & batch)> BatchHandler;
+
+private:
+
+	/// The seed of the random number generator
+	unsigned int randomSeed;
+
+	/// The distribution of the bodies
+	Distribution bodyDistribution;
+
+	/// The scale radius in m
+	double scaleRadius;
+
+	/// The total mass in kg, or the mass of the star of a disk
+	double mass;
+
+	/// The number of clusters of the clustered distribution
+	int numClusters;
+
+public:
+
+	/**
+	 * Constructor
+	 * @param seed the seed of the random number generator
+	 * @param distribution the distribution of the bodies
+	 */
+	CatalogGenerator(unsigned int seed = 123456,
+			Distribution distribution = Uniform);
+
+	/**
+	 * Destructor
+	 */
+	virtual ~CatalogGenerator();
+
+	/**
+	 * This operation returns the seed of the random number generator.
+	 * @return the seed
+	 */
+	unsigned int seed() const;
+
+	/**
+	 * This operation sets the seed of the random number generator.
+	 * @param _seed the new seed
+	 */
+	void seed(const unsigned int & _seed);
+
+	/**
+	 * This operation returns the distribution of the bodies.
+	 * @return the distribution
+	 */
+	Distribution distribution() const;
+
+	/**
+	 * This operation sets the distribution of the bodies.
+	 * @param _distribution the new distribution
+	 */
+	void distribution(const Distribution & _distribution);
+
+	/**
+	 * This operation returns the scale radius of the Plummer, disk and
+	 * clustered distributions. It defaults to one parsec.
+	 * @return the radius in m
+	 */
+	double scale() const;
+
+	/**
+	 * This operation sets the scale radius. It throws an exception unless
+	 * the radius is positive and finite, because no other radius gives
+	 * finite positions and velocities.
+	 * @param _scale the new radius in m
+	 */
+	void scale(const double & _scale);
+
+	/**
+	 * This operation returns the total mass of the Plummer and clustered
+	 * distributions, or the mass of the central star of a disk. It defaults
+	 * to one thousand solar masses.
+	 * @return the mass in kg
+	 */
+	double totalMass() const;
+
+	/**
+	 * This operation sets the total mass. It throws an exception unless the
+	 * mass is positive and finite.
+	 * @param _totalMass the new mass in kg
+	 */
+	void totalMass(const double & _totalMass);
+
+	/**
+	 * This operation returns the number of clusters of the clustered
+	 * distribution.
+	 * @return the number of clusters
+	 */
+	int clusters() const;
+
+	/**
+	 * This operation sets the number of clusters.
+	 * @param _clusters the new number of clusters, at least one
+	 */
+	void clusters(const int & _clusters);
+
+	/**
+	 * This operation generates a catalog.
+	 * @param numBodies the number of bodies
+	 * @return the bodies
+	 */
+	BodySystem generate(int numBodies) const;
+
+	/**
+	 * This operation generates a catalog in batches. The batches are the
+	 * same bodies in the same order as generate(numBodies), no matter what
+	 * the batch size is.
+	 * @param numBodies the number of bodies
+	 * @param batchSize the largest number of bodies in a batch
+	 * @param handler the function that is called with every batch
+	 */
+	void generate(long numBodies, int batchSize,
+			const BatchHandler & handler) const;
+
+	/**
+	 * This operation generates a catalog and writes it to a CSV file in the
+	 * format read by CSVBodyParser. The numbers are written with 17
+	 * significant digits, so they read back exactly. It throws an exception
+	 * if the file can not be written.
+	 * @param fileName the name of the file
+	 * @param numBodies the number of bodies
+	 */
+	void write(const std::string & fileName, long numBodies) const;
+
+	/**
+	 * This operation generates a catalog and writes it to a binary snapshot
+	 * file that BodySnapshot and BinaryBodyParser read. It throws an
+	 * exception if the file can not be written.
+	 * @param fileName the name of the file
+	 * @param numBodies the number of bodies
+	 */
+	void writeSnapshot(const std::string & fileName, long numBodies) const;
+};
+
+} /* namespace planets */
+
+#endif /* CATALOGGENERATOR_H_ */
@@ -53,10 +53,10 @@ namespace planets {
  * to change without affecting this class nor preventing smart unit scaling
  * operations at this level as well.
  *
- * This class could be extended in a useful way by delegating the computation
- * of the gravitational potential to a PotentialSolver class. However, for the
- * purposes of this sample, it is sufficient to use a direct n-body
- * computation.
+ * This class computes the potential of a single body with a direct n-body
+ * computation. The potentials of a whole system are better computed in one
+ * call by one of the PotentialSolver classes, which can share work between
+ * the bodies.
  */
 class CelestialBody {
 
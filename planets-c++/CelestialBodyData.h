@@ -32,6 +32,7 @@
 #ifndef CELESTIALBODYDATA_H_
 #define CELESTIALBODYDATA_H_
 
+#include <array>
 #include <memory>
 #include <string>
 
@@ -0,0 +1,468 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include "CellList.h"
+#include <math.h>
+#include <queue>
+#include <algorithm>
+
+namespace planets {
+
+CellList::CellList() :
+		lower({0.0, 0.0, 0.0}), cellWidths({1.0, 1.0, 1.0}), dims({1, 1, 1}),
+		starts(2, 0), minimumWidth(1.0) {
+
+}
+
+CellList::CellList(const BodySystem & system, double minWidth) :
+		CellList() {
+	build(system, minWidth);
+}
+
+CellList::~CellList() {
+
+}
+
+void CellList::build(const BodySystem & system, double minWidth) {
+	if (!(minWidth > 0.0)) {
+		throw "The width of the cells must be positive!";
+	}
+	minimumWidth = minWidth;
+	int numBodies = system.size();
+	const double * pos[3] = { system.x(), system.y(), system.z() };
+
+	// Find the bounding box
+	std::array<double, 3> upper;
+	for (int k = 0; k < 3; k++) {
+		lower[k] = (numBodies > 0) ? pos[k][0] : 0.0;
+		upper[k] = lower[k];
+		for (int i = 1; i < numBodies; i++) {
+			lower[k] = std::min(lower[k], pos[k][i]);
+			upper[k] = std::max(upper[k], pos[k][i]);
+		}
+	}
+
+	// Pick as many cells as fit along each axis, and widen them until the
+	// whole grid is no more than about twice the number of bodies
+	double maxCells = 2.0 * std::max(numBodies, 1) + 26.0;
+	double width = minWidth;
+	double numCells;
+	do {
+		numCells = 1.0;
+		for (int k = 0; k < 3; k++) {
+			double n = floor((upper[k] - lower[k]) / width);
+			dims[k] = (int) std::min(std::max(n, 1.0), 1.0e9);
+			numCells *= dims[k];
+		}
+		width *= 1.0625 * cbrt(std::max(numCells / maxCells, 1.0));
+	} while (numCells > maxCells);
+	for (int k = 0; k < 3; k++) {
+		double extent = upper[k] - lower[k];
+		cellWidths[k] = (extent > 0.0) ? extent / dims[k] : minWidth;
+	}
+
+	// Find the cell of every body and count the bodies in each cell
+	bodyCells.resize(numBodies);
+	starts.assign((size_t) numCells + 1, 0);
+	for (int i = 0; i < numBodies; i++) {
+		int coords[3];
+		locate({pos[0][i], pos[1][i], pos[2][i]}, coords);
+		bodyCells[i] = cell(coords[0], coords[1], coords[2]);
+		starts[bodyCells[i] + 1]++;
+	}
+
+	// Turn the counts into the starts of the cells and scatter the bodies,
+	// which keeps them in their original order within each cell
+	for (size_t c = 1; c < starts.size(); c++) {
+		starts[c] += starts[c - 1];
+	}
+	std::vector<int> next(starts.begin(), starts.end() - 1);
+	sortedIndices.resize(numBodies);
+	sortedX.resize(numBodies);
+	sortedY.resize(numBodies);
+	sortedZ.resize(numBodies);
+	for (int i = 0; i < numBodies; i++) {
+		int k = next[bodyCells[i]]++;
+		sortedIndices[k] = i;
+		sortedX[k] = pos[0][i];
+		sortedY[k] = pos[1][i];
+		sortedZ[k] = pos[2][i];
+	}
+}
+
+int CellList::update(const BodySystem & system) {
+	int numBodies = system.size();
+	if (numBodies != size()) {
+		build(system, minimumWidth);
+		return -1;
+	}
+	const double * pos[3] = { system.x(), system.y(), system.z() };
+
+	// Find the new cells. A body outside of the grid needs a new grid.
+	std::vector<int> newCells(numBodies);
+	std::vector<int> moved;
+	for (int i = 0; i < numBodies; i++) {
+		int coords[3];
+		if (!locate({pos[0][i], pos[1][i], pos[2][i]}, coords)) {
+			build(system, minimumWidth);
+			return -1;
+		}
+		newCells[i] = cell(coords[0], coords[1], coords[2]);
+		if (newCells[i] != bodyCells[i]) {
+			moved.push_back(i);
+		}
+	}
+
+	// If every body stayed in its cell, only the positions change
+	if (moved.empty()) {
+		for (int k = 0; k < numBodies; k++) {
+			int i = sortedIndices[k];
+			sortedX[k] = pos[0][i];
+			sortedY[k] = pos[1][i];
+			sortedZ[k] = pos[2][i];
+		}
+		return 0;
+	}
+
+	// Otherwise adjust the sizes of the cells, copy the bodies that stayed
+	// in the sorted order and add the ones that moved to the ends of their
+	// new cells
+	std::vector<int> newStarts(starts.size(), 0);
+	for (size_t c = 0; c + 1 < starts.size(); c++) {
+		newStarts[c + 1] = starts[c + 1] - starts[c];
+	}
+	for (int i : moved) {
+		newStarts[bodyCells[i] + 1]--;
+		newStarts[newCells[i] + 1]++;
+	}
+	for (size_t c = 1; c < newStarts.size(); c++) {
+		newStarts[c] += newStarts[c - 1];
+	}
+	std::vector<int> next(newStarts.begin(), newStarts.end() - 1);
+	std::vector<int> newIndices(numBodies);
+	for (int k = 0; k < numBodies; k++) {
+		int i = sortedIndices[k];
+		if (newCells[i] == bodyCells[i]) {
+			newIndices[next[newCells[i]]++] = i;
+		}
+	}
+	for (int i : moved) {
+		newIndices[next[newCells[i]]++] = i;
+	}
+	for (int k = 0; k < numBodies; k++) {
+		int i = newIndices[k];
+		sortedX[k] = pos[0][i];
+		sortedY[k] = pos[1][i];
+		sortedZ[k] = pos[2][i];
+	}
+	starts.swap(newStarts);
+	sortedIndices.swap(newIndices);
+	bodyCells.swap(newCells);
+
+	return moved.size();
+}
+
+bool CellList::locate(const std::array<double, 3> & point,
+		int * coords) const {
+	bool inside = true;
+	for (int k = 0; k < 3; k++) {
+		double t = (point[k] - lower[k]) / cellWidths[k];
+		// Allow for round-off at the upper edge, which belongs to the last
+		// cell
+		inside = inside && t >= 0.0 && t <= dims[k] + 1.0e-9;
+		coords[k] = (t > 0.0) ? (int) std::min(t, dims[k] - 1.0) : 0;
+	}
+	return inside;
+}
+
+double CellList::distance2(const std::array<double, 3> & point, int ix,
+		int iy, int iz) const {
+	int coords[3] = { ix, iy, iz };
+	double d2 = 0.0;
+	for (int k = 0; k < 3; k++) {
+		double cellLower = lower[k] + coords[k] * cellWidths[k];
+		double d = std::max(std::max(cellLower - point[k], 0.0),
+				point[k] - (cellLower + cellWidths[k]));
+		d2 += d * d;
+	}
+	return d2;
+}
+
+int CellList::size() const {
+	return sortedIndices.size();
+}
+
+int CellList::cellCount() const {
+	return starts.size() - 1;
+}
+
+const std::array<int, 3> & CellList::dimensions() const {
+	return dims;
+}
+
+const std::array<double, 3> & CellList::origin() const {
+	return lower;
+}
+
+const std::array<double, 3> & CellList::widths() const {
+	return cellWidths;
+}
+
+int CellList::cell(int ix, int iy, int iz) const {
+	return (iz * dims[1] + iy) * dims[0] + ix;
+}
+
+int CellList::cellOf(int i) const {
+	return bodyCells[i];
+}
+
+int CellList::begin(int cell) const {
+	return starts[cell];
+}
+
+int CellList::end(int cell) const {
+	return starts[cell + 1];
+}
+
+const int * CellList::indices() const {
+	return sortedIndices.data();
+}
+
+const double * CellList::x() const {
+	return sortedX.data();
+}
+
+const double * CellList::y() const {
+	return sortedY.data();
+}
+
+const double * CellList::z() const {
+	return sortedZ.data();
+}
+
+int CellList::neighbors(int cell, int * neighborCells) const {
+	int ix = cell % dims[0], iy = (cell / dims[0]) % dims[1],
+			iz = cell / (dims[0] * dims[1]);
+	int numNeighbors = 0;
+	for (int jz = std::max(iz - 1, 0); jz <= std::min(iz + 1, dims[2] - 1);
+			jz++) {
+		for (int jy = std::max(iy - 1, 0);
+				jy <= std::min(iy + 1, dims[1] - 1); jy++) {
+			for (int jx = std::max(ix - 1, 0);
+					jx <= std::min(ix + 1, dims[0] - 1); jx++) {
+				neighborCells[numNeighbors++] = this->cell(jx, jy, jz);
+			}
+		}
+	}
+	return numNeighbors;
+}
+
+void CellList::range(const std::array<double, 3> & point, double radius,
+		std::vector<int> & found) const {
+	found.clear();
+	if (!(radius >= 0.0) || size() == 0) {
+		return;
+	}
+
+	// Find the block of cells that overlaps the bounding box of the sphere
+	int first[3], last[3];
+	for (int k = 0; k < 3; k++) {
+		double tFirst = (point[k] - radius - lower[k]) / cellWidths[k];
+		double tLast = (point[k] + radius - lower[k]) / cellWidths[k];
+		if (tLast < 0.0 || tFirst > dims[k] + 1.0e-9) {
+			return;
+		}
+		first[k] = (tFirst > 0.0) ? (int) std::min(tFirst, dims[k] - 1.0) : 0;
+		last[k] = (tLast > 0.0) ? (int) std::min(tLast, dims[k] - 1.0) : 0;
+	}
+
+	// Check the bodies of the cells that touch the sphere
+	double radius2 = radius * radius;
+	for (int iz = first[2]; iz <= last[2]; iz++) {
+		for (int iy = first[1]; iy <= last[1]; iy++) {
+			for (int ix = first[0]; ix <= last[0]; ix++) {
+				if (distance2(point, ix, iy, iz) > radius2) {
+					continue;
+				}
+				int c = cell(ix, iy, iz);
+				for (int b = starts[c]; b < starts[c + 1]; b++) {
+					double dx = sortedX[b] - point[0];
+					double dy = sortedY[b] - point[1];
+					double dz = sortedZ[b] - point[2];
+					if (dx * dx + dy * dy + dz * dz <= radius2) {
+						found.push_back(sortedIndices[b]);
+					}
+				}
+			}
+		}
+	}
+}
+
+void CellList::nearest(const std::array<double, 3> & point, int k,
+		std::vector<int> & found, std::vector<double> & distances,
+		int exclude) const {
+	found.clear();
+	distances.clear();
+	if (k <= 0) {
+		return;
+	}
+
+	// The k best bodies so far, as (squared distance, index), worst on top
+	std::priority_queue<std::pair<double, int>> best;
+	auto visit = [&](int ix, int iy, int iz) {
+		if ((int) best.size() == k
+				&& distance2(point, ix, iy, iz) > best.top().first) {
+			return;
+		}
+		int c = cell(ix, iy, iz);
+		for (int b = starts[c]; b < starts[c + 1]; b++) {
+			if (sortedIndices[b] == exclude) {
+				continue;
+			}
+			double dx = sortedX[b] - point[0];
+			double dy = sortedY[b] - point[1];
+			double dz = sortedZ[b] - point[2];
+			std::pair<double, int> candidate(dx * dx + dy * dy + dz * dz,
+					sortedIndices[b]);
+			if ((int) best.size() < k) {
+				best.push(candidate);
+			} else if (candidate < best.top()) {
+				best.pop();
+				best.push(candidate);
+			}
+		}
+	};
+
+	// Search rings of cells around the cell of the point. The cells of
+	// ring r are at least r - 1 cell widths away, so the search can stop
+	// once that is farther than the k-th best body.
+	int home[3];
+	locate(point, home);
+	double minWidth = std::min(std::min(cellWidths[0], cellWidths[1]),
+			cellWidths[2]);
+	int maxRing = std::max(std::max(dims[0], dims[1]), dims[2]);
+	for (int ring = 0; ring <= maxRing; ring++) {
+		double bound = (ring - 1) * minWidth;
+		if ((int) best.size() == k && ring > 1
+				&& bound * bound > best.top().first) {
+			break;
+		}
+		for (int iz = std::max(home[2] - ring, 0);
+				iz <= std::min(home[2] + ring, dims[2] - 1); iz++) {
+			for (int iy = std::max(home[1] - ring, 0);
+					iy <= std::min(home[1] + ring, dims[1] - 1); iy++) {
+				if (abs(iz - home[2]) == ring || abs(iy - home[1]) == ring) {
+					// A face of the ring, where every cell of the row is on it
+					for (int ix = std::max(home[0] - ring, 0);
+							ix <= std::min(home[0] + ring, dims[0] - 1);
+							ix++) {
+						visit(ix, iy, iz);
+					}
+				} else {
+					// Inside of the ring, where only the ends of the row are
+					if (home[0] - ring >= 0) {
+						visit(home[0] - ring, iy, iz);
+					}
+					if (ring > 0 && home[0] + ring < dims[0]) {
+						visit(home[0] + ring, iy, iz);
+					}
+				}
+			}
+		}
+	}
+
+	// Hand out the bodies nearest first
+	found.resize(best.size());
+	distances.resize(best.size());
+	for (int n = best.size() - 1; n >= 0; n--) {
+		found[n] = best.top().second;
+		distances[n] = sqrt(best.top().first);
+		best.pop();
+	}
+}
+
+int CellList::nearest(const std::array<double, 3> & point,
+		int exclude) const {
+	std::vector<int> found;
+	std::vector<double> distances;
+	nearest(point, 1, found, distances, exclude);
+	return found.empty() ? -1 : found[0];
+}
+
+void CellList::closePairs(double distance,
+		std::vector<std::pair<int, int>> & pairs) const {
+	pairs.clear();
+	if (!(distance > 0.0)) {
+		return;
+	}
+
+	// Pairs can be this many cells apart along each axis
+	int reach[3];
+	for (int k = 0; k < 3; k++) {
+		reach[k] = (int) std::min(ceil(distance / cellWidths[k]),
+				(double) dims[k]);
+	}
+
+	// Visit every pair of cells once, from the cell with the lower index
+	double distance2 = distance * distance;
+	for (int c = 0; c < cellCount(); c++) {
+		int ix = c % dims[0], iy = (c / dims[0]) % dims[1],
+				iz = c / (dims[0] * dims[1]);
+		for (int jz = iz; jz <= std::min(iz + reach[2], dims[2] - 1); jz++) {
+			for (int jy = std::max(iy - reach[1], 0);
+					jy <= std::min(iy + reach[1], dims[1] - 1); jy++) {
+				for (int jx = std::max(ix - reach[0], 0);
+						jx <= std::min(ix + reach[0], dims[0] - 1); jx++) {
+					int n = cell(jx, jy, jz);
+					if (n < c) {
+						continue;
+					}
+					for (int a = starts[c]; a < starts[c + 1]; a++) {
+						for (int b = (n == c) ? a + 1 : starts[n];
+								b < starts[n + 1]; b++) {
+							double dx = sortedX[a] - sortedX[b];
+							double dy = sortedY[a] - sortedY[b];
+							double dz = sortedZ[a] - sortedZ[b];
+							if (dx * dx + dy * dy + dz * dz < distance2) {
+								int i = sortedIndices[a], j = sortedIndices[b];
+								pairs.push_back(std::make_pair(std::min(i, j),
+										std::max(i, j)));
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+	std::sort(pairs.begin(), pairs.end());
+}
+
+} /* namespace planets */
@@ -0,0 +1,267 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef CELLLIST_H_
+#define CELLLIST_H_
+
+#include <array>
+#include <vector>
+#include <utility>
+#include "BodySystem.h"
+
+namespace planets {
+
+/**
+ * A CellList divides the bounding box of a system into a uniform grid of
+ * cells that are at least a minimum width wide along every axis, and sorts
+ * the bodies by cell. Every pair of bodies closer than the minimum width is
+ * then in the same or in neighboring cells, so short-range interactions only
+ * need to look at 27 cells instead of the whole system.
+ *
+ * The list is built in O(N) with a counting sort. The bodies of cell c are
+ * entries [begin(c), end(c)) of the sorted order, and their positions are
+ * kept in the same order so that the loops over a cell are contiguous.
+ *
+ * The number of cells is limited to about twice the number of bodies. When
+ * the bodies are spread out so far that the minimum width would need more
+ * cells, the cells are made wider instead.
+ *
+ * Besides the neighboring cells of the short-range solvers, the list
+ * answers range, nearest neighbor and close pair queries by visiting only
+ * the cells that can hold an answer. When the bodies move, update() keeps
+ * the grid and only moves the bodies that changed cells, as long as all of
+ * them are still inside of the grid.
+ */
+class CellList {
+
+	/// The lower corner of the grid
+	std::array<double, 3> lower;
+
+	/// The width of the cells along each axis
+	std::array<double, 3> cellWidths;
+
+	/// The number of cells along each axis
+	std::array<int, 3> dims;
+
+	/// The first entry of each cell in the sorted order, plus the end
+	std::vector<int> starts;
+
+	/// The indices of the bodies in the sorted order
+	std::vector<int> sortedIndices;
+
+	/// The cell of each body
+	std::vector<int> bodyCells;
+
+	/// The positions of the bodies in the sorted order
+	std::vector<double> sortedX, sortedY, sortedZ;
+
+	/// The minimum width of the cells that the list was built with
+	double minimumWidth;
+
+	/**
+	 * This operation finds the coordinates of the cell that holds a point.
+	 * @param point the point
+	 * @param coords the coordinates of the cell, clamped to the grid
+	 * @return true if the point is inside of the grid
+	 */
+	bool locate(const std::array<double, 3> & point, int * coords) const;
+
+	/**
+	 * This operation returns the squared distance from a point to the
+	 * nearest point of a cell.
+	 */
+	double distance2(const std::array<double, 3> & point, int ix, int iy,
+			int iz) const;
+
+public:
+
+	/**
+	 * Constructor for an empty list
+	 */
+	CellList();
+
+	/**
+	 * Constructor
+	 * @param system the bodies
+	 * @param minWidth the minimum width of the cells
+	 */
+	CellList(const BodySystem & system, double minWidth);
+
+	/**
+	 * Destructor
+	 */
+	virtual ~CellList();
+
+	/**
+	 * This operation sorts the bodies of a system into cells. It throws an
+	 * exception if the minimum width is not positive.
+	 * @param system the bodies
+	 * @param minWidth the minimum width of the cells
+	 */
+	void build(const BodySystem & system, double minWidth);
+
+	/**
+	 * This operation updates the list after the bodies of the system moved.
+	 * The grid is kept and the bodies that are still in their cells keep
+	 * their place in the sorted order. If the number of bodies changed or a
+	 * body left the grid, the list is built again from scratch.
+	 * @param system the bodies, which must be the system the list was built
+	 * from, in the same order
+	 * @return the number of bodies that changed cells, or -1 if the list
+	 * was built again
+	 */
+	int update(const BodySystem & system);
+
+	/**
+	 * This operation returns the number of bodies in the list.
+	 * @return the number of bodies
+	 */
+	int size() const;
+
+	/**
+	 * This operation returns the number of cells.
+	 * @return the number of cells
+	 */
+	int cellCount() const;
+
+	/**
+	 * This operation returns the number of cells along each axis.
+	 * @return the dimensions of the grid
+	 */
+	const std::array<int, 3> & dimensions() const;
+
+	/**
+	 * This operation returns the lower corner of the grid.
+	 * @return the corner
+	 */
+	const std::array<double, 3> & origin() const;
+
+	/**
+	 * This operation returns the width of the cells along each axis.
+	 * @return the widths
+	 */
+	const std::array<double, 3> & widths() const;
+
+	/**
+	 * This operation returns the index of a cell from its coordinates on
+	 * the grid.
+	 * @param ix the x coordinate of the cell
+	 * @param iy the y coordinate of the cell
+	 * @param iz the z coordinate of the cell
+	 * @return the index of the cell
+	 */
+	int cell(int ix, int iy, int iz) const;
+
+	/**
+	 * This operation returns the cell of a body.
+	 * @param i the index of the body in the system
+	 * @return the index of the cell
+	 */
+	int cellOf(int i) const;
+
+	/**
+	 * These operations return the range of a cell in the sorted order.
+	 * @param cell the index of the cell
+	 */
+	int begin(int cell) const;
+	int end(int cell) const;
+
+	/**
+	 * This operation returns the indices of the bodies in the sorted order.
+	 * @return the indices, one per body
+	 */
+	const int * indices() const;
+
+	/**
+	 * These operations return the positions of the bodies in the sorted
+	 * order.
+	 */
+	const double * x() const;
+	const double * y() const;
+	const double * z() const;
+
+	/**
+	 * This operation finds a cell and its neighbors, which are the cells
+	 * that share a face, edge or corner with it.
+	 * @param cell the index of the cell
+	 * @param neighborCells an array of at least 27 entries that is filled
+	 * with the indices of the cells, including the cell itself
+	 * @return the number of cells found
+	 */
+	int neighbors(int cell, int * neighborCells) const;
+
+	/**
+	 * This operation finds the bodies within a distance of a point.
+	 * @param point the point
+	 * @param radius the distance
+	 * @param found the indices of the bodies with |r - point| <= radius, in
+	 * no particular order
+	 */
+	void range(const std::array<double, 3> & point, double radius,
+			std::vector<int> & found) const;
+
+	/**
+	 * This operation finds the k bodies nearest to a point. Ties are broken
+	 * by the index of the body.
+	 * @param point the point
+	 * @param k the number of bodies to find
+	 * @param found the indices of the bodies, nearest first. There are
+	 * fewer than k if the list does not hold enough bodies.
+	 * @param distances the distances of the bodies from the point
+	 * @param exclude a body to skip, usually the one at the point, or -1
+	 */
+	void nearest(const std::array<double, 3> & point, int k,
+			std::vector<int> & found, std::vector<double> & distances,
+			int exclude = -1) const;
+
+	/**
+	 * This operation finds the body nearest to a point.
+	 * @param point the point
+	 * @param exclude a body to skip, usually the one at the point, or -1
+	 * @return the index of the body, or -1 if there is none
+	 */
+	int nearest(const std::array<double, 3> & point, int exclude = -1) const;
+
+	/**
+	 * This operation finds all pairs of bodies that are closer than a
+	 * distance, such as close approaches. The distance may be larger than
+	 * the cells, which only makes the search visit more of them.
+	 * @param distance the distance
+	 * @param pairs the pairs (i, j) with i < j and |r_i - r_j| < distance,
+	 * sorted by i and then j
+	 */
+	void closePairs(double distance,
+			std::vector<std::pair<int, int>> & pairs) const;
+};
+
+} /* namespace planets */
+
+#endif /* CELLLIST_H_ */
@@ -0,0 +1,245 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include "DirectSolver.h"
+#include "Profiler.h"
+#include <math.h>
+#include <algorithm>
+
+namespace planets {
+
+DirectSolver::DirectSolver(bool symmetric) :
+		symmetricMode(symmetric) {
+
+}
+
+DirectSolver::~DirectSolver() {
+
+}
+
+bool DirectSolver::symmetric() const {
+	return symmetricMode;
+}
+
+void DirectSolver::symmetric(const bool & _symmetric) {
+	symmetricMode = _symmetric;
+}
+
+void DirectSolver::sumSymmetric(const BodySystem & system,
+		double * sums) const {
+	int numBodies = system.size();
+	const double * x = system.x();
+	const double * y = system.y();
+	const double * z = system.z();
+	const double * m = system.m();
+	int block = blockSize();
+	int numBlocks = (numBodies + block - 1) / block;
+
+	// Add the interactions between blocks I and J into both blocks. The
+	// pairs inside of a block are handled when I == J.
+	auto tile = [&](int I, int J) {
+		int iEnd = std::min((I + 1) * block, numBodies);
+		int jEnd = std::min((J + 1) * block, numBodies);
+		for (int i = I * block; i < iEnd; i++) {
+			double pot = 0.0, mi = m[i];
+			for (int j = (I == J) ? i + 1 : J * block; j < jEnd; j++) {
+				double dx = x[i] - x[j];
+				double dy = y[i] - y[j];
+				double dz = z[i] - z[j];
+				double inv = 1.0 / sqrt(dx * dx + dy * dy + dz * dz);
+				pot += m[j] * inv;
+				sums[j] += mi * inv;
+			}
+			sums[i] += pot;
+		}
+	};
+
+	// The blocks on the diagonal are independent of each other
+	parallelFor(numBlocks, 1, [&](int begin, int end, int) {
+		for (int I = begin; I < end; I++) {
+			tile(I, I);
+		}
+	});
+
+	// Schedule the other pairs with the circle method. One block stays fixed
+	// and the rest rotate, so every pair meets in exactly one round and no
+	// block appears twice in a round. An odd number of blocks gets a dummy
+	// block that sits out.
+	int slots = numBlocks + numBlocks % 2;
+	for (int round = 0; round < slots - 1; round++) {
+		parallelFor(slots / 2, 1, [&](int begin, int end, int) {
+			for (int k = begin; k < end; k++) {
+				int I = (k == 0) ? slots - 1 : (round + k) % (slots - 1);
+				int J = (round - k + slots - 1) % (slots - 1);
+				if (I < numBlocks && J < numBlocks) {
+					tile(std::min(I, J), std::max(I, J));
+				}
+			}
+		});
+	}
+}
+
+std::vector<double> DirectSolver::getPotentials(
+		const BodySystem & system) const {
+	PLANETS_TIMER("DirectSolver::getPotentials");
+	int numBodies = system.size();
+	std::vector<double> potentials(numBodies);
+
+	const double * x = system.x();
+	const double * y = system.y();
+	const double * z = system.z();
+	const double * m = system.m();
+
+	if (symmetricMode) {
+		std::vector<double> sums(numBodies, 0.0);
+		PLANETS_COUNT(Interactions, (long) numBodies * (numBodies - 1) / 2);
+		sumSymmetric(system, sums.data());
+		// Scale by G and M
+		for (int i = 0; i < numBodies; i++) {
+			potentials[i] = -G * m[i] * sums[i];
+		}
+		return potentials;
+	}
+
+	// Compute the base potential for G = 1 and M = 1 using direct summation
+	// for each block of targets.
+	PLANETS_COUNT(Interactions, (long) numBodies * (numBodies - 1));
+	parallelFor(numBodies, blockSize(), [&](int begin, int end, int) {
+		double dx = 0.0, dy = 0.0, dz = 0.0;
+		for (int i = begin; i < end; i++) {
+			double pot = 0.0;
+			for (int j = 0; j < numBodies; j++) {
+				if (j != i) {
+					dx = x[i] - x[j];
+					dy = y[i] - y[j];
+					dz = z[i] - z[j];
+					pot += m[j] / sqrt(dx * dx + dy * dy + dz * dz);
+				}
+			}
+			// Scale by G and M
+			potentials[i] = -G * m[i] * pot;
+		}
+	});
+
+	return potentials;
+}
+
+void DirectSolver::getAccelerations(const BodySystem & system, double * ax,
+		double * ay, double * az) const {
+	std::vector<int> targets(system.size());
+	for (int i = 0; i < system.size(); i++) {
+		targets[i] = i;
+	}
+	getAccelerations(system, targets, ax, ay, az);
+}
+
+void DirectSolver::getAccelerations(const BodySystem & system,
+		const std::vector<int> & targets, double * ax, double * ay,
+		double * az) const {
+	PLANETS_TIMER("DirectSolver::getAccelerations");
+	int numBodies = system.size();
+	PLANETS_COUNT(Interactions, (long) targets.size() * (numBodies - 1));
+	const double * x = system.x();
+	const double * y = system.y();
+	const double * z = system.z();
+	const double * m = system.m();
+
+	parallelFor(targets.size(), blockSize(), [&](int begin, int end, int) {
+		for (int k = begin; k < end; k++) {
+			int i = targets[k];
+			double accX = 0.0, accY = 0.0, accZ = 0.0;
+			for (int j = 0; j < numBodies; j++) {
+				if (j != i) {
+					double dx = x[j] - x[i];
+					double dy = y[j] - y[i];
+					double dz = z[j] - z[i];
+					double inv = 1.0 / sqrt(dx * dx + dy * dy + dz * dz);
+					double mInv3 = m[j] * inv * inv * inv;
+					accX += mInv3 * dx;
+					accY += mInv3 * dy;
+					accZ += mInv3 * dz;
+				}
+			}
+			ax[k] = G * accX;
+			ay[k] = G * accY;
+			az[k] = G * accZ;
+		}
+	});
+}
+
+void DirectSolver::getAccelerationsAndJerks(const BodySystem & system,
+		double * ax, double * ay, double * az, double * jx, double * jy,
+		double * jz) const {
+	PLANETS_TIMER("DirectSolver::getAccelerationsAndJerks");
+	int numBodies = system.size();
+	PLANETS_COUNT(Interactions, (long) numBodies * (numBodies - 1));
+	const double * x = system.x();
+	const double * y = system.y();
+	const double * z = system.z();
+	const double * vx = system.vx();
+	const double * vy = system.vy();
+	const double * vz = system.vz();
+	const double * m = system.m();
+
+	parallelFor(numBodies, blockSize(), [&](int begin, int end, int) {
+		for (int i = begin; i < end; i++) {
+			double accX = 0.0, accY = 0.0, accZ = 0.0;
+			double jerkX = 0.0, jerkY = 0.0, jerkZ = 0.0;
+			for (int j = 0; j < numBodies; j++) {
+				if (j != i) {
+					double dx = x[j] - x[i];
+					double dy = y[j] - y[i];
+					double dz = z[j] - z[i];
+					double dvx = vx[j] - vx[i];
+					double dvy = vy[j] - vy[i];
+					double dvz = vz[j] - vz[i];
+					double inv2 = 1.0 / (dx * dx + dy * dy + dz * dz);
+					double mInv3 = m[j] * inv2 * sqrt(inv2);
+					double rv = 3.0 * (dx * dvx + dy * dvy + dz * dvz) * inv2;
+					accX += mInv3 * dx;
+					accY += mInv3 * dy;
+					accZ += mInv3 * dz;
+					jerkX += mInv3 * (dvx - rv * dx);
+					jerkY += mInv3 * (dvy - rv * dy);
+					jerkZ += mInv3 * (dvz - rv * dz);
+				}
+			}
+			ax[i] = G * accX;
+			ay[i] = G * accY;
+			az[i] = G * accZ;
+			jx[i] = G * jerkX;
+			jy[i] = G * jerkY;
+			jz[i] = G * jerkZ;
+		}
+	});
+}
+
+} /* namespace planets */
@@ -0,0 +1,124 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef DIRECTSOLVER_H_
+#define DIRECTSOLVER_H_
+
+#include "PotentialSolver.h"
+
+namespace planets {
+
+/**
+ * The DirectSolver computes the potentials by direct summation over every
+ * pair of bodies. It is O(N^2), but exact to round-off, so it is the
+ * reference for the approximate solvers.
+ *
+ * In symmetric mode, each unordered pair (i, j) is visited only once and
+ * 1/r_ij is added into both bodies, which halves the number of
+ * interactions. The bodies are split into blocks and the pairs of blocks
+ * are scheduled in rounds, like a round-robin tournament, so that no two
+ * threads ever write to the same block at the same time. The order of the
+ * rounds is fixed, so the results do not depend on the number of threads,
+ * but they differ from the non-symmetric mode by round-off.
+ *
+ * The DirectSolver also computes accelerations and their time derivatives,
+ * the jerks, which are needed by higher order integrators such as
+ * HermiteIntegrator. These are always computed in non-symmetric mode.
+ */
+class DirectSolver: public PotentialSolver {
+
+	/// True if each pair should only be visited once
+	bool symmetricMode;
+
+	/**
+	 * This operation computes the unscaled potential sums in symmetric
+	 * mode.
+	 */
+	void sumSymmetric(const BodySystem & system, double * sums) const;
+
+public:
+
+	/**
+	 * Constructor
+	 * @param symmetric true if each pair should only be visited once
+	 */
+	DirectSolver(bool symmetric = false);
+
+	/**
+	 * Destructor
+	 */
+	virtual ~DirectSolver();
+
+	/**
+	 * This operation returns true if the solver is in symmetric mode.
+	 * @return the mode
+	 */
+	bool symmetric() const;
+
+	/**
+	 * This operation turns symmetric mode on or off.
+	 * @param _symmetric true if each pair should only be visited once
+	 */
+	void symmetric(const bool & _symmetric);
+
+	using PotentialSolver::getPotentials;
+
+	virtual std::vector<double> getPotentials(
+			const BodySystem & system) const;
+
+	virtual void getAccelerations(const BodySystem & system, double * ax,
+			double * ay, double * az) const;
+
+	virtual void getAccelerations(const BodySystem & system,
+			const std::vector<int> & targets, double * ax, double * ay,
+			double * az) const;
+
+	/**
+	 * This operation computes the accelerations, as getAccelerations() does,
+	 * and the jerks, j_i = G sum_j m_j (v_ij/r_ij^3 - 3 (r_ij . v_ij)
+	 * r_ij/r_ij^5), where r_ij and v_ij are the position and velocity of
+	 * body j relative to body i.
+	 * @param system the bodies that makeup the system
+	 * @param ax the x components of the accelerations, one per body
+	 * @param ay the y components of the accelerations, one per body
+	 * @param az the z components of the accelerations, one per body
+	 * @param jx the x components of the jerks, one per body
+	 * @param jy the y components of the jerks, one per body
+	 * @param jz the z components of the jerks, one per body
+	 */
+	void getAccelerationsAndJerks(const BodySystem & system, double * ax,
+			double * ay, double * az, double * jx, double * jy,
+			double * jz) const;
+};
+
+} /* namespace planets */
+
+#endif /* DIRECTSOLVER_H_ */
@@ -43,9 +43,12 @@ DwarfPlanet::~DwarfPlanet() {
 	// TODO Auto-generated destructor stub
 }
 
-double DwarfPlanet::volume() {
-	double r = radius();
-	return (4.0/3.0)*M_PI*r*r*r;
+double DwarfPlanet::volume() const {
+	return volume(radius());
+}
+
+double DwarfPlanet::volume(const double & r) {
+	return sphereFactor*r*r*r;
 }
 
 } /* namespace planets */
@@ -33,6 +33,7 @@
 #define DWARFPLANET_H_
 
 #include "Planet.h"
+#include <math.h>
 
 namespace planets {
 
@@ -51,6 +52,13 @@ public:
 	 */
 	constexpr const static double density = 1.88;
 
+	/**
+	 * The volume of a sphere divided by the cube of its radius. It is shared
+	 * with the code that computes volumes from the radius columns, so that
+	 * both always agree.
+	 */
+	constexpr const static double sphereFactor = (4.0/3.0)*M_PI;
+
 	/**
 	 * Constructor
 	 */
@@ -64,7 +72,16 @@ public:
 	/**
 	 * This operation returns the volume of the dwarf planet.
 	 */
-	double volume();
+	double volume() const;
+
+	/**
+	 * This operation returns the volume of a dwarf planet with the given
+	 * radius. It works on the radius columns of a BodySystem, so it does not
+	 * need a DwarfPlanet object.
+	 * @param radius the radius of the dwarf planet
+	 * @return the volume
+	 */
+	static double volume(const double & radius);
 
 };
 
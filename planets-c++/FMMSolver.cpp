@@ -0,0 +1,481 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include "FMMSolver.h"
+#include "Octree.h"
+#include "Profiler.h"
+#include <array>
+#include <math.h>
+
+namespace planets {
+
+namespace {
+
+/**
+ * A table of all of the multi-indices (i,j,k) with i + j + k <= order. They
+ * are sorted by total degree so that recurrences can run in order.
+ */
+struct MultiIndex {
+
+	/// The largest total degree
+	int order;
+
+	/// The exponents of every term
+	std::vector<std::array<int, 3>> exps;
+
+	/// The term index of every (i,j,k), or -1 if the degree is too high
+	std::vector<int> lookup;
+
+	MultiIndex(int p) :
+			order(p), lookup((p + 1) * (p + 1) * (p + 1), -1) {
+		for (int n = 0; n <= p; n++) {
+			for (int i = n; i >= 0; i--) {
+				for (int j = n - i; j >= 0; j--) {
+					lookup[(i * (p + 1) + j) * (p + 1) + n - i - j] = exps.size();
+					exps.push_back({i, j, n - i - j});
+				}
+			}
+		}
+	}
+
+	int operator()(int i, int j, int k) const {
+		return lookup[(i * (order + 1) + j) * (order + 1) + k];
+	}
+
+	int size() const {
+		return exps.size();
+	}
+};
+
+/**
+ * A term in one of the expansion translations. All of the translations are
+ * sums of products with constant coefficients, so they are tabulated once.
+ */
+struct Term {
+	int out, in, other;
+	double coeff;
+};
+
+/**
+ * This is the working state of a single solve.
+ */
+struct FMMContext {
+
+	const Octree & tree;
+	const MultiIndex & terms;
+	double theta;
+	int numTerms;
+
+	/// Radius of the sphere around each cell center that holds its bodies
+	std::vector<double> radius;
+
+	/// Raw multipole moments, sum m * d^a, of every cell
+	std::vector<double> multipoles;
+
+	/// Local Taylor coefficients of every cell
+	std::vector<double> locals;
+
+	/// Potential from direct summation, in the sorted order
+	std::vector<double> direct;
+
+	/// Multipole to local terms: L[out] += coeff * Q[in] * a[other]
+	std::vector<Term> m2l;
+
+	/// Shift terms for a >= b: out = a, in = b, other = a - b
+	std::vector<Term> shift;
+
+	/// Scratch space for the powers of the components of a vector
+	std::vector<double> powers;
+
+	FMMContext(const Octree & _tree, const MultiIndex & _terms,
+			double _theta) :
+			tree(_tree), terms(_terms), theta(_theta), numTerms(
+					_terms.size()), radius(_tree.nodes().size(), 0.0), multipoles(
+					_tree.nodes().size() * _terms.size(), 0.0), locals(
+					_tree.nodes().size() * _terms.size(), 0.0), direct(
+					_tree.x().size(), 0.0), powers(3 * (_terms.order + 1)) {
+
+		int p = terms.order;
+		std::vector<std::vector<double>> binom(p + 1,
+				std::vector<double>(p + 1, 0.0));
+		for (int n = 0; n <= p; n++) {
+			binom[n][0] = 1.0;
+			for (int k = 1; k <= n; k++) {
+				binom[n][k] = binom[n - 1][k - 1]
+						+ ((k < n) ? binom[n - 1][k] : 0.0);
+			}
+		}
+
+		for (int b = 0; b < numTerms; b++) {
+			const auto & eb = terms.exps[b];
+			for (int a = 0; a < numTerms; a++) {
+				const auto & ea = terms.exps[a];
+				// M2L pairs are truncated at a total degree of p
+				int degree = ea[0] + ea[1] + ea[2] + eb[0] + eb[1] + eb[2];
+				if (degree <= p) {
+					double sign = ((ea[0] + ea[1] + ea[2]) % 2) ? -1.0 : 1.0;
+					m2l.push_back({b, a,
+							terms(ea[0] + eb[0], ea[1] + eb[1], ea[2] + eb[2]),
+							sign * binom[ea[0] + eb[0]][eb[0]]
+									* binom[ea[1] + eb[1]][eb[1]]
+									* binom[ea[2] + eb[2]][eb[2]]});
+				}
+				// Shifts pair every a with every b <= a
+				if (eb[0] <= ea[0] && eb[1] <= ea[1] && eb[2] <= ea[2]) {
+					shift.push_back({a, b,
+							terms(ea[0] - eb[0], ea[1] - eb[1], ea[2] - eb[2]),
+							binom[ea[0]][eb[0]] * binom[ea[1]][eb[1]]
+									* binom[ea[2]][eb[2]]});
+				}
+			}
+		}
+	}
+
+	/**
+	 * This operation computes the monomials d^a for every term.
+	 */
+	void monomials(double dx, double dy, double dz,
+			std::vector<double> & mono) {
+		int p = terms.order;
+		double * px = &powers[0], * py = px + p + 1, * pz = py + p + 1;
+		px[0] = py[0] = pz[0] = 1.0;
+		for (int n = 1; n <= p; n++) {
+			px[n] = px[n - 1] * dx;
+			py[n] = py[n - 1] * dy;
+			pz[n] = pz[n - 1] * dz;
+		}
+		for (int t = 0; t < numTerms; t++) {
+			const auto & e = terms.exps[t];
+			mono[t] = px[e[0]] * py[e[1]] * pz[e[2]];
+		}
+	}
+
+	/**
+	 * This operation computes the Taylor coefficients of 1/r, which are the
+	 * derivatives of 1/r divided by the factorials of the multi-index, with
+	 * the recurrence
+	 * n r^2 a_k = -(2n-1) sum_i R_i a_{k-e_i} - (n-1) sum_i a_{k-2e_i}.
+	 */
+	void taylor(double rx, double ry, double rz,
+			std::vector<double> & a) const {
+		double r2 = rx * rx + ry * ry + rz * rz;
+		a[0] = 1.0 / sqrt(r2);
+		for (int t = 1; t < numTerms; t++) {
+			const auto & e = terms.exps[t];
+			int n = e[0] + e[1] + e[2];
+			double first = 0.0, second = 0.0;
+			if (e[0] > 0) first += rx * a[terms(e[0] - 1, e[1], e[2])];
+			if (e[1] > 0) first += ry * a[terms(e[0], e[1] - 1, e[2])];
+			if (e[2] > 0) first += rz * a[terms(e[0], e[1], e[2] - 1)];
+			if (e[0] > 1) second += a[terms(e[0] - 2, e[1], e[2])];
+			if (e[1] > 1) second += a[terms(e[0], e[1] - 2, e[2])];
+			if (e[2] > 1) second += a[terms(e[0], e[1], e[2] - 2)];
+			a[t] = -((2 * n - 1) * first + (n - 1) * second) / (n * r2);
+		}
+	}
+
+	/**
+	 * This operation computes the multipoles of every cell from the leaves
+	 * up.
+	 */
+	void upwardPass() {
+		const auto & cells = tree.nodes();
+		const auto & x = tree.x();
+		const auto & y = tree.y();
+		const auto & z = tree.z();
+		const auto & m = tree.m();
+		std::vector<double> mono(numTerms);
+		// Children always come after their parents in the list.
+		for (int c = cells.size() - 1; c >= 0; c--) {
+			const OctreeNode & cell = cells[c];
+			double * Q = &multipoles[c * numTerms];
+			double r = 0.0;
+			if (cell.leaf) {
+				for (int i = cell.begin; i < cell.end; i++) {
+					double dx = x[i] - cell.center[0];
+					double dy = y[i] - cell.center[1];
+					double dz = z[i] - cell.center[2];
+					r = fmax(r, sqrt(dx * dx + dy * dy + dz * dz));
+					monomials(dx, dy, dz, mono);
+					for (int t = 0; t < numTerms; t++) {
+						Q[t] += m[i] * mono[t];
+					}
+				}
+			} else {
+				for (int k = 0; k < 8; k++) {
+					int ci = cell.child[k];
+					if (ci < 0) {
+						continue;
+					}
+					const OctreeNode & child = cells[ci];
+					double sx = child.center[0] - cell.center[0];
+					double sy = child.center[1] - cell.center[1];
+					double sz = child.center[2] - cell.center[2];
+					r = fmax(r, radius[ci] + sqrt(sx * sx + sy * sy + sz * sz));
+					monomials(sx, sy, sz, mono);
+					const double * childQ = &multipoles[ci * numTerms];
+					for (const Term & term : shift) {
+						Q[term.out] += term.coeff * childQ[term.in]
+								* mono[term.other];
+					}
+				}
+			}
+			radius[c] = r;
+		}
+	}
+
+	/**
+	 * This operation adds the contribution of the bodies in cell a to the
+	 * bodies in cell b by direct summation.
+	 */
+	void p2p(int b, int a) {
+		const OctreeNode & target = tree.nodes()[b];
+		const OctreeNode & source = tree.nodes()[a];
+		const auto & x = tree.x();
+		const auto & y = tree.y();
+		const auto & z = tree.z();
+		const auto & m = tree.m();
+		for (int i = target.begin; i < target.end; i++) {
+			double pot = 0.0;
+			for (int j = source.begin; j < source.end; j++) {
+				if (j != i) {
+					double dx = x[i] - x[j];
+					double dy = y[i] - y[j];
+					double dz = z[i] - z[j];
+					pot += m[j] / sqrt(dx * dx + dy * dy + dz * dz);
+				}
+			}
+			direct[i] += pot;
+		}
+	}
+
+	/**
+	 * This operation translates the multipoles of cell a into the local
+	 * expansion of cell b.
+	 */
+	void m2lTranslate(int b, int a, std::vector<double> & coeffs) {
+		const OctreeNode & target = tree.nodes()[b];
+		const OctreeNode & source = tree.nodes()[a];
+		taylor(target.center[0] - source.center[0],
+				target.center[1] - source.center[1],
+				target.center[2] - source.center[2], coeffs);
+		const double * Q = &multipoles[a * numTerms];
+		double * L = &locals[b * numTerms];
+		for (const Term & term : m2l) {
+			L[term.out] += term.coeff * Q[term.in] * coeffs[term.other];
+		}
+	}
+
+	/**
+	 * This operation computes the interaction of source cell a on target
+	 * cell b with a dual tree traversal.
+	 */
+	void interact(int b, int a, std::vector<double> & coeffs) {
+		const OctreeNode & target = tree.nodes()[b];
+		const OctreeNode & source = tree.nodes()[a];
+		if (a == b) {
+			// A cell acting on itself can only be split or summed directly
+			if (target.leaf) {
+				p2p(b, a);
+			} else {
+				for (int i = 0; i < 8; i++) {
+					for (int j = 0; j < 8; j++) {
+						if (target.child[i] >= 0 && target.child[j] >= 0) {
+							interact(target.child[i], target.child[j], coeffs);
+						}
+					}
+				}
+			}
+			return;
+		}
+
+		double dx = target.center[0] - source.center[0];
+		double dy = target.center[1] - source.center[1];
+		double dz = target.center[2] - source.center[2];
+		double dist = sqrt(dx * dx + dy * dy + dz * dz);
+		if (radius[a] + radius[b] < theta * dist) {
+			m2lTranslate(b, a, coeffs);
+		} else if (target.leaf && source.leaf) {
+			p2p(b, a);
+		} else if (target.leaf
+				|| (!source.leaf && radius[a] > radius[b])) {
+			for (int k = 0; k < 8; k++) {
+				if (source.child[k] >= 0) {
+					interact(b, source.child[k], coeffs);
+				}
+			}
+		} else {
+			for (int k = 0; k < 8; k++) {
+				if (target.child[k] >= 0) {
+					interact(target.child[k], a, coeffs);
+				}
+			}
+		}
+	}
+
+	/**
+	 * This operation passes the local expansions down the tree and adds them
+	 * to the direct sums of the bodies.
+	 */
+	void downwardPass() {
+		const auto & cells = tree.nodes();
+		const auto & x = tree.x();
+		const auto & y = tree.y();
+		const auto & z = tree.z();
+		std::vector<double> mono(numTerms);
+		// Parents always come before their children in the list.
+		for (int c = 0; c < (int) cells.size(); c++) {
+			const OctreeNode & cell = cells[c];
+			const double * L = &locals[c * numTerms];
+			if (cell.leaf) {
+				for (int i = cell.begin; i < cell.end; i++) {
+					monomials(x[i] - cell.center[0], y[i] - cell.center[1],
+							z[i] - cell.center[2], mono);
+					double pot = 0.0;
+					for (int t = 0; t < numTerms; t++) {
+						pot += L[t] * mono[t];
+					}
+					direct[i] += pot;
+				}
+			} else {
+				for (int k = 0; k < 8; k++) {
+					int ci = cell.child[k];
+					if (ci < 0) {
+						continue;
+					}
+					const OctreeNode & child = cells[ci];
+					monomials(child.center[0] - cell.center[0],
+							child.center[1] - cell.center[1],
+							child.center[2] - cell.center[2], mono);
+					double * childL = &locals[ci * numTerms];
+					for (const Term & term : shift) {
+						childL[term.in] += term.coeff * L[term.out]
+								* mono[term.other];
+					}
+				}
+			}
+		}
+	}
+};
+
+} /* anonymous namespace */
+
+FMMSolver::FMMSolver(int order, double theta, int leafSize) :
+		expansionOrder(order), openingAngle(theta), maxLeafSize(leafSize) {
+
+}
+
+FMMSolver::~FMMSolver() {
+
+}
+
+int FMMSolver::order() const {
+	return expansionOrder;
+}
+
+void FMMSolver::order(const int & _order) {
+	expansionOrder = _order;
+}
+
+double FMMSolver::theta() const {
+	return openingAngle;
+}
+
+void FMMSolver::theta(const double & _theta) {
+	openingAngle = _theta;
+}
+
+std::vector<double> FMMSolver::getPotentials(
+		const BodySystem & system) const {
+	PLANETS_TIMER("FMMSolver::getPotentials");
+	int numBodies = system.size();
+	std::vector<double> potentials(numBodies);
+	if (numBodies == 0) {
+		return potentials;
+	}
+	if (expansionOrder < 0 || openingAngle >= 1.0) {
+		throw "FMMSolver requires order >= 0 and theta < 1.";
+	}
+
+	Octree tree(system, maxLeafSize);
+	MultiIndex terms(expansionOrder);
+	FMMContext context(tree, terms, openingAngle);
+	{
+		PLANETS_TIMER("FMMSolver::upwardPass");
+		context.upwardPass();
+	}
+
+	// Split the targets into the subtrees two levels below the root. Each
+	// subtree only receives contributions in its own cells and bodies, so
+	// the subtrees can be handled in parallel. The split does not depend on
+	// the number of threads, so neither do the results.
+	const auto & cells = tree.nodes();
+	std::vector<int> targets, level(1, 0);
+	for (int depth = 0; !level.empty(); depth++) {
+		std::vector<int> nextLevel;
+		for (int c : level) {
+			if (depth == 2 || cells[c].leaf) {
+				targets.push_back(c);
+				continue;
+			}
+			for (int k = 0; k < 8; k++) {
+				if (cells[c].child[k] >= 0) {
+					nextLevel.push_back(cells[c].child[k]);
+				}
+			}
+		}
+		level.swap(nextLevel);
+	}
+	std::vector<std::vector<double>> coeffs(threads(),
+			std::vector<double>(terms.size()));
+	{
+		PLANETS_TIMER("FMMSolver::interact");
+		parallelFor(targets.size(), 1, [&](int begin, int end, int thread) {
+			for (int t = begin; t < end; t++) {
+				context.interact(targets[t], 0, coeffs[thread]);
+			}
+		});
+	}
+	{
+		PLANETS_TIMER("FMMSolver::downwardPass");
+		context.downwardPass();
+	}
+
+	// Scale by G and M and put the potentials back in the original order
+	const auto & m = tree.m();
+	for (int i = 0; i < numBodies; i++) {
+		potentials[tree.order()[i]] = -G * m[i] * context.direct[i];
+	}
+
+	return potentials;
+}
+
+} /* namespace planets */
@@ -0,0 +1,112 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef FMMSOLVER_H_
+#define FMMSOLVER_H_
+
+#include "PotentialSolver.h"
+
+namespace planets {
+
+/**
+ * The FMMSolver computes the potentials with the Fast Multipole Method. The
+ * bodies are sorted into an Octree and the mass in every cell is described
+ * by a Cartesian multipole expansion about the center of the cell. Pairs of
+ * well separated cells interact through local (Taylor) expansions, which are
+ * passed down the tree and evaluated at the bodies. Pairs of cells that are
+ * too close are summed directly. The cost grows as O(N) for a fixed order.
+ *
+ * Two cells A and B are well separated if (r_A + r_B) < theta * d, where r
+ * is the radius of the sphere around the center of a cell that holds all of
+ * its bodies and d is the distance between the centers. The error falls off
+ * roughly as theta^(p+1) for expansions of order p, so both the order and
+ * theta can be used to trade accuracy for speed. Theta must be less than 1.
+ * Only the interactions between cells are computed in parallel.
+ */
+class FMMSolver: public PotentialSolver {
+
+	/// The order of the expansions
+	int expansionOrder;
+
+	/// The opening angle
+	double openingAngle;
+
+	/// The maximum number of bodies in a leaf of the tree
+	int maxLeafSize;
+
+public:
+
+	/**
+	 * Constructor
+	 * @param order the order of the multipole and local expansions
+	 * @param theta the opening angle
+	 * @param leafSize the maximum number of bodies in a leaf of the tree
+	 */
+	FMMSolver(int order = 4, double theta = 0.6, int leafSize = 32);
+
+	/**
+	 * Destructor
+	 */
+	virtual ~FMMSolver();
+
+	/**
+	 * This operation returns the order of the expansions.
+	 * @return the order
+	 */
+	int order() const;
+
+	/**
+	 * This operation sets the order of the expansions.
+	 * @param _order the new order, which must not be negative
+	 */
+	void order(const int & _order);
+
+	/**
+	 * This operation returns the opening angle.
+	 * @return the opening angle
+	 */
+	double theta() const;
+
+	/**
+	 * This operation sets the opening angle.
+	 * @param _theta the new opening angle
+	 */
+	void theta(const double & _theta);
+
+	using PotentialSolver::getPotentials;
+
+	virtual std::vector<double> getPotentials(
+			const BodySystem & system) const;
+};
+
+} /* namespace planets */
+
+#endif /* FMMSOLVER_H_ */
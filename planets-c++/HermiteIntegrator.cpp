@@ -0,0 +1,110 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include "HermiteIntegrator.h"
+
+namespace planets {
+
+HermiteIntegrator::HermiteIntegrator(const DirectSolver & forces) :
+		Integrator(forces), directSolver(forces) {
+
+}
+
+HermiteIntegrator::~HermiteIntegrator() {
+
+}
+
+void HermiteIntegrator::computeForces(const BodySystem & system) {
+	int numBodies = system.size();
+	for (auto column : { &ax, &ay, &az, &jx, &jy, &jz }) {
+		column->resize(numBodies);
+	}
+	directSolver.getAccelerationsAndJerks(system, ax.data(), ay.data(),
+			az.data(), jx.data(), jy.data(), jz.data());
+	accelerationsValid = true;
+	countForceEvaluations(numBodies);
+}
+
+void HermiteIntegrator::advance(BodySystem & system, double dt) {
+	int numBodies = system.size();
+	if (!accelerationsValid) {
+		computeForces(system);
+	}
+
+	double * x = system.x(), * y = system.y(), * z = system.z();
+	double * vx = system.vx(), * vy = system.vy(), * vz = system.vz();
+
+	// Keep the state at the start of the step
+	x0.assign(x, x + numBodies);
+	y0.assign(y, y + numBodies);
+	z0.assign(z, z + numBodies);
+	vx0.assign(vx, vx + numBodies);
+	vy0.assign(vy, vy + numBodies);
+	vz0.assign(vz, vz + numBodies);
+	ax0 = ax;
+	ay0 = ay;
+	az0 = az;
+	jx0 = jx;
+	jy0 = jy;
+	jz0 = jz;
+
+	// Predict
+	double dt2 = dt * dt / 2.0, dt3 = dt * dt * dt / 6.0;
+	for (int i = 0; i < numBodies; i++) {
+		x[i] += vx[i] * dt + ax[i] * dt2 + jx[i] * dt3;
+		y[i] += vy[i] * dt + ay[i] * dt2 + jy[i] * dt3;
+		z[i] += vz[i] * dt + az[i] * dt2 + jz[i] * dt3;
+		vx[i] += ax[i] * dt + jx[i] * dt2;
+		vy[i] += ay[i] * dt + jy[i] * dt2;
+		vz[i] += az[i] * dt + jz[i] * dt2;
+	}
+
+	// Evaluate at the predicted state
+	computeForces(system);
+
+	// Correct. The velocities go first because the positions need them.
+	double half = dt / 2.0, twelfth = dt * dt / 12.0;
+	for (int i = 0; i < numBodies; i++) {
+		vx[i] = vx0[i] + (ax0[i] + ax[i]) * half + (jx0[i] - jx[i]) * twelfth;
+		vy[i] = vy0[i] + (ay0[i] + ay[i]) * half + (jy0[i] - jy[i]) * twelfth;
+		vz[i] = vz0[i] + (az0[i] + az[i]) * half + (jz0[i] - jz[i]) * twelfth;
+		x[i] = x0[i] + (vx0[i] + vx[i]) * half + (ax0[i] - ax[i]) * twelfth;
+		y[i] = y0[i] + (vy0[i] + vy[i]) * half + (ay0[i] - ay[i]) * twelfth;
+		z[i] = z0[i] + (vz0[i] + vz[i]) * half + (az0[i] - az[i]) * twelfth;
+	}
+
+	// The forces were evaluated at the predicted state. Re-evaluating them
+	// at the corrected state would double the cost for a change that is
+	// well below the error of the scheme, so they are kept for the next
+	// step as is usual for Hermite codes.
+}
+
+} /* namespace planets */
@@ -0,0 +1,92 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef HERMITEINTEGRATOR_H_
+#define HERMITEINTEGRATOR_H_
+
+#include "Integrator.h"
+#include "DirectSolver.h"
+
+namespace planets {
+
+/**
+ * The HermiteIntegrator advances the system with the fourth order Hermite
+ * predictor-corrector scheme of Makino and Aarseth (1992). The positions
+ * and velocities are predicted with a Taylor series in the accelerations
+ * and jerks, the accelerations and jerks are evaluated at the predicted
+ * state, and the step is corrected with a Hermite interpolation of the two
+ * evaluations:
+ * v1 = v0 + (a0 + a1) dt/2 + (j0 - j1) dt^2/12
+ * x1 = x0 + (v0 + v1) dt/2 + (a0 - a1) dt^2/12
+ *
+ * It costs one force evaluation per step, like leapfrog, but each is about
+ * twice as expensive because it includes the jerks, which only DirectSolver
+ * can compute. In exchange, the error falls with the fourth power of the
+ * step instead of the second.
+ */
+class HermiteIntegrator: public Integrator {
+
+	/// The direct solver, which also computes the jerks
+	const DirectSolver & directSolver;
+
+	/// The jerks of the bodies
+	std::vector<double> jx, jy, jz;
+
+	/// The state at the start of the step
+	std::vector<double> x0, y0, z0, vx0, vy0, vz0, ax0, ay0, az0, jx0, jy0,
+			jz0;
+
+	/**
+	 * This operation computes the accelerations and jerks of the bodies.
+	 */
+	void computeForces(const BodySystem & system);
+
+protected:
+
+	virtual void advance(BodySystem & system, double dt);
+
+public:
+
+	/**
+	 * Constructor
+	 * @param forces the solver that computes the accelerations and jerks
+	 */
+	HermiteIntegrator(const DirectSolver & forces);
+
+	/**
+	 * Destructor
+	 */
+	virtual ~HermiteIntegrator();
+};
+
+} /* namespace planets */
+
+#endif /* HERMITEINTEGRATOR_H_ */
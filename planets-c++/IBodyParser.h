@@ -34,7 +34,11 @@
 
 #include <vector>
 #include <string>
+#include <functional>
+#include <iterator>
+#include <algorithm>
 #include "CelestialBody.h"
+#include "BodySystem.h"
 
 namespace planets {
 
@@ -43,11 +47,21 @@ namespace planets {
  * file and returning a list of Celestial Bodies. This interface was
  * specifically included to show interface realization in C++. In other
  * situations I prefer to handle I/O with templated functions.
+ *
+ * Catalogs that are too big to hold in memory at once can be streamed in
+ * batches of a fixed size instead. Only one batch is held at a time.
  */
 class IBodyParser {
 
 public:
 
+	/**
+	 * The function that receives each batch of bodies while streaming. The
+	 * batch is cleared after the call returns, so the handler may move the
+	 * bodies out of it.
+	 */
+	typedef std::function<void(std::vector<CelestialBody> & batch)> BatchHandler;
+
 	/**
 	 * Destructor.
 	 */
@@ -63,6 +77,45 @@ public:
 	 * result (C++11) instead of copying it.
 	 */
 	virtual std::vector<CelestialBody> parseBodies(const std::string & inputFile) const = 0;
+
+	/**
+	 * This operation parses an input file straight into the structure of
+	 * arrays layout of a BodySystem. The default implementation converts the
+	 * result of parseBodies(), so parsers should override it if they can
+	 * fill the system directly, which avoids creating a CelestialBody and a
+	 * label string for every body.
+	 * @param inputFile the name of the input file containing information about
+	 * the bodies.
+	 * @return the system
+	 */
+	virtual BodySystem parseSystem(const std::string & inputFile) const {
+		return BodySystem(parseBodies(inputFile));
+	}
+
+	/**
+	 * This operation parses an input file and hands the bodies to a handler
+	 * in batches, in the order that they appear in the file. Every batch
+	 * except the last holds exactly batchSize bodies. The default
+	 * implementation parses the whole file first, so parsers should
+	 * override it if they can read the file incrementally.
+	 * @param inputFile the name of the input file containing information about
+	 * the bodies.
+	 * @param batchSize the number of bodies in a batch
+	 * @param handler the function that is called for each batch
+	 */
+	virtual void parseBodies(const std::string & inputFile, int batchSize,
+			const BatchHandler & handler) const {
+		auto bodies = parseBodies(inputFile);
+		int numBodies = bodies.size();
+		batchSize = std::max(batchSize, 1);
+		std::vector<CelestialBody> batch;
+		for (int i = 0; i < numBodies; i += batchSize) {
+			int batchEnd = std::min(i + batchSize, numBodies);
+			batch.assign(std::make_move_iterator(bodies.begin() + i),
+					std::make_move_iterator(bodies.begin() + batchEnd));
+			handler(batch);
+		}
+	}
 };
 
 } /* namespace planets */
@@ -0,0 +1,209 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include "IncrementalSolver.h"
+#include "Profiler.h"
+#include <math.h>
+
+namespace planets {
+
+IncrementalSolver::IncrementalSolver(int interval) :
+		numUpdates(0), maxUpdates(interval), numFullRecomputes(0),
+		numChanged(0) {
+
+}
+
+IncrementalSolver::~IncrementalSolver() {
+
+}
+
+int IncrementalSolver::recomputeInterval() const {
+	return maxUpdates;
+}
+
+void IncrementalSolver::recomputeInterval(const int & _interval) {
+	maxUpdates = (_interval > 0) ? _interval : 0;
+}
+
+void IncrementalSolver::reset() {
+	xs.clear();
+	ys.clear();
+	zs.clear();
+	ms.clear();
+	sums.clear();
+	numUpdates = 0;
+}
+
+long IncrementalSolver::fullRecomputes() const {
+	return numFullRecomputes;
+}
+
+int IncrementalSolver::changedBodies() const {
+	return numChanged;
+}
+
+void IncrementalSolver::recompute(const BodySystem & system) const {
+	int numBodies = system.size();
+	const double * x = system.x();
+	const double * y = system.y();
+	const double * z = system.z();
+	const double * m = system.m();
+
+	xs.assign(x, x + numBodies);
+	ys.assign(y, y + numBodies);
+	zs.assign(z, z + numBodies);
+	ms.assign(m, m + numBodies);
+	sums.resize(numBodies);
+	PLANETS_COUNT(Interactions, (long) numBodies * (numBodies - 1));
+
+	parallelFor(numBodies, blockSize(), [&](int begin, int end, int) {
+		for (int i = begin; i < end; i++) {
+			double sum = 0.0;
+			for (int j = 0; j < numBodies; j++) {
+				if (j != i) {
+					double dx = x[i] - x[j];
+					double dy = y[i] - y[j];
+					double dz = z[i] - z[j];
+					sum += m[j] / sqrt(dx * dx + dy * dy + dz * dz);
+				}
+			}
+			sums[i] = sum;
+		}
+	});
+
+	numUpdates = 0;
+	numFullRecomputes++;
+	numChanged = numBodies;
+}
+
+void IncrementalSolver::update(const BodySystem & system,
+		const std::vector<int> & changed) const {
+	int numBodies = system.size(), numChangedBodies = changed.size();
+	const double * x = system.x();
+	const double * y = system.y();
+	const double * z = system.z();
+	const double * m = system.m();
+	std::vector<char> isChanged(numBodies, 0);
+	for (int j : changed) {
+		isChanged[j] = 1;
+	}
+	PLANETS_COUNT(Interactions, (long) numChangedBodies * (numBodies - 1)
+			+ 2L * (numBodies - numChangedBodies) * numChangedBodies);
+
+	// The stored arrays still hold the old state of the changed bodies, so
+	// both contributions are available in the same pass.
+	parallelFor(numBodies, blockSize(), [&](int begin, int end, int) {
+		for (int i = begin; i < end; i++) {
+			if (isChanged[i]) {
+				// The body moved with respect to everything, so start over
+				double sum = 0.0;
+				for (int j = 0; j < numBodies; j++) {
+					if (j != i) {
+						double dx = x[i] - x[j];
+						double dy = y[i] - y[j];
+						double dz = z[i] - z[j];
+						sum += m[j] / sqrt(dx * dx + dy * dy + dz * dz);
+					}
+				}
+				sums[i] = sum;
+			} else {
+				// Swap the old contributions of the changed bodies for the
+				// new ones
+				double correction = 0.0;
+				for (int k = 0; k < numChangedBodies; k++) {
+					int j = changed[k];
+					double dx = x[i] - xs[j];
+					double dy = y[i] - ys[j];
+					double dz = z[i] - zs[j];
+					correction -= ms[j] / sqrt(dx * dx + dy * dy + dz * dz);
+					dx = x[i] - x[j];
+					dy = y[i] - y[j];
+					dz = z[i] - z[j];
+					correction += m[j] / sqrt(dx * dx + dy * dy + dz * dz);
+				}
+				sums[i] += correction;
+			}
+		}
+	});
+
+	// Store the new state
+	for (int j : changed) {
+		xs[j] = x[j];
+		ys[j] = y[j];
+		zs[j] = z[j];
+		ms[j] = m[j];
+	}
+
+	numUpdates++;
+	numChanged = numChangedBodies;
+}
+
+std::vector<double> IncrementalSolver::getPotentials(
+		const BodySystem & system) const {
+	PLANETS_TIMER("IncrementalSolver::getPotentials");
+	int numBodies = system.size();
+	const double * x = system.x();
+	const double * y = system.y();
+	const double * z = system.z();
+	const double * m = system.m();
+
+	if ((int) sums.size() != numBodies || numUpdates >= maxUpdates) {
+		recompute(system);
+	} else {
+		// Find the bodies that changed
+		std::vector<int> changed;
+		for (int i = 0; i < numBodies; i++) {
+			if (x[i] != xs[i] || y[i] != ys[i] || z[i] != zs[i]
+					|| m[i] != ms[i]) {
+				changed.push_back(i);
+			}
+		}
+		// Correcting costs about twice as much per body as recomputing, so
+		// give up if more than half of the bodies changed.
+		if (2 * changed.size() > (size_t) numBodies) {
+			recompute(system);
+		} else if (!changed.empty()) {
+			update(system, changed);
+		} else {
+			numChanged = 0;
+		}
+	}
+
+	// Scale by G and M
+	std::vector<double> potentials(numBodies);
+	for (int i = 0; i < numBodies; i++) {
+		potentials[i] = -G * m[i] * sums[i];
+	}
+
+	return potentials;
+}
+
+} /* namespace planets */
@@ -0,0 +1,150 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef INCREMENTALSOLVER_H_
+#define INCREMENTALSOLVER_H_
+
+#include "PotentialSolver.h"
+
+namespace planets {
+
+/**
+ * The IncrementalSolver computes the potentials by direct summation, but
+ * remembers the system from the last call. When it is called again with
+ * the same bodies after a few of them moved or changed mass, for example
+ * through the CelestialBody::pos() and mass() setters, it only corrects the
+ * potentials instead of computing them from scratch.
+ *
+ * The solver keeps the field sum S_i = sum_j m_j/r_ij of every body. For k
+ * changed bodies, the sums of the unchanged bodies are corrected by
+ * subtracting the old contribution of each changed body and adding the new
+ * one, and the sums of the changed bodies are recomputed. This costs
+ * O(N k) instead of O(N^2). Changed bodies are found by comparing the
+ * positions and masses with the stored copy, which is O(N).
+ *
+ * Every correction adds a little round-off, so the sums are recomputed
+ * from scratch after a fixed number of incremental updates. They are also
+ * recomputed when the number of bodies changes or when so many bodies
+ * changed that a full recompute is cheaper.
+ *
+ * The stored state is not guarded, so one IncrementalSolver must not be
+ * used from several threads at once. Each call does use the threads of the
+ * solver.
+ */
+class IncrementalSolver: public PotentialSolver {
+
+	/// The positions and masses from the last call
+	mutable std::vector<double> xs, ys, zs, ms;
+
+	/// The field sum of every body from the last call
+	mutable std::vector<double> sums;
+
+	/// The number of incremental updates since the last full recompute
+	mutable int numUpdates;
+
+	/// The number of incremental updates between full recomputes
+	int maxUpdates;
+
+	/// The number of full recomputes
+	mutable long numFullRecomputes;
+
+	/// The number of bodies that changed in the last call
+	mutable int numChanged;
+
+	/**
+	 * This operation recomputes all of the field sums and stores the
+	 * system.
+	 */
+	void recompute(const BodySystem & system) const;
+
+	/**
+	 * This operation corrects the field sums for the bodies that changed.
+	 */
+	void update(const BodySystem & system,
+			const std::vector<int> & changed) const;
+
+public:
+
+	/**
+	 * Constructor
+	 * @param interval the number of incremental updates between full
+	 * recomputes
+	 */
+	IncrementalSolver(int interval = 100);
+
+	/**
+	 * Destructor
+	 */
+	virtual ~IncrementalSolver();
+
+	/**
+	 * This operation returns the number of incremental updates between full
+	 * recomputes.
+	 * @return the interval
+	 */
+	int recomputeInterval() const;
+
+	/**
+	 * This operation sets the number of incremental updates between full
+	 * recomputes.
+	 * @param _interval the new interval. 0 recomputes every time.
+	 */
+	void recomputeInterval(const int & _interval);
+
+	/**
+	 * This operation forgets the stored system, so that the next call
+	 * recomputes everything.
+	 */
+	void reset();
+
+	/**
+	 * This operation returns the number of full recomputes so far.
+	 * @return the number of full recomputes
+	 */
+	long fullRecomputes() const;
+
+	/**
+	 * This operation returns the number of bodies that changed between the
+	 * last two calls.
+	 * @return the number of changed bodies, or the number of bodies if the
+	 * last call was a full recompute
+	 */
+	int changedBodies() const;
+
+	using PotentialSolver::getPotentials;
+
+	virtual std::vector<double> getPotentials(
+			const BodySystem & system) const;
+};
+
+} /* namespace planets */
+
+#endif /* INCREMENTALSOLVER_H_ */
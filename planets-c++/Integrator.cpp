@@ -0,0 +1,100 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include "Integrator.h"
+#include <chrono>
+
+namespace planets {
+
+Integrator::Integrator(const PotentialSolver & forces) :
+		numSteps(0), elapsedSeconds(0.0), numForceEvaluations(0),
+		solver(forces), accelerationsValid(false) {
+
+}
+
+Integrator::~Integrator() {
+
+}
+
+void Integrator::computeAccelerations(const BodySystem & system) {
+	int numBodies = system.size();
+	ax.resize(numBodies);
+	ay.resize(numBodies);
+	az.resize(numBodies);
+	solver.getAccelerations(system, ax.data(), ay.data(), az.data());
+	accelerationsValid = true;
+	countForceEvaluations(numBodies);
+}
+
+void Integrator::countForceEvaluations(long numBodies) {
+	numForceEvaluations += numBodies;
+}
+
+void Integrator::step(BodySystem & system, double dt) {
+	// The accelerations can not belong to a system of a different size
+	if (ax.size() != (size_t) system.size()) {
+		accelerationsValid = false;
+	}
+	auto start = std::chrono::steady_clock::now();
+	advance(system, dt);
+	std::chrono::duration<double> time = std::chrono::steady_clock::now()
+			- start;
+	elapsedSeconds += time.count();
+	numSteps++;
+}
+
+void Integrator::run(BodySystem & system, double dt, int numSteps) {
+	for (int i = 0; i < numSteps; i++) {
+		step(system, dt);
+	}
+}
+
+void Integrator::reset() {
+	accelerationsValid = false;
+}
+
+long Integrator::steps() const {
+	return numSteps;
+}
+
+long Integrator::forceEvaluations() const {
+	return numForceEvaluations;
+}
+
+double Integrator::seconds() const {
+	return elapsedSeconds;
+}
+
+double Integrator::stepsPerSecond() const {
+	return (elapsedSeconds > 0.0) ? numSteps / elapsedSeconds : 0.0;
+}
+
+} /* namespace planets */
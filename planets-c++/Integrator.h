@@ -0,0 +1,166 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef INTEGRATOR_H_
+#define INTEGRATOR_H_
+
+#include <vector>
+#include "BodySystem.h"
+#include "PotentialSolver.h"
+
+namespace planets {
+
+/**
+ * An Integrator moves a system of bodies forward in time. The positions and
+ * velocities are updated in place on the BodySystem, and the accelerations
+ * are computed by a PotentialSolver, which acts as the force backend. For
+ * example, DirectSolver is exact and BarnesHutSolver is O(N log N).
+ *
+ * Integrators may keep the accelerations from the end of one step to start
+ * the next one. If the positions, velocities or masses are changed by
+ * anything other than the integrator, reset() must be called before the
+ * next step.
+ *
+ * The integrator records the number of steps that it took and the time that
+ * they took, so that the throughput in steps per second can be reported.
+ * It also counts the force evaluations, which is the number of bodies whose
+ * accelerations were computed summed over all steps, since that is what
+ * dominates the cost.
+ */
+class Integrator {
+
+	/// The number of steps taken
+	long numSteps;
+
+	/// The time spent in the steps, in seconds
+	double elapsedSeconds;
+
+	/// The number of force evaluations
+	long numForceEvaluations;
+
+protected:
+
+	/// The force backend
+	const PotentialSolver & solver;
+
+	/// The accelerations of the bodies
+	std::vector<double> ax, ay, az;
+
+	/// True if the accelerations belong to the current state of the system
+	bool accelerationsValid;
+
+	/**
+	 * This operation computes the accelerations of the bodies with the
+	 * solver.
+	 * @param system the bodies
+	 */
+	void computeAccelerations(const BodySystem & system);
+
+	/**
+	 * This operation adds to the count of force evaluations. It should be
+	 * called by subclasses that evaluate forces without
+	 * computeAccelerations().
+	 * @param numBodies the number of bodies whose forces were evaluated
+	 */
+	void countForceEvaluations(long numBodies);
+
+	/**
+	 * This operation advances the system by a single step. It is called by
+	 * step(), which takes care of the timing.
+	 * @param system the bodies
+	 * @param dt the time step
+	 */
+	virtual void advance(BodySystem & system, double dt) = 0;
+
+public:
+
+	/**
+	 * Constructor
+	 * @param forces the solver that computes the accelerations. It must
+	 * outlive the integrator.
+	 */
+	Integrator(const PotentialSolver & forces);
+
+	/**
+	 * Destructor
+	 */
+	virtual ~Integrator();
+
+	/**
+	 * This operation advances the system by a single step.
+	 * @param system the bodies
+	 * @param dt the time step
+	 */
+	void step(BodySystem & system, double dt);
+
+	/**
+	 * This operation advances the system by a number of steps.
+	 * @param system the bodies
+	 * @param dt the time step
+	 * @param numSteps the number of steps
+	 */
+	void run(BodySystem & system, double dt, int numSteps);
+
+	/**
+	 * This operation forgets any state that was kept from the last step. It
+	 * must be called if the system is changed between steps.
+	 */
+	virtual void reset();
+
+	/**
+	 * This operation returns the number of steps taken so far.
+	 * @return the number of steps
+	 */
+	long steps() const;
+
+	/**
+	 * This operation returns the number of force evaluations so far.
+	 * @return the number of bodies whose accelerations were computed, summed
+	 * over all steps
+	 */
+	long forceEvaluations() const;
+
+	/**
+	 * This operation returns the time spent taking steps.
+	 * @return the time in seconds
+	 */
+	double seconds() const;
+
+	/**
+	 * This operation returns the throughput of the integrator.
+	 * @return the number of steps per second, or zero if no steps were taken
+	 */
+	double stepsPerSecond() const;
+};
+
+} /* namespace planets */
+
+#endif /* INTEGRATOR_H_ */
@@ -0,0 +1,123 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include <algorithm>
+#include "LabelTable.h"
+
+namespace planets {
+
+LabelTable::LabelTable() {
+
+}
+
+LabelTable::~LabelTable() {
+
+}
+
+int LabelTable::size() const {
+	return lengths.size();
+}
+
+void LabelTable::resize(int numLabels) {
+	offsets.resize(numLabels, chars.size());
+	lengths.resize(numLabels, 0);
+}
+
+void LabelTable::reserve(int numLabels, std::size_t numChars) {
+	chars.reserve(numChars);
+	offsets.reserve(numLabels);
+	lengths.reserve(numLabels);
+}
+
+void LabelTable::add(const char * label, std::size_t length) {
+	offsets.push_back(chars.size());
+	lengths.push_back(length);
+	chars.insert(chars.end(), label, label + length);
+}
+
+void LabelTable::add(const std::string & label) {
+	add(label.data(), label.size());
+}
+
+void LabelTable::append(const LabelTable & other) {
+	if (&other == this) {
+		LabelTable copy(other);
+		append(copy);
+		return;
+	}
+	std::uint64_t shift = chars.size();
+	chars.insert(chars.end(), other.chars.begin(), other.chars.end());
+	for (auto offset : other.offsets) {
+		offsets.push_back(offset + shift);
+	}
+	lengths.insert(lengths.end(), other.lengths.begin(), other.lengths.end());
+}
+
+void LabelTable::assign(int numLabels, const char * labelChars,
+		const std::uint64_t * labelOffsets) {
+	chars.assign(labelChars, labelChars + labelOffsets[numLabels]);
+	offsets.assign(labelOffsets, labelOffsets + numLabels);
+	lengths.resize(numLabels);
+	for (int i = 0; i < numLabels; i++) {
+		lengths[i] = labelOffsets[i + 1] - labelOffsets[i];
+	}
+}
+
+void LabelTable::set(int i, const char * label, std::size_t length) {
+	// Labels from this table could move while the buffer grows
+	if (!chars.empty() && label >= chars.data()
+			&& label < chars.data() + chars.size()) {
+		std::string copy(label, length);
+		set(i, copy.data(), length);
+		return;
+	}
+	if (length > lengths[i]) {
+		offsets[i] = chars.size();
+		chars.insert(chars.end(), label, label + length);
+	} else {
+		std::copy(label, label + length, chars.begin() + offsets[i]);
+	}
+	lengths[i] = length;
+}
+
+std::string LabelTable::get(int i) const {
+	return std::string(data(i), lengths[i]);
+}
+
+const char * LabelTable::data(int i) const {
+	return chars.data() + offsets[i];
+}
+
+std::size_t LabelTable::length(int i) const {
+	return lengths[i];
+}
+
+} /* namespace planets */
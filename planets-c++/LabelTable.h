@@ -0,0 +1,158 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef LABELTABLE_H_
+#define LABELTABLE_H_
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace planets {
+
+/**
+ * A LabelTable stores a list of short strings, such as the labels of the
+ * bodies in a BodySystem, back to back in one character buffer. Each label
+ * is found by its offset and length, so a table of millions of labels takes
+ * three allocations instead of one per label, and walking the labels in
+ * order walks memory in order.
+ *
+ * Labels can be replaced. A label that fits in the space of the old one is
+ * written in place, otherwise it is appended to the buffer and the old
+ * space is abandoned.
+ */
+class LabelTable {
+
+	/// The characters of all labels
+	std::vector<char> chars;
+
+	/// The offset of every label in the characters
+	std::vector<std::uint64_t> offsets;
+
+	/// The length of every label
+	std::vector<std::uint32_t> lengths;
+
+public:
+
+	/**
+	 * Constructor for an empty table
+	 */
+	LabelTable();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~LabelTable();
+
+	/**
+	 * This operation returns the number of labels.
+	 * @return the number of labels
+	 */
+	int size() const;
+
+	/**
+	 * This operation changes the number of labels. New labels are empty.
+	 * @param numLabels the new number of labels
+	 */
+	void resize(int numLabels);
+
+	/**
+	 * This operation reserves space.
+	 * @param numLabels the number of labels
+	 * @param numChars the total number of characters in the labels
+	 */
+	void reserve(int numLabels, std::size_t numChars);
+
+	/**
+	 * This operation adds a label to the end of the table.
+	 * @param label the first character of the label
+	 * @param length the number of characters in the label
+	 */
+	void add(const char * label, std::size_t length);
+
+	/**
+	 * This operation adds a label to the end of the table.
+	 * @param label the label
+	 */
+	void add(const std::string & label);
+
+	/**
+	 * This operation adds all of the labels of another table to the end of
+	 * this one.
+	 * @param other the other table
+	 */
+	void append(const LabelTable & other);
+
+	/**
+	 * This operation replaces all labels with a packed list of labels, as
+	 * stored in a snapshot file. Label i is the range
+	 * [labelOffsets[i], labelOffsets[i+1]) of the characters.
+	 * @param numLabels the number of labels
+	 * @param labelChars the characters of all of the labels
+	 * @param labelOffsets the offsets of the labels, numLabels + 1 of them
+	 */
+	void assign(int numLabels, const char * labelChars,
+			const std::uint64_t * labelOffsets);
+
+	/**
+	 * This operation replaces a label.
+	 * @param i the index of the label
+	 * @param label the first character of the new label
+	 * @param length the number of characters in the new label
+	 */
+	void set(int i, const char * label, std::size_t length);
+
+	/**
+	 * This operation returns a copy of a label.
+	 * @param i the index of the label
+	 * @return the label
+	 */
+	std::string get(int i) const;
+
+	/**
+	 * This operation returns the characters of a label in place. They are
+	 * not null terminated.
+	 * @param i the index of the label
+	 * @return the first character
+	 */
+	const char * data(int i) const;
+
+	/**
+	 * This operation returns the length of a label.
+	 * @param i the index of the label
+	 * @return the number of characters
+	 */
+	std::size_t length(int i) const;
+};
+
+} /* namespace planets */
+
+#endif /* LABELTABLE_H_ */
@@ -0,0 +1,74 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include "LeapfrogIntegrator.h"
+
+namespace planets {
+
+LeapfrogIntegrator::LeapfrogIntegrator(const PotentialSolver & forces) :
+		Integrator(forces) {
+
+}
+
+LeapfrogIntegrator::~LeapfrogIntegrator() {
+
+}
+
+void LeapfrogIntegrator::advance(BodySystem & system, double dt) {
+	int numBodies = system.size();
+	if (!accelerationsValid) {
+		computeAccelerations(system);
+	}
+
+	double * x = system.x(), * y = system.y(), * z = system.z();
+	double * vx = system.vx(), * vy = system.vy(), * vz = system.vz();
+	double halfDt = 0.5 * dt;
+
+	// Kick and drift
+	for (int i = 0; i < numBodies; i++) {
+		vx[i] += halfDt * ax[i];
+		vy[i] += halfDt * ay[i];
+		vz[i] += halfDt * az[i];
+		x[i] += dt * vx[i];
+		y[i] += dt * vy[i];
+		z[i] += dt * vz[i];
+	}
+
+	// Kick with the new accelerations, which are kept for the next step
+	computeAccelerations(system);
+	for (int i = 0; i < numBodies; i++) {
+		vx[i] += halfDt * ax[i];
+		vy[i] += halfDt * ay[i];
+		vz[i] += halfDt * az[i];
+	}
+}
+
+} /* namespace planets */
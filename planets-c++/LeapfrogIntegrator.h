@@ -0,0 +1,70 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef LEAPFROGINTEGRATOR_H_
+#define LEAPFROGINTEGRATOR_H_
+
+#include "Integrator.h"
+
+namespace planets {
+
+/**
+ * The LeapfrogIntegrator advances the system with the kick-drift-kick form
+ * of the leapfrog (velocity Verlet) scheme:
+ * v += a dt/2, x += v dt, a = a(x), v += a dt/2.
+ * It is second order and symplectic, so the energy error stays bounded
+ * over long runs instead of drifting. The accelerations at the end of a
+ * step are reused at the start of the next, so each step costs a single
+ * force evaluation.
+ */
+class LeapfrogIntegrator: public Integrator {
+
+protected:
+
+	virtual void advance(BodySystem & system, double dt);
+
+public:
+
+	/**
+	 * Constructor
+	 * @param forces the solver that computes the accelerations
+	 */
+	LeapfrogIntegrator(const PotentialSolver & forces);
+
+	/**
+	 * Destructor
+	 */
+	virtual ~LeapfrogIntegrator();
+};
+
+} /* namespace planets */
+
+#endif /* LEAPFROGINTEGRATOR_H_ */
@@ -0,0 +1,92 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include <algorithm>
+#include "MappedFile.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace planets {
+
+MappedFile::MappedFile(const std::string & fileName) :
+		contents(nullptr), length(0), discarded(0) {
+	int fd = open(fileName.c_str(), O_RDONLY);
+	if (fd < 0) {
+		throw "Unable to open file! Check path?";
+	}
+	struct stat status;
+	if (fstat(fd, &status) != 0) {
+		close(fd);
+		throw "Unable to read file size!";
+	}
+	length = status.st_size;
+	// Empty files can not be mapped, but there is nothing to read anyway.
+	if (length > 0) {
+		void * mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping == MAP_FAILED) {
+			close(fd);
+			throw "Unable to map file!";
+		}
+		// The file will be read front to back, so read ahead aggressively.
+		madvise(mapping, length, MADV_SEQUENTIAL);
+		contents = (const char *) mapping;
+	}
+	// The mapping stays valid after the file is closed.
+	close(fd);
+}
+
+MappedFile::~MappedFile() {
+	if (contents) {
+		munmap((void *) contents, length);
+	}
+}
+
+const char * MappedFile::data() const {
+	return contents;
+}
+
+std::size_t MappedFile::size() const {
+	return length;
+}
+
+void MappedFile::discard(std::size_t numBytes) {
+	std::size_t pageSize = sysconf(_SC_PAGESIZE);
+	numBytes = std::min(numBytes, length) / pageSize * pageSize;
+	if (contents && numBytes > discarded) {
+		madvise((void *) (contents + discarded), numBytes - discarded,
+				MADV_DONTNEED);
+		discarded = numBytes;
+	}
+}
+
+} /* namespace planets */
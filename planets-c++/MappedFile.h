@@ -0,0 +1,101 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef MAPPEDFILE_H_
+#define MAPPEDFILE_H_
+
+#include <string>
+#include <cstddef>
+
+namespace planets {
+
+/**
+ * A MappedFile maps the contents of a file into memory read-only. The
+ * contents can be read in place as one big array, without copying them
+ * into stream buffers or strings first. The mapping is released when the
+ * MappedFile is destroyed, so pointers into it must not outlive it.
+ */
+class MappedFile {
+
+	/// The start of the mapping, or null for an empty file
+	const char * contents;
+
+	/// The size of the file in bytes
+	std::size_t length;
+
+	/// The number of bytes from the start that have already been discarded
+	std::size_t discarded;
+
+public:
+
+	/**
+	 * Constructor. It throws an exception if the file cannot be opened.
+	 * @param fileName the name of the file
+	 */
+	MappedFile(const std::string & fileName);
+
+	/**
+	 * Destructor
+	 */
+	virtual ~MappedFile();
+
+	MappedFile(const MappedFile &) = delete;
+	MappedFile & operator=(const MappedFile &) = delete;
+
+	/**
+	 * This operation returns the contents of the file.
+	 * @return the first byte, or null if the file is empty
+	 */
+	const char * data() const;
+
+	/**
+	 * This operation returns the size of the file.
+	 * @return the size in bytes
+	 */
+	std::size_t size() const;
+
+	/**
+	 * This operation tells the operating system that the first bytes of the
+	 * file are not needed anymore, so that their pages can be dropped from
+	 * memory. They can still be read afterwards, but they will be read from
+	 * the disk again. This keeps the memory use of a single pass over a
+	 * large file bounded. Only the pages that were not discarded by an
+	 * earlier call are advised, so that a pass costs time linear in the
+	 * size of the file.
+	 * @param numBytes the number of bytes from the start of the file that
+	 * are done. Only whole pages are dropped.
+	 */
+	void discard(std::size_t numBytes);
+};
+
+} /* namespace planets */
+
+#endif /* MAPPEDFILE_H_ */
@@ -0,0 +1,516 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include "MixedPrecisionSolver.h"
+#include "Profiler.h"
+#include <math.h>
+#include <algorithm>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PLANETS_X86 1
+#endif
+
+namespace planets {
+
+namespace {
+
+/**
+ * The single precision copy of a system. The positions are relative to the
+ * centroid in units of the radius of the system and the masses are in units
+ * of the largest mass. The arrays are padded to a multiple of the widest
+ * vector with massless bodies far outside the system, so the kernels do not
+ * need remainder loops.
+ */
+struct FloatSystem {
+
+	/// The positions and masses
+	std::vector<float> x, y, z, m;
+
+	/// The number of real bodies
+	int numBodies;
+
+	/// The number of bodies including the padding
+	int numPadded;
+
+	/// The factor that turns the scaled sums back into m_j/r_ij in SI units
+	double scale;
+
+	/// The widest vector, in floats, that the padding supports
+	static const int width = 16;
+
+	FloatSystem(const BodySystem & system) :
+			numBodies(system.size()),
+			numPadded((system.size() + width - 1) / width * width),
+			scale(1.0) {
+		const double * sx = system.x();
+		const double * sy = system.y();
+		const double * sz = system.z();
+		const double * sm = system.m();
+
+		// Find the centroid, the radius and the largest mass
+		double cx = 0.0, cy = 0.0, cz = 0.0;
+		for (int i = 0; i < numBodies; i++) {
+			cx += sx[i];
+			cy += sy[i];
+			cz += sz[i];
+		}
+		if (numBodies > 0) {
+			cx /= numBodies;
+			cy /= numBodies;
+			cz /= numBodies;
+		}
+		double radius2 = 0.0, massScale = 0.0;
+		for (int i = 0; i < numBodies; i++) {
+			double dx = sx[i] - cx, dy = sy[i] - cy, dz = sz[i] - cz;
+			radius2 = std::max(radius2, dx * dx + dy * dy + dz * dz);
+			massScale = std::max(massScale, fabs(sm[i]));
+		}
+		double lengthScale = (radius2 > 0.0) ? sqrt(radius2) : 1.0;
+		massScale = (massScale > 0.0) ? massScale : 1.0;
+		scale = massScale / lengthScale;
+
+		// Scale and round the bodies. The padding sits at a distance of
+		// several radii, where it can not coincide with a real body.
+		x.assign(numPadded, 4.0f);
+		y.assign(numPadded, 4.0f);
+		z.assign(numPadded, 4.0f);
+		m.assign(numPadded, 0.0f);
+		for (int i = 0; i < numBodies; i++) {
+			x[i] = (float) ((sx[i] - cx) / lengthScale);
+			y[i] = (float) ((sy[i] - cy) / lengthScale);
+			z[i] = (float) ((sz[i] - cz) / lengthScale);
+			m[i] = (float) (sm[i] / massScale);
+		}
+	}
+};
+
+/**
+ * The scalar kernel. It sets sums[i] to the scaled sum m_j/r_ij over all
+ * j != i for the targets in [begin, end).
+ */
+template<AccumulationMode Mode>
+void scalarKernel(const FloatSystem & bodies, int begin, int end,
+		double * sums) {
+	const float * x = bodies.x.data(), * y = bodies.y.data(),
+			* z = bodies.z.data(), * m = bodies.m.data();
+	for (int i = begin; i < end; i++) {
+		float acc = 0.0f, comp = 0.0f;
+		double wide = 0.0;
+		for (int j = 0; j < bodies.numBodies; j++) {
+			if (j != i) {
+				float dx = x[i] - x[j];
+				float dy = y[i] - y[j];
+				float dz = z[i] - z[j];
+				float term = m[j] / sqrtf(dx * dx + dy * dy + dz * dz);
+				if constexpr (Mode == FloatAccumulation) {
+					acc += term;
+				} else if constexpr (Mode == CompensatedAccumulation) {
+					// Once the sum is not finite, there is nothing left to
+					// compensate and the update would only give a NaN
+					float corrected = term - comp;
+					float next = acc + corrected;
+					comp = isfinite(next) ? (next - acc) - corrected : 0.0f;
+					acc = next;
+				} else {
+					wide += term;
+				}
+			}
+		}
+		sums[i] = (double) acc - (double) comp + wide;
+	}
+}
+
+/**
+ * This operation adds up the lanes of the accumulators of a vector kernel
+ * in double precision. The compensations hold the part of each lane that is
+ * still missing, so they are subtracted.
+ */
+double reduceLanes(const float * acc, const float * comp, const double * wide,
+		int numLanes) {
+	double sum = 0.0;
+	for (int k = 0; k < numLanes; k++) {
+		sum += (double) acc[k] - (double) comp[k];
+	}
+	for (int k = 0; k < numLanes; k++) {
+		sum += wide[k];
+	}
+	return sum;
+}
+
+#ifdef PLANETS_X86
+
+/**
+ * The SSE2 kernel, which processes four source bodies at a time. The
+ * hardware reciprocal square root is good to 12 bits, so one Newton
+ * iteration reaches single precision.
+ */
+template<AccumulationMode Mode>
+__attribute__((target("sse2")))
+void sse2Kernel(const FloatSystem & bodies, int begin, int end,
+		double * sums) {
+	const float * x = bodies.x.data(), * y = bodies.y.data(),
+			* z = bodies.z.data(), * m = bodies.m.data();
+	const __m128 half = _mm_set1_ps(0.5f), threeHalves = _mm_set1_ps(1.5f),
+			zero = _mm_setzero_ps(), infinity = _mm_set1_ps(INFINITY);
+	const __m128i step = _mm_set1_epi32(4);
+	for (int i = begin; i < end; i++) {
+		__m128 xi = _mm_set1_ps(x[i]), yi = _mm_set1_ps(y[i]),
+				zi = _mm_set1_ps(z[i]);
+		__m128i self = _mm_set1_epi32(i), index = _mm_set_epi32(3, 2, 1, 0);
+		__m128 acc = _mm_setzero_ps(), comp = _mm_setzero_ps();
+		__m128d wideLow = _mm_setzero_pd(), wideHigh = _mm_setzero_pd();
+		for (int j = 0; j < bodies.numPadded; j += 4) {
+			__m128 dx = _mm_sub_ps(xi, _mm_loadu_ps(x + j));
+			__m128 dy = _mm_sub_ps(yi, _mm_loadu_ps(y + j));
+			__m128 dz = _mm_sub_ps(zi, _mm_loadu_ps(z + j));
+			__m128 r2 = _mm_add_ps(_mm_mul_ps(dx, dx),
+					_mm_add_ps(_mm_mul_ps(dy, dy), _mm_mul_ps(dz, dz)));
+			__m128 inv = _mm_rsqrt_ps(r2);
+			inv = _mm_mul_ps(inv, _mm_sub_ps(threeHalves,
+					_mm_mul_ps(_mm_mul_ps(half, r2), _mm_mul_ps(inv, inv))));
+			// Coincident bodies are infinitely close, like in the scalar
+			// kernel, instead of the NaN of the Newton iteration
+			__m128 coincident = _mm_cmpeq_ps(r2, zero);
+			inv = _mm_or_ps(_mm_and_ps(coincident, infinity),
+					_mm_andnot_ps(coincident, inv));
+			// Mask out the body itself
+			__m128 term = _mm_andnot_ps(
+					_mm_castsi128_ps(_mm_cmpeq_epi32(index, self)),
+					_mm_mul_ps(_mm_loadu_ps(m + j), inv));
+			if constexpr (Mode == FloatAccumulation) {
+				acc = _mm_add_ps(acc, term);
+			} else if constexpr (Mode == CompensatedAccumulation) {
+				// Lanes whose sum is not finite have nothing to compensate
+				__m128 corrected = _mm_sub_ps(term, comp);
+				__m128 next = _mm_add_ps(acc, corrected);
+				comp = _mm_and_ps(_mm_cmpeq_ps(_mm_sub_ps(next, next), zero),
+						_mm_sub_ps(_mm_sub_ps(next, acc), corrected));
+				acc = next;
+			} else {
+				wideLow = _mm_add_pd(wideLow, _mm_cvtps_pd(term));
+				wideHigh = _mm_add_pd(wideHigh,
+						_mm_cvtps_pd(_mm_movehl_ps(term, term)));
+			}
+			index = _mm_add_epi32(index, step);
+		}
+		float accLanes[4], compLanes[4];
+		double wideLanes[4];
+		_mm_storeu_ps(accLanes, acc);
+		_mm_storeu_ps(compLanes, comp);
+		_mm_storeu_pd(wideLanes, wideLow);
+		_mm_storeu_pd(wideLanes + 2, wideHigh);
+		sums[i] = reduceLanes(accLanes, compLanes, wideLanes, 4);
+	}
+}
+
+/**
+ * The AVX2 kernel, which processes eight source bodies at a time.
+ */
+template<AccumulationMode Mode>
+__attribute__((target("avx2,fma")))
+void avx2Kernel(const FloatSystem & bodies, int begin, int end,
+		double * sums) {
+	const float * x = bodies.x.data(), * y = bodies.y.data(),
+			* z = bodies.z.data(), * m = bodies.m.data();
+	const __m256 half = _mm256_set1_ps(0.5f),
+			threeHalves = _mm256_set1_ps(1.5f), zero = _mm256_setzero_ps(),
+			infinity = _mm256_set1_ps(INFINITY);
+	const __m256i step = _mm256_set1_epi32(8);
+	for (int i = begin; i < end; i++) {
+		__m256 xi = _mm256_set1_ps(x[i]), yi = _mm256_set1_ps(y[i]),
+				zi = _mm256_set1_ps(z[i]);
+		__m256i self = _mm256_set1_epi32(i),
+				index = _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+		__m256 acc = _mm256_setzero_ps(), comp = _mm256_setzero_ps();
+		__m256d wideLow = _mm256_setzero_pd(), wideHigh = _mm256_setzero_pd();
+		for (int j = 0; j < bodies.numPadded; j += 8) {
+			__m256 dx = _mm256_sub_ps(xi, _mm256_loadu_ps(x + j));
+			__m256 dy = _mm256_sub_ps(yi, _mm256_loadu_ps(y + j));
+			__m256 dz = _mm256_sub_ps(zi, _mm256_loadu_ps(z + j));
+			__m256 r2 = _mm256_fmadd_ps(dx, dx,
+					_mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dz, dz)));
+			__m256 inv = _mm256_rsqrt_ps(r2);
+			inv = _mm256_mul_ps(inv, _mm256_fnmadd_ps(
+					_mm256_mul_ps(half, r2), _mm256_mul_ps(inv, inv),
+					threeHalves));
+			// Coincident bodies are infinitely close, like in the scalar
+			// kernel, instead of the NaN of the Newton iteration
+			inv = _mm256_blendv_ps(inv, infinity,
+					_mm256_cmp_ps(r2, zero, _CMP_EQ_OQ));
+			// Mask out the body itself
+			__m256 term = _mm256_andnot_ps(
+					_mm256_castsi256_ps(_mm256_cmpeq_epi32(index, self)),
+					_mm256_mul_ps(_mm256_loadu_ps(m + j), inv));
+			if constexpr (Mode == FloatAccumulation) {
+				acc = _mm256_add_ps(acc, term);
+			} else if constexpr (Mode == CompensatedAccumulation) {
+				// Lanes whose sum is not finite have nothing to compensate
+				__m256 corrected = _mm256_sub_ps(term, comp);
+				__m256 next = _mm256_add_ps(acc, corrected);
+				comp = _mm256_and_ps(_mm256_cmp_ps(_mm256_sub_ps(next, next),
+						zero, _CMP_EQ_OQ),
+						_mm256_sub_ps(_mm256_sub_ps(next, acc), corrected));
+				acc = next;
+			} else {
+				wideLow = _mm256_add_pd(wideLow,
+						_mm256_cvtps_pd(_mm256_castps256_ps128(term)));
+				wideHigh = _mm256_add_pd(wideHigh,
+						_mm256_cvtps_pd(_mm256_extractf128_ps(term, 1)));
+			}
+			index = _mm256_add_epi32(index, step);
+		}
+		float accLanes[8], compLanes[8];
+		double wideLanes[8];
+		_mm256_storeu_ps(accLanes, acc);
+		_mm256_storeu_ps(compLanes, comp);
+		_mm256_storeu_pd(wideLanes, wideLow);
+		_mm256_storeu_pd(wideLanes + 4, wideHigh);
+		sums[i] = reduceLanes(accLanes, compLanes, wideLanes, 8);
+	}
+}
+
+/**
+ * The AVX-512 kernel, which processes sixteen source bodies at a time. The
+ * hardware reciprocal square root is good to 14 bits, so one Newton
+ * iteration reaches single precision.
+ */
+template<AccumulationMode Mode>
+__attribute__((target("avx512f")))
+void avx512Kernel(const FloatSystem & bodies, int begin, int end,
+		double * sums) {
+	const float * x = bodies.x.data(), * y = bodies.y.data(),
+			* z = bodies.z.data(), * m = bodies.m.data();
+	const __m512 half = _mm512_set1_ps(0.5f),
+			threeHalves = _mm512_set1_ps(1.5f), zero = _mm512_setzero_ps(),
+			infinity = _mm512_set1_ps(INFINITY);
+	const __m512i step = _mm512_set1_epi32(16);
+	for (int i = begin; i < end; i++) {
+		__m512 xi = _mm512_set1_ps(x[i]), yi = _mm512_set1_ps(y[i]),
+				zi = _mm512_set1_ps(z[i]);
+		__m512i self = _mm512_set1_epi32(i),
+				index = _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6,
+						5, 4, 3, 2, 1, 0);
+		__m512 acc = _mm512_setzero_ps(), comp = _mm512_setzero_ps();
+		__m512d wideLow = _mm512_setzero_pd(), wideHigh = _mm512_setzero_pd();
+		for (int j = 0; j < bodies.numPadded; j += 16) {
+			__m512 dx = _mm512_sub_ps(xi, _mm512_loadu_ps(x + j));
+			__m512 dy = _mm512_sub_ps(yi, _mm512_loadu_ps(y + j));
+			__m512 dz = _mm512_sub_ps(zi, _mm512_loadu_ps(z + j));
+			__m512 r2 = _mm512_fmadd_ps(dx, dx,
+					_mm512_fmadd_ps(dy, dy, _mm512_mul_ps(dz, dz)));
+			// Only keep the terms of bodies that are not the body itself
+			__mmask16 active = _mm512_cmpneq_epi32_mask(index, self);
+			__m512 inv = _mm512_maskz_rsqrt14_ps(active, r2);
+			inv = _mm512_mul_ps(inv, _mm512_fnmadd_ps(
+					_mm512_mul_ps(half, r2), _mm512_mul_ps(inv, inv),
+					threeHalves));
+			// Coincident bodies are infinitely close, like in the scalar
+			// kernel, instead of the NaN of the Newton iteration
+			inv = _mm512_mask_mov_ps(inv,
+					_mm512_mask_cmp_ps_mask(active, r2, zero, _CMP_EQ_OQ),
+					infinity);
+			__m512 term = _mm512_mul_ps(_mm512_loadu_ps(m + j), inv);
+			if constexpr (Mode == FloatAccumulation) {
+				acc = _mm512_add_ps(acc, term);
+			} else if constexpr (Mode == CompensatedAccumulation) {
+				// Lanes whose sum is not finite have nothing to compensate
+				__m512 corrected = _mm512_sub_ps(term, comp);
+				__m512 next = _mm512_add_ps(acc, corrected);
+				comp = _mm512_maskz_sub_ps(_mm512_cmp_ps_mask(
+						_mm512_sub_ps(next, next), zero, _CMP_EQ_OQ),
+						_mm512_sub_ps(next, acc), corrected);
+				acc = next;
+			} else {
+				// The masked forms keep GCC from warning about the
+				// undefined upper lanes of the unmasked intrinsics
+				__m512d bits = _mm512_castps_pd(term);
+				wideLow = _mm512_add_pd(wideLow, _mm512_maskz_cvtps_pd(0xFF,
+						_mm256_castpd_ps(
+								_mm512_maskz_extractf64x4_pd(0xF, bits, 0))));
+				wideHigh = _mm512_add_pd(wideHigh, _mm512_maskz_cvtps_pd(0xFF,
+						_mm256_castpd_ps(
+								_mm512_maskz_extractf64x4_pd(0xF, bits, 1))));
+			}
+			index = _mm512_add_epi32(index, step);
+		}
+		float accLanes[16], compLanes[16];
+		double wideLanes[16];
+		_mm512_storeu_ps(accLanes, acc);
+		_mm512_storeu_ps(compLanes, comp);
+		_mm512_storeu_pd(wideLanes, wideLow);
+		_mm512_storeu_pd(wideLanes + 8, wideHigh);
+		sums[i] = reduceLanes(accLanes, compLanes, wideLanes, 16);
+	}
+}
+
+#endif
+
+/**
+ * This operation sets the scaled sums of the targets in [begin, end) with
+ * the kernel for an instruction set and accumulation mode.
+ */
+template<AccumulationMode Mode>
+void sumPotentials(SIMDInstructionSet isa, const FloatSystem & bodies,
+		int begin, int end, double * sums) {
+	switch (isa) {
+#ifdef PLANETS_X86
+	case AVX512Instructions:
+		avx512Kernel<Mode>(bodies, begin, end, sums);
+		break;
+	case AVX2Instructions:
+		avx2Kernel<Mode>(bodies, begin, end, sums);
+		break;
+	case SSE2Instructions:
+		sse2Kernel<Mode>(bodies, begin, end, sums);
+		break;
+#endif
+	default:
+		scalarKernel<Mode>(bodies, begin, end, sums);
+	}
+}
+
+} /* anonymous namespace */
+
+MixedPrecisionSolver::MixedPrecisionSolver(AccumulationMode _mode) :
+		isa(SIMDSolver::detectInstructionSet()), mode(_mode),
+		verification(false), tolerance(1.0e-5), lastReport() {
+
+}
+
+MixedPrecisionSolver::MixedPrecisionSolver(SIMDInstructionSet _isa,
+		AccumulationMode _mode) :
+		isa(ScalarInstructions), mode(_mode), verification(false),
+		tolerance(1.0e-5), lastReport() {
+	instructionSet(_isa);
+}
+
+MixedPrecisionSolver::~MixedPrecisionSolver() {
+
+}
+
+const char * MixedPrecisionSolver::name(AccumulationMode _mode) {
+	const char * names[3] = { "float", "compensated", "double" };
+	return names[_mode];
+}
+
+SIMDInstructionSet MixedPrecisionSolver::instructionSet() const {
+	return isa;
+}
+
+void MixedPrecisionSolver::instructionSet(const SIMDInstructionSet & _isa) {
+	if (_isa > SIMDSolver::detectInstructionSet()) {
+		throw "Instruction set not supported by this processor!";
+	}
+	isa = _isa;
+}
+
+AccumulationMode MixedPrecisionSolver::accumulation() const {
+	return mode;
+}
+
+void MixedPrecisionSolver::accumulation(const AccumulationMode & _mode) {
+	mode = _mode;
+}
+
+void MixedPrecisionSolver::verify(bool _verify, double _tolerance) {
+	verification = _verify;
+	tolerance = _tolerance;
+}
+
+PrecisionReport MixedPrecisionSolver::report() const {
+	return lastReport;
+}
+
+std::vector<double> MixedPrecisionSolver::getPotentials(
+		const BodySystem & system) const {
+	PLANETS_TIMER("MixedPrecisionSolver::getPotentials");
+	int numBodies = system.size();
+	std::vector<double> potentials(numBodies);
+	PLANETS_COUNT(Interactions, (long) numBodies * (numBodies - 1));
+	FloatSystem bodies(system);
+	parallelFor(numBodies, blockSize(), [&](int begin, int end, int) {
+		switch (mode) {
+		case FloatAccumulation:
+			sumPotentials<FloatAccumulation>(isa, bodies, begin, end,
+					potentials.data());
+			break;
+		case CompensatedAccumulation:
+			sumPotentials<CompensatedAccumulation>(isa, bodies, begin, end,
+					potentials.data());
+			break;
+		default:
+			sumPotentials<DoubleAccumulation>(isa, bodies, begin, end,
+					potentials.data());
+		}
+	});
+	for (int i = 0; i < numBodies; i++) {
+		potentials[i] *= bodies.scale;
+	}
+
+	// Check the kernel against the fastest double precision kernel
+	if (verification) {
+		std::vector<double> reference(numBodies);
+		SIMDInstructionSet doubleISA = SIMDSolver::detectInstructionSet();
+		parallelFor(numBodies, blockSize(), [&](int begin, int end, int) {
+			SIMDSolver::sumPotentials(doubleISA, system, begin, end,
+					reference.data());
+		});
+		PrecisionReport newReport = { numBodies, 0.0, 0.0, -1 };
+		double sumSquares = 0.0;
+		for (int i = 0; i < numBodies; i++) {
+			if (reference[i] != potentials[i]) {
+				double error = fabs((potentials[i] - reference[i])
+						/ reference[i]);
+				sumSquares += error * error;
+				if (!(error <= newReport.maxError)) {
+					newReport.maxError = error;
+					newReport.worstBody = i;
+				}
+			}
+		}
+		newReport.rmsError = (numBodies > 0) ?
+				sqrt(sumSquares / numBodies) : 0.0;
+		lastReport = newReport;
+		if (!(newReport.maxError <= tolerance)) {
+			throw "Mixed precision potentials exceed the error tolerance!";
+		}
+	}
+
+	// Scale by G and M
+	const double * m = system.m();
+	for (int i = 0; i < numBodies; i++) {
+		potentials[i] *= -G * m[i];
+	}
+
+	return potentials;
+}
+
+} /* namespace planets */
@@ -0,0 +1,185 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef MIXEDPRECISIONSOLVER_H_
+#define MIXEDPRECISIONSOLVER_H_
+
+#include "SIMDSolver.h"
+
+namespace planets {
+
+/**
+ * The ways that the MixedPrecisionSolver can add up the terms m_j/r_ij of a
+ * potential. They are listed from fastest to most accurate.
+ */
+enum AccumulationMode {
+	FloatAccumulation,
+	CompensatedAccumulation,
+	DoubleAccumulation
+};
+
+/**
+ * The errors of a MixedPrecisionSolver relative to the double precision
+ * kernels, measured by a verified solve.
+ */
+struct PrecisionReport {
+
+	/// The number of bodies that were compared
+	int numBodies;
+
+	/// The largest relative error of any potential
+	double maxError;
+
+	/// The root mean square of the relative errors
+	double rmsError;
+
+	/// The index of the body with the largest error, or -1 if there is none
+	int worstBody;
+
+};
+
+/**
+ * The MixedPrecisionSolver computes the potentials by direct summation in
+ * single precision, which fits twice as many bodies in each vector as the
+ * SIMDSolver: 4 (SSE2), 8 (AVX2) or 16 (AVX-512). It is meant for screening
+ * and visualization runs that can live with relative errors of about 1e-6.
+ *
+ * Before the solve, the positions are moved to the centroid of the system
+ * and divided by its radius, and the masses are divided by the largest
+ * mass, so that the float copies can not overflow however large the system
+ * is. The distances and 1/r are then computed in float. How the terms are
+ * added up is picked with the accumulation mode:
+ * - FloatAccumulation adds them in float. It is the fastest, but the error
+ *   grows with the number of bodies.
+ * - CompensatedAccumulation adds them in float with Kahan summation, which
+ *   carries the rounding error of every addition into the next one and so
+ *   keeps the error of the sum at the level of the terms.
+ * - DoubleAccumulation converts the terms to double and adds them in
+ *   double.
+ *
+ * Like the SIMDSolver, the solver can verify every solve against the double
+ * precision kernels. The errors are then available as a PrecisionReport,
+ * and a solve that exceeds the tolerance throws an exception.
+ */
+class MixedPrecisionSolver: public PotentialSolver {
+
+	/// The instruction set used by the kernels
+	SIMDInstructionSet isa;
+
+	/// The way that the terms are added up
+	AccumulationMode mode;
+
+	/// True if every solve should be checked against the double kernels
+	bool verification;
+
+	/// The largest relative error that verification accepts
+	double tolerance;
+
+	/// The errors found by the last verified solve
+	mutable PrecisionReport lastReport;
+
+public:
+
+	/**
+	 * Constructor. The instruction set is detected automatically.
+	 * @param _mode the way that the terms are added up
+	 */
+	MixedPrecisionSolver(AccumulationMode _mode = CompensatedAccumulation);
+
+	/**
+	 * Constructor
+	 * @param _isa the instruction set to use, which must be supported
+	 * @param _mode the way that the terms are added up
+	 */
+	MixedPrecisionSolver(SIMDInstructionSet _isa,
+			AccumulationMode _mode = CompensatedAccumulation);
+
+	/**
+	 * Destructor
+	 */
+	virtual ~MixedPrecisionSolver();
+
+	/**
+	 * This operation returns a short name for an accumulation mode, such as
+	 * "compensated".
+	 * @param _mode the accumulation mode
+	 * @return the name
+	 */
+	static const char * name(AccumulationMode _mode);
+
+	/**
+	 * This operation returns the instruction set used by the kernels.
+	 * @return the instruction set
+	 */
+	SIMDInstructionSet instructionSet() const;
+
+	/**
+	 * This operation sets the instruction set used by the kernels. It throws
+	 * an exception if the processor does not support it.
+	 * @param _isa the new instruction set
+	 */
+	void instructionSet(const SIMDInstructionSet & _isa);
+
+	/**
+	 * This operation returns the way that the terms are added up.
+	 * @return the accumulation mode
+	 */
+	AccumulationMode accumulation() const;
+
+	/**
+	 * This operation sets the way that the terms are added up.
+	 * @param _mode the new accumulation mode
+	 */
+	void accumulation(const AccumulationMode & _mode);
+
+	/**
+	 * This operation turns verification against the double precision
+	 * kernels on or off. Verification costs a full double precision solve.
+	 * @param _verify true if solves should be verified
+	 * @param _tolerance the largest relative error that is accepted
+	 */
+	void verify(bool _verify, double _tolerance = 1.0e-5);
+
+	/**
+	 * This operation returns the errors found by the last verified solve.
+	 * @return the report, which is all zeros if no solve has been verified
+	 */
+	PrecisionReport report() const;
+
+	using PotentialSolver::getPotentials;
+
+	virtual std::vector<double> getPotentials(
+			const BodySystem & system) const;
+};
+
+} /* namespace planets */
+
+#endif /* MIXEDPRECISIONSOLVER_H_ */
@@ -0,0 +1,216 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include "Octree.h"
+#include <algorithm>
+
+namespace planets {
+
+Octree::Octree(const BodySystem & bodies, int leafSize) :
+		maxLeafSize(std::max(leafSize, 1)) {
+
+	int numBodies = bodies.size();
+	bodyOrder.resize(numBodies);
+	xs.assign(bodies.x(), bodies.x() + numBodies);
+	ys.assign(bodies.y(), bodies.y() + numBodies);
+	zs.assign(bodies.z(), bodies.z() + numBodies);
+	ms.resize(numBodies);
+
+	// Find the bounding box of the system
+	double lo[3] = {0.0, 0.0, 0.0}, hi[3] = {0.0, 0.0, 0.0};
+	for (int i = 0; i < numBodies; i++) {
+		bodyOrder[i] = i;
+		double pos[3] = {xs[i], ys[i], zs[i]};
+		for (int k = 0; k < 3; k++) {
+			if (i == 0 || pos[k] < lo[k]) lo[k] = pos[k];
+			if (i == 0 || pos[k] > hi[k]) hi[k] = pos[k];
+		}
+	}
+
+	// Make the root a cube that is just slightly bigger than the box so that
+	// no body sits exactly on its boundary.
+	OctreeNode root;
+	double width = std::max(hi[0] - lo[0],
+			std::max(hi[1] - lo[1], hi[2] - lo[2]));
+	root.halfWidth = (width > 0.0) ? 0.5 * width * (1.0 + 1.0e-12) : 1.0;
+	for (int k = 0; k < 3; k++) {
+		root.center[k] = 0.5 * (lo[k] + hi[k]);
+	}
+	root.begin = 0;
+	root.end = numBodies;
+	cells.push_back(root);
+
+	// Sort the bodies into the tree
+	std::vector<int> scratch(numBodies);
+	build(0, 0, scratch);
+
+	// Put the positions and masses into the sorted order
+	for (int i = 0; i < numBodies; i++) {
+		int body = bodyOrder[i];
+		xs[i] = bodies.x()[body];
+		ys[i] = bodies.y()[body];
+		zs[i] = bodies.z()[body];
+		ms[i] = bodies.m()[body];
+	}
+
+	// Now that the masses are in place, compute the mass moments from the
+	// leaves up. Children always come after their parents in the list.
+	for (int c = cells.size() - 1; c >= 0; c--) {
+		OctreeNode & cell = cells[c];
+		double mass = 0.0, mx = 0.0, my = 0.0, mz = 0.0;
+		if (cell.leaf) {
+			for (int i = cell.begin; i < cell.end; i++) {
+				mass += ms[i];
+				mx += ms[i] * xs[i];
+				my += ms[i] * ys[i];
+				mz += ms[i] * zs[i];
+			}
+		} else {
+			for (int k = 0; k < 8; k++) {
+				if (cell.child[k] >= 0) {
+					const OctreeNode & child = cells[cell.child[k]];
+					mass += child.mass;
+					mx += child.mass * child.com[0];
+					my += child.mass * child.com[1];
+					mz += child.mass * child.com[2];
+				}
+			}
+		}
+		cell.mass = mass;
+		// Massless cells are placed at their centers
+		if (mass != 0.0) {
+			cell.com[0] = mx / mass;
+			cell.com[1] = my / mass;
+			cell.com[2] = mz / mass;
+		} else {
+			cell.com[0] = cell.center[0];
+			cell.com[1] = cell.center[1];
+			cell.com[2] = cell.center[2];
+		}
+	}
+}
+
+Octree::~Octree() {
+
+}
+
+void Octree::build(int cellIndex, int depth, std::vector<int> & scratch) {
+
+	// Note: the cell is copied because the list may grow below.
+	OctreeNode cell = cells[cellIndex];
+	std::fill(cell.child, cell.child + 8, -1);
+	cell.leaf = (cell.end - cell.begin <= maxLeafSize) || depth >= maxDepth;
+	cells[cellIndex] = cell;
+	if (cell.leaf) {
+		return;
+	}
+
+	// Compute the octant of each body. Until the order is final the
+	// positions are stored by original index.
+	int counts[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+	for (int i = cell.begin; i < cell.end; i++) {
+		int body = bodyOrder[i];
+		int octant = (xs[body] >= cell.center[0] ? 1 : 0)
+				| (ys[body] >= cell.center[1] ? 2 : 0)
+				| (zs[body] >= cell.center[2] ? 4 : 0);
+		scratch[i] = octant;
+		counts[octant]++;
+	}
+
+	// Counting sort the bodies of this cell by octant
+	int offsets[9];
+	offsets[0] = cell.begin;
+	for (int k = 0; k < 8; k++) {
+		offsets[k + 1] = offsets[k] + counts[k];
+	}
+	std::vector<int> sorted(cell.end - cell.begin);
+	int next[8];
+	std::copy(offsets, offsets + 8, next);
+	for (int i = cell.begin; i < cell.end; i++) {
+		sorted[next[scratch[i]]++ - cell.begin] = bodyOrder[i];
+	}
+	std::copy(sorted.begin(), sorted.end(), bodyOrder.begin() + cell.begin);
+
+	// Create the children
+	double quarter = 0.5 * cell.halfWidth;
+	for (int k = 0; k < 8; k++) {
+		if (counts[k] == 0) {
+			continue;
+		}
+		OctreeNode child;
+		child.halfWidth = quarter;
+		child.center[0] = cell.center[0] + ((k & 1) ? quarter : -quarter);
+		child.center[1] = cell.center[1] + ((k & 2) ? quarter : -quarter);
+		child.center[2] = cell.center[2] + ((k & 4) ? quarter : -quarter);
+		child.begin = offsets[k];
+		child.end = offsets[k + 1];
+		cells[cellIndex].child[k] = cells.size();
+		cells.push_back(child);
+	}
+
+	// Split the children
+	for (int k = 0; k < 8; k++) {
+		int childIndex = cells[cellIndex].child[k];
+		if (childIndex >= 0) {
+			build(childIndex, depth + 1, scratch);
+		}
+	}
+}
+
+const std::vector<OctreeNode> & Octree::nodes() const {
+	return cells;
+}
+
+const std::vector<int> & Octree::order() const {
+	return bodyOrder;
+}
+
+const std::vector<double> & Octree::x() const {
+	return xs;
+}
+
+const std::vector<double> & Octree::y() const {
+	return ys;
+}
+
+const std::vector<double> & Octree::z() const {
+	return zs;
+}
+
+const std::vector<double> & Octree::m() const {
+	return ms;
+}
+
+int Octree::leafSize() const {
+	return maxLeafSize;
+}
+
+} /* namespace planets */
@@ -0,0 +1,162 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef OCTREE_H_
+#define OCTREE_H_
+
+#include <vector>
+#include "BodySystem.h"
+
+namespace planets {
+
+/**
+ * A single cell in an Octree. Cells are stored in a flat array and refer to
+ * their children and bodies by index so that the tree can be walked without
+ * chasing pointers.
+ */
+struct OctreeNode {
+
+	/// The geometric center of the cell
+	double center[3];
+
+	/// Half of the edge length of the (cubic) cell
+	double halfWidth;
+
+	/// The total mass of all bodies in the cell
+	double mass;
+
+	/// The center of mass of all bodies in the cell
+	double com[3];
+
+	/// The first body in the cell, as an index into the sorted body order
+	int begin;
+
+	/// One past the last body in the cell
+	int end;
+
+	/// The indices of the children in the node list, or -1 if empty
+	int child[8];
+
+	/// True if the cell has no children and its bodies are stored directly
+	bool leaf;
+
+};
+
+/**
+ * An Octree is a hierarchical subdivision of space into cubic cells that is
+ * used to accelerate the computation of long-range interactions between
+ * bodies. Cells are split into eight octants until they hold no more than
+ * leafSize bodies.
+ *
+ * The tree keeps its own copy of the positions and masses of the bodies,
+ * sorted so that the bodies of every cell are contiguous. This gives the
+ * solvers that walk the tree a compact, cache friendly layout instead of
+ * the full CelestialBody objects.
+ */
+class Octree {
+
+	/// The cells of the tree. The root is always the first cell.
+	std::vector<OctreeNode> cells;
+
+	/// The original index of the body stored at each sorted position
+	std::vector<int> bodyOrder;
+
+	/// Sorted x positions
+	std::vector<double> xs;
+
+	/// Sorted y positions
+	std::vector<double> ys;
+
+	/// Sorted z positions
+	std::vector<double> zs;
+
+	/// Sorted masses
+	std::vector<double> ms;
+
+	/// The maximum number of bodies in a leaf cell
+	int maxLeafSize;
+
+	/**
+	 * This operation recursively splits the cell at the given index and
+	 * computes its mass and center of mass.
+	 */
+	void build(int cellIndex, int depth, std::vector<int> & scratch);
+
+public:
+
+	/**
+	 * Constructor
+	 * @param bodies the bodies that should be sorted into the tree
+	 * @param leafSize the maximum number of bodies in a leaf cell
+	 */
+	Octree(const BodySystem & bodies, int leafSize = 8);
+
+	/**
+	 * Destructor
+	 */
+	virtual ~Octree();
+
+	/**
+	 * This operation returns the cells of the tree. The first cell is the
+	 * root.
+	 * @return the cells
+	 */
+	const std::vector<OctreeNode> & nodes() const;
+
+	/**
+	 * This operation returns the original index of the body at each sorted
+	 * position.
+	 * @return the ordering of the bodies in the tree
+	 */
+	const std::vector<int> & order() const;
+
+	/**
+	 * These operations return the sorted positions and masses of the bodies.
+	 */
+	const std::vector<double> & x() const;
+	const std::vector<double> & y() const;
+	const std::vector<double> & z() const;
+	const std::vector<double> & m() const;
+
+	/**
+	 * This operation returns the maximum number of bodies in a leaf.
+	 * @return the leaf size
+	 */
+	int leafSize() const;
+
+	/// The maximum depth of the tree, which bounds the work done for bodies
+	/// that sit on top of each other.
+	static const int maxDepth = 48;
+};
+
+} /* namespace planets */
+
+#endif /* OCTREE_H_ */
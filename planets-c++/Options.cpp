@@ -0,0 +1,112 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include <iterator>
+#include <algorithm>
+#include "Options.h"
+
+using namespace std;
+
+namespace planets {
+
+Options parseOptions(int argc, char * argv[]) {
+	Options options;
+	for (int k = 1; k < argc; k++) {
+		string option = argv[k];
+		if (option == "--profile") {
+			options.profile = true;
+			continue;
+		} else if (option == "--help") {
+			options.help = true;
+			continue;
+		} else if (option == "--error-report") {
+			options.errorReport = true;
+			continue;
+		}
+		if (k + 1 >= argc) {
+			throw "Missing option value!";
+		}
+		string value = argv[++k];
+		if (option == "--input") {
+			options.input = value;
+		} else if (option == "--output") {
+			options.output = value;
+		} else if (option == "--solver") {
+			options.solver = value;
+		} else if (option == "--threads") {
+			options.threads = parseNumber<int>(value);
+		} else if (option == "--theta") {
+			options.theta = parseNumber<double>(value);
+		} else if (option == "--precision") {
+			options.precision = parseNumber<int>(value);
+		} else if (option == "--format") {
+			if (value == "text") {
+				options.format = ResultsWriter::Text;
+			} else if (value == "csv") {
+				options.format = ResultsWriter::CSV;
+			} else if (value == "binary") {
+				options.format = ResultsWriter::Binary;
+			} else {
+				throw "Unknown output format!";
+			}
+		} else if (option == "--accumulation") {
+			const AccumulationMode modes[] = {FloatAccumulation,
+					CompensatedAccumulation, DoubleAccumulation};
+			auto mode = find_if(begin(modes), end(modes),
+					[&](AccumulationMode _mode) {
+						return value == MixedPrecisionSolver::name(_mode);
+					});
+			if (mode == end(modes)) {
+				throw "Unknown accumulation mode!";
+			}
+			options.accumulation = *mode;
+		} else if (option == "--trace") {
+			options.trace = value;
+		} else {
+			throw "Unknown option!";
+		}
+	}
+	if (options.threads < 0 || !(options.theta >= 0.0)
+			|| options.precision < 0 || options.precision > 17) {
+		throw "Invalid option value!";
+	}
+	const string solvers[] = {"direct", "simd", "mixed", "tiled", "tree",
+			"fmm"};
+	if (find(begin(solvers), end(solvers), options.solver) == end(solvers)) {
+		throw "Unknown solver!";
+	}
+	if (options.errorReport && options.solver != "mixed") {
+		throw "The error report needs the mixed solver!";
+	}
+	return options;
+}
+
+} /* namespace planets */
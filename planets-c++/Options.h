@@ -0,0 +1,101 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef OPTIONS_H_
+#define OPTIONS_H_
+
+#include <string>
+#include <charconv>
+#include "MixedPrecisionSolver.h"
+#include "ResultsWriter.h"
+
+namespace planets {
+
+/**
+ * The options of a run of planets-c++, with the defaults of the original
+ * sample.
+ */
+struct Options {
+	/// The input file. Files ending in .snap are read as snapshots.
+	std::string input = "planetary-system.csv";
+	/// The output file, or empty for standard output
+	std::string output;
+	/// The solver: direct, simd, mixed, tiled, tree or fmm
+	std::string solver = "direct";
+	/// How the mixed precision solver adds up the potentials
+	AccumulationMode accumulation = CompensatedAccumulation;
+	/// Whether to compare the mixed precision solver with double precision
+	bool errorReport = false;
+	/// The number of threads, or 0 for one per core
+	int threads = 1;
+	/// The opening angle of the tree and FMM solvers
+	double theta = 0.5;
+	/// The number of digits after the decimal point
+	int precision = 8;
+	/// The format of the output: text, csv or binary
+	ResultsWriter::Format format = ResultsWriter::Text;
+	/// Whether to print a profile at exit
+	bool profile = false;
+	/// The file for a Chrome trace, or empty for none
+	std::string trace;
+	/// Whether only the usage should be printed
+	bool help = false;
+};
+
+/**
+ * This operation parses the value of a numerical option. It throws an
+ * exception unless the whole value is a number of the right type.
+ * @param value the value
+ * @return the number
+ */
+template<typename T>
+T parseNumber(const std::string & value) {
+	T number = 0;
+	const char * end = value.data() + value.size();
+	auto result = std::from_chars(value.data(), end, number);
+	if (result.ec != std::errc() || result.ptr != end) {
+		throw "Invalid option value!";
+	}
+	return number;
+}
+
+/**
+ * This operation reads the options from the command line. It throws an
+ * exception if they are not valid.
+ * @param argc number of input arguments
+ * @param argv pointer to an array of input arguments
+ * @return the options
+ */
+Options parseOptions(int argc, char * argv[]);
+
+} /* namespace planets */
+
+#endif /* OPTIONS_H_ */
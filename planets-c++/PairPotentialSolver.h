@@ -0,0 +1,219 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef PAIRPOTENTIALSOLVER_H_
+#define PAIRPOTENTIALSOLVER_H_
+
+#include "PotentialSolver.h"
+#include "PotentialPolicies.h"
+#include "CellList.h"
+#include "Profiler.h"
+
+namespace planets {
+
+/**
+ * The PairPotentialSolver computes the potentials by summing a pair kernel
+ * over the pairs of bodies, like the DirectSolver, but the kernel, the range
+ * of the interactions and the gravitational constant are compile time
+ * policies from PotentialPolicies.h:
+ * - Softening is NoSoftening, PlummerSoftening or SplineSoftening.
+ * - Cutoff is NoCutoff, SharpCutoff or ShiftedCutoff.
+ * - Units is SIUnits, NBodyUnits, SolarUnits or GalacticUnits.
+ *
+ * Every combination is a separate instantiation, so the inner loops are
+ * compiled for exactly one kernel and have no branches on the choice. The
+ * parameters of the policies, like the softening length, are passed to the
+ * constructor.
+ *
+ * Without a cutoff, every pair is summed in O(N^2) and the result with
+ * NoSoftening and SIUnits is the same as the DirectSolver's. With a cutoff,
+ * the bodies are sorted into a CellList with cells as wide as the cutoff
+ * and each body only visits the 27 cells around its own, which is O(N) for
+ * a fixed density. Either way, every potential is computed by one thread in
+ * a fixed order, so the results do not depend on the number of threads.
+ */
+template<typename Softening = NoSoftening, typename Cutoff = NoCutoff,
+		typename Units = SIUnits>
+class PairPotentialSolver: public PotentialSolver {
+
+	/// The softening kernel
+	Softening softeningPolicy;
+
+	/// The range of the interactions
+	Cutoff cutoffPolicy;
+
+	/**
+	 * This operation sums the kernel over all pairs.
+	 */
+	void sumAll(const BodySystem & system, double * sums) const {
+		int numBodies = system.size();
+		const double * x = system.x();
+		const double * y = system.y();
+		const double * z = system.z();
+		const double * m = system.m();
+		PLANETS_COUNT(Interactions, (long) numBodies * (numBodies - 1));
+		parallelFor(numBodies, blockSize(), [&](int begin, int end, int) {
+			for (int i = begin; i < end; i++) {
+				double pot = 0.0;
+				for (int j = 0; j < numBodies; j++) {
+					if (j != i) {
+						double dx = x[i] - x[j];
+						double dy = y[i] - y[j];
+						double dz = z[i] - z[j];
+						pot += m[j] * softeningPolicy.inverse(
+								dx * dx + dy * dy + dz * dz);
+					}
+				}
+				sums[i] = pot;
+			}
+		});
+	}
+
+	/**
+	 * This operation sums the kernel over the pairs in neighboring cells
+	 * that are inside of the cutoff.
+	 */
+	void sumCells(const BodySystem & system, double * sums) const {
+		int numBodies = system.size();
+		CellList cells(system, cutoffPolicy.radius());
+		const int * indices = cells.indices();
+		const double * x = cells.x();
+		const double * y = cells.y();
+		const double * z = cells.z();
+		std::vector<double> sortedM(numBodies), sortedSums(numBodies);
+		for (int k = 0; k < numBodies; k++) {
+			sortedM[k] = system.m()[indices[k]];
+		}
+		const double * m = sortedM.data();
+		const double shift = cutoffPolicy.shift(softeningPolicy);
+
+		parallelFor(cells.cellCount(), 16, [&](int begin, int end, int) {
+			long numPairs = 0;
+			int neighborCells[27];
+			for (int c = begin; c < end; c++) {
+				int numNeighbors = cells.neighbors(c, neighborCells);
+				for (int a = cells.begin(c); a < cells.end(c); a++) {
+					double pot = 0.0;
+					for (int n = 0; n < numNeighbors; n++) {
+						int bEnd = cells.end(neighborCells[n]);
+						numPairs += bEnd - cells.begin(neighborCells[n]);
+						for (int b = cells.begin(neighborCells[n]); b < bEnd;
+								b++) {
+							double dx = x[a] - x[b];
+							double dy = y[a] - y[b];
+							double dz = z[a] - z[b];
+							double r2 = dx * dx + dy * dy + dz * dz;
+							if (b != a && cutoffPolicy.inside(r2)) {
+								pot += m[b]
+										* (softeningPolicy.inverse(r2) - shift);
+							}
+						}
+					}
+					sortedSums[a] = pot;
+				}
+			}
+			PLANETS_COUNT(Interactions, numPairs);
+		});
+
+		// Put the sums back into the order of the system
+		for (int k = 0; k < numBodies; k++) {
+			sums[indices[k]] = sortedSums[k];
+		}
+	}
+
+public:
+
+	/**
+	 * The gravitational constant of the unit system
+	 */
+	constexpr const static double G = Units::G;
+
+	/**
+	 * Constructor
+	 * @param _softening the softening kernel
+	 * @param _cutoff the range of the interactions
+	 */
+	PairPotentialSolver(const Softening & _softening = Softening(),
+			const Cutoff & _cutoff = Cutoff()) :
+			softeningPolicy(_softening), cutoffPolicy(_cutoff) {
+		if (!(cutoffPolicy.radius() > 0.0)) {
+			throw "The cutoff radius must be positive!";
+		}
+	}
+
+	/**
+	 * Destructor
+	 */
+	virtual ~PairPotentialSolver() {
+	}
+
+	/**
+	 * This operation returns the softening kernel.
+	 * @return the softening policy
+	 */
+	const Softening & softening() const {
+		return softeningPolicy;
+	}
+
+	/**
+	 * This operation returns the range of the interactions.
+	 * @return the cutoff policy
+	 */
+	const Cutoff & cutoff() const {
+		return cutoffPolicy;
+	}
+
+	using PotentialSolver::getPotentials;
+
+	virtual std::vector<double> getPotentials(
+			const BodySystem & system) const {
+		PLANETS_TIMER("PairPotentialSolver::getPotentials");
+		int numBodies = system.size();
+		std::vector<double> potentials(numBodies);
+		if constexpr (Cutoff::enabled) {
+			sumCells(system, potentials.data());
+		} else {
+			sumAll(system, potentials.data());
+		}
+
+		// Scale by G and M
+		const double * m = system.m();
+		for (int i = 0; i < numBodies; i++) {
+			potentials[i] *= -G * m[i];
+		}
+
+		return potentials;
+	}
+};
+
+} /* namespace planets */
+
+#endif /* PAIRPOTENTIALSOLVER_H_ */
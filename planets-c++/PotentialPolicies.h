@@ -0,0 +1,245 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef POTENTIALPOLICIES_H_
+#define POTENTIALPOLICIES_H_
+
+#include <math.h>
+#include <limits>
+
+namespace planets {
+
+/**
+ * This file holds the compile time policies of the PairPotentialSolver. A
+ * policy is a small class whose type picks a formula and whose members hold
+ * its parameters, so the choice is made when the solver is instantiated and
+ * the inner loop has no runtime branches on it.
+ *
+ * Softening policies replace 1/r with a kernel that stays finite when two
+ * bodies come close. They provide inverse(r2), the kernel as a function of
+ * the squared distance.
+ */
+
+/**
+ * The plain Newtonian kernel 1/r. Coincident bodies give infinite potentials,
+ * as they do in the DirectSolver.
+ */
+struct NoSoftening {
+
+	/**
+	 * This operation returns 1/r.
+	 * @param r2 the squared distance
+	 * @return the kernel
+	 */
+	double inverse(double r2) const {
+		return 1.0 / sqrt(r2);
+	}
+};
+
+/**
+ * Plummer softening, 1/sqrt(r^2 + epsilon^2), which treats every body as a
+ * Plummer sphere of scale length epsilon. It is simple and smooth, but it
+ * changes the potential at all distances, by a relative amount of about
+ * epsilon^2/(2 r^2).
+ */
+struct PlummerSoftening {
+
+	/// The squared softening length
+	double epsilon2;
+
+	/**
+	 * Constructor
+	 * @param epsilon the softening length
+	 */
+	PlummerSoftening(double epsilon = 0.0) :
+			epsilon2(epsilon * epsilon) {
+	}
+
+	/**
+	 * This operation returns the softened kernel.
+	 * @param r2 the squared distance
+	 * @return the kernel
+	 */
+	double inverse(double r2) const {
+		return 1.0 / sqrt(r2 + epsilon2);
+	}
+};
+
+/**
+ * Spline softening with the cubic spline kernel of Monaghan and Lattanzio,
+ * as used by GADGET. Each body is smoothed over a sphere of radius h and the
+ * kernel is exactly 1/r outside of it, so unlike Plummer softening it leaves
+ * distant pairs untouched. At r = 0 the kernel is 2.8/h. A spline with
+ * h = 2.8 epsilon has the same central potential as Plummer softening with
+ * epsilon.
+ */
+struct SplineSoftening {
+
+	/// The radius of the kernel and its inverse
+	double h, inverseH;
+
+	/**
+	 * Constructor
+	 * @param _h the radius of the kernel, which must be positive
+	 */
+	SplineSoftening(double _h) :
+			h(_h), inverseH(1.0 / _h) {
+	}
+
+	/**
+	 * This operation returns the softened kernel.
+	 * @param r2 the squared distance
+	 * @return the kernel
+	 */
+	double inverse(double r2) const {
+		double r = sqrt(r2), u = r * inverseH, u2 = u * u;
+		double inner = 2.8 - u2 * (16.0 / 3.0 + u2 * (-9.6 + 6.4 * u));
+		double outer = 3.2 - 1.0 / (15.0 * u) - u2 * (32.0 / 3.0
+				+ u * (-16.0 + u * (9.6 - 32.0 / 15.0 * u)));
+		return (u >= 1.0) ? 1.0 / r : ((u < 0.5) ? inner : outer) * inverseH;
+	}
+};
+
+/**
+ * Cutoff policies limit the interactions to pairs closer than a cutoff
+ * radius, for short-range work. The PairPotentialSolver finds the pairs with
+ * a CellList when the policy is enabled. A policy provides radius(), the
+ * cutoff radius, inside(r2), which tells whether a pair interacts, and
+ * shift(softening), which is subtracted from the kernel of every pair that
+ * interacts.
+ */
+
+/**
+ * No cutoff. Every pair interacts.
+ */
+struct NoCutoff {
+
+	/// Whether the policy limits the interactions
+	static constexpr bool enabled = false;
+
+	double radius() const {
+		return std::numeric_limits<double>::infinity();
+	}
+
+	bool inside(double) const {
+		return true;
+	}
+
+	template<typename Softening>
+	double shift(const Softening &) const {
+		return 0.0;
+	}
+};
+
+/**
+ * A sharp cutoff, which simply drops the pairs beyond the cutoff radius. The
+ * potential of a pair jumps at the cutoff.
+ */
+struct SharpCutoff {
+
+	/// Whether the policy limits the interactions
+	static constexpr bool enabled = true;
+
+	/// The cutoff radius and its square
+	double cutoff, cutoff2;
+
+	/**
+	 * Constructor
+	 * @param _cutoff the cutoff radius, which must be positive
+	 */
+	SharpCutoff(double _cutoff) :
+			cutoff(_cutoff), cutoff2(_cutoff * _cutoff) {
+	}
+
+	double radius() const {
+		return cutoff;
+	}
+
+	bool inside(double r2) const {
+		return r2 < cutoff2;
+	}
+
+	template<typename Softening>
+	double shift(const Softening &) const {
+		return 0.0;
+	}
+};
+
+/**
+ * A shifted cutoff, which drops the pairs beyond the cutoff radius and
+ * subtracts the kernel at the cutoff from all other pairs, so that the
+ * potential of a pair goes to zero continuously at the cutoff.
+ */
+struct ShiftedCutoff: SharpCutoff {
+
+	/**
+	 * Constructor
+	 * @param _cutoff the cutoff radius, which must be positive
+	 */
+	ShiftedCutoff(double _cutoff) :
+			SharpCutoff(_cutoff) {
+	}
+
+	template<typename Softening>
+	double shift(const Softening & softening) const {
+		return softening.inverse(cutoff2);
+	}
+};
+
+/**
+ * Unit policies pick the gravitational constant, and with it the units of
+ * the positions, masses and potentials.
+ */
+
+/// SI units: meters, kilograms and seconds, like the rest of the library
+struct SIUnits {
+	static constexpr double G = 6.67408e-11;
+};
+
+/// N-body (Henon) units, in which G = 1
+struct NBodyUnits {
+	static constexpr double G = 1.0;
+};
+
+/// Astronomical units, solar masses and years, in which G = 4 pi^2
+struct SolarUnits {
+	static constexpr double G = 4.0 * M_PI * M_PI;
+};
+
+/// Parsecs, solar masses and km/s, which are common for star clusters and
+/// galaxies
+struct GalacticUnits {
+	static constexpr double G = 4.300917270e-3;
+};
+
+} /* namespace planets */
+
+#endif /* POTENTIALPOLICIES_H_ */
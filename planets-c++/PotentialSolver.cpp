@@ -0,0 +1,85 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include "PotentialSolver.h"
+
+namespace planets {
+
+PotentialSolver::PotentialSolver() :
+		numThreads(1), targetBlockSize(256) {
+
+}
+
+PotentialSolver::~PotentialSolver() {
+
+}
+
+int PotentialSolver::threads() const {
+	return numThreads;
+}
+
+void PotentialSolver::threads(const int & _threads) {
+	pool = ThreadPool::create(_threads);
+	numThreads = pool ? pool->size() : 1;
+}
+
+int PotentialSolver::blockSize() const {
+	return targetBlockSize;
+}
+
+void PotentialSolver::blockSize(const int & _blockSize) {
+	targetBlockSize = (_blockSize > 0) ? _blockSize : 1;
+}
+
+void PotentialSolver::getAccelerations(const BodySystem & system,
+		double * ax, double * ay, double * az) const {
+	throw "This solver does not compute accelerations!";
+}
+
+void PotentialSolver::getAccelerations(const BodySystem & system,
+		const std::vector<int> & targets, double * ax, double * ay,
+		double * az) const {
+	int numBodies = system.size(), numTargets = targets.size();
+	std::vector<double> allX(numBodies), allY(numBodies), allZ(numBodies);
+	getAccelerations(system, allX.data(), allY.data(), allZ.data());
+	for (int k = 0; k < numTargets; k++) {
+		ax[k] = allX[targets[k]];
+		ay[k] = allY[targets[k]];
+		az[k] = allZ[targets[k]];
+	}
+}
+
+void PotentialSolver::parallelFor(int numItems, int blockSize,
+		const ThreadPool::LoopBody & body) const {
+	ThreadPool::parallelFor(pool, numItems, blockSize, body);
+}
+
+} /* namespace planets */
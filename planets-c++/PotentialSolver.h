@@ -0,0 +1,180 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef POTENTIALSOLVER_H_
+#define POTENTIALSOLVER_H_
+
+#include <vector>
+#include <memory>
+#include "BodySystem.h"
+#include "ThreadPool.h"
+
+namespace planets {
+
+/**
+ * This is an interface for classes that compute the gravitational potential
+ * of every body in a system. It realizes the suggestion on CelestialBody to
+ * delegate the potential computation to a separate class so that different
+ * algorithms - direct summation, trees, multipole methods - can be swapped
+ * in without changing the bodies.
+ *
+ * Unlike CelestialBody::getGravitationalPotential(), which is called once
+ * per body, solvers compute the potentials of the whole system in one call.
+ * This lets them share work between bodies, such as building a tree.
+ *
+ * Solvers work on the structure of arrays layout of BodySystem. Systems that
+ * are stored as a vector of CelestialBodies are converted before the solve.
+ *
+ * Solvers run on a single thread by default. With more threads, the target
+ * bodies are split into blocks that the threads claim dynamically. Every
+ * potential is still computed by exactly one thread in the same order, so
+ * the results do not depend on the number of threads. Copies of a solver
+ * share its ThreadPool, so they must not solve at the same time.
+ */
+class PotentialSolver {
+
+	/// The number of threads used by the solver
+	int numThreads;
+
+	/// The number of target bodies in a block of work
+	int targetBlockSize;
+
+	/// The threads used by the solver, or null for a single thread
+	std::shared_ptr<ThreadPool> pool;
+
+protected:
+
+	/**
+	 * This operation runs a loop over [0, numItems) in blocks of blockSize
+	 * items on the threads of the solver.
+	 * @param numItems the number of items
+	 * @param blockSize the number of items in a block
+	 * @param body the body of the loop
+	 */
+	void parallelFor(int numItems, int blockSize,
+			const ThreadPool::LoopBody & body) const;
+
+public:
+
+	/**
+	 * The gravitational constant in SI units (m^3 kg^-1 s^-2).
+	 */
+	constexpr const static double G = 6.67408e-11;
+
+	/**
+	 * Constructor
+	 */
+	PotentialSolver();
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~PotentialSolver();
+
+	/**
+	 * This operation returns the number of threads used by the solver.
+	 * @return the number of threads
+	 */
+	int threads() const;
+
+	/**
+	 * This operation sets the number of threads used by the solver.
+	 * @param _threads the number of threads, or 0 for one per core
+	 */
+	void threads(const int & _threads);
+
+	/**
+	 * This operation returns the number of target bodies in a block of work.
+	 * @return the block size
+	 */
+	int blockSize() const;
+
+	/**
+	 * This operation sets the number of target bodies in a block of work.
+	 * Blocks should be big enough to amortize claiming them, but small
+	 * enough to balance the load across the threads.
+	 * @param _blockSize the new block size
+	 */
+	void blockSize(const int & _blockSize);
+
+	/**
+	 * This operation computes the gravitational potential of every body in
+	 * the system with respect to all of the other bodies.
+	 * @param system the bodies that makeup the system
+	 * @return the potentials, in the same order as the bodies
+	 */
+	virtual std::vector<double> getPotentials(
+			const BodySystem & system) const = 0;
+
+	/**
+	 * This operation computes the gravitational potential of every body in
+	 * a list of bodies by converting them to a BodySystem first.
+	 * @param system the bodies that makeup the system
+	 * @return the potentials, in the same order as the bodies
+	 */
+	std::vector<double> getPotentials(
+			const std::vector<CelestialBody> & system) const {
+		return getPotentials(BodySystem(system));
+	}
+
+	/**
+	 * This operation computes the gravitational acceleration of every body
+	 * due to all of the other bodies, a_i = G sum_j m_j (r_j - r_i)/r_ij^3.
+	 * Solvers that can not compute accelerations throw an exception.
+	 * @param system the bodies that makeup the system
+	 * @param ax the x components of the accelerations, one per body
+	 * @param ay the y components of the accelerations, one per body
+	 * @param az the z components of the accelerations, one per body
+	 */
+	virtual void getAccelerations(const BodySystem & system, double * ax,
+			double * ay, double * az) const;
+
+	/**
+	 * This operation computes the gravitational accelerations of some of
+	 * the bodies due to all of the other bodies. It lets integrators with
+	 * individual time steps pay only for the bodies that need new forces.
+	 * The default implementation computes every acceleration and picks
+	 * out the targets.
+	 * @param system the bodies that makeup the system
+	 * @param targets the indices of the bodies whose accelerations should
+	 * be computed
+	 * @param ax the x components of the accelerations, one per target
+	 * @param ay the y components of the accelerations, one per target
+	 * @param az the z components of the accelerations, one per target
+	 */
+	virtual void getAccelerations(const BodySystem & system,
+			const std::vector<int> & targets, double * ax, double * ay,
+			double * az) const;
+};
+
+} /* namespace planets */
+
+#endif /* POTENTIALSOLVER_H_ */
@@ -0,0 +1,250 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include "Profiler.h"
+#include <map>
+#include <mutex>
+#include <memory>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+namespace planets {
+
+namespace {
+
+/// The events recorded by one thread
+struct ThreadLog {
+	int thread;
+	std::vector<Profiler::Event> events;
+};
+
+/// The time that all events are measured from
+const Profiler::Clock::time_point epoch = Profiler::Clock::now();
+
+/// The counters
+std::atomic<long> counters[Profiler::NumCounters];
+
+/// The logs of all threads that ever recorded an event, guarded by a mutex
+/// because threads add their logs when they first record
+std::mutex logsMutex;
+std::vector<std::unique_ptr<ThreadLog>> logs;
+
+/// The log of the calling thread
+thread_local ThreadLog * threadLog = nullptr;
+
+/**
+ * This function returns the log of the calling thread and creates it on
+ * first use.
+ */
+ThreadLog & getThreadLog() {
+	if (!threadLog) {
+		std::lock_guard<std::mutex> lock(logsMutex);
+		logs.emplace_back(new ThreadLog());
+		threadLog = logs.back().get();
+		threadLog->thread = logs.size() - 1;
+	}
+	return *threadLog;
+}
+
+/**
+ * This function returns the total length of a list of intervals, counting
+ * overlapping parts once. Nested events on a thread overlap completely.
+ */
+long coveredTime(std::vector<std::pair<long, long>> intervals) {
+	std::sort(intervals.begin(), intervals.end());
+	long total = 0, end = -1;
+	for (const auto & interval : intervals) {
+		long begin = std::max(interval.first, end);
+		if (interval.second > begin) {
+			total += interval.second - begin;
+			end = interval.second;
+		}
+	}
+	return total;
+}
+
+} /* anonymous namespace */
+
+std::atomic<bool> Profiler::isEnabled(false);
+
+void Profiler::enabled(const bool & _enabled) {
+	isEnabled.store(_enabled);
+}
+
+bool Profiler::compiled() {
+	return PLANETS_PROFILING;
+}
+
+void Profiler::count(Counter counter, long amount) {
+	if (enabled()) {
+		counters[counter].fetch_add(amount, std::memory_order_relaxed);
+	}
+}
+
+long Profiler::counter(Counter counter) {
+	return counters[counter].load();
+}
+
+const char * Profiler::name(Counter counter) {
+	static const char * names[NumCounters] = { "bytes read", "bodies parsed",
+			"interactions" };
+	return names[counter];
+}
+
+void Profiler::record(const char * name, Clock::time_point start,
+		Clock::time_point end) {
+	if (enabled()) {
+		ThreadLog & log = getThreadLog();
+		log.events.push_back({name, log.thread,
+				(long) std::chrono::nanoseconds(start - epoch).count(),
+				(long) std::chrono::nanoseconds(end - start).count()});
+	}
+}
+
+std::vector<Profiler::Event> Profiler::events() {
+	std::vector<Event> allEvents;
+	std::lock_guard<std::mutex> lock(logsMutex);
+	for (const auto & log : logs) {
+		allEvents.insert(allEvents.end(), log->events.begin(),
+				log->events.end());
+	}
+	std::stable_sort(allEvents.begin(), allEvents.end(),
+			[](const Event & a, const Event & b) {
+				return a.start < b.start;
+			});
+	return allEvents;
+}
+
+void Profiler::reset() {
+	std::lock_guard<std::mutex> lock(logsMutex);
+	for (auto & log : logs) {
+		log->events.clear();
+	}
+	for (auto & counter : counters) {
+		counter.store(0);
+	}
+}
+
+void Profiler::report(std::ostream & stream) {
+	auto allEvents = events();
+	std::ios::fmtflags flags = stream.flags();
+	std::streamsize precision = stream.precision();
+
+	stream << "Profile";
+	if (!compiled()) {
+		stream << " (profiling was compiled out)";
+	}
+	stream << std::endl;
+
+	// Sum the events by name
+	std::map<std::string, std::pair<long, long>> totals;
+	std::map<int, std::vector<std::pair<long, long>>> threadIntervals;
+	long first = allEvents.empty() ? 0 : allEvents.front().start, last = first;
+	for (const auto & event : allEvents) {
+		auto & total = totals[event.name];
+		total.first++;
+		total.second += event.duration;
+		threadIntervals[event.thread].push_back(
+				{event.start, event.start + event.duration});
+		last = std::max(last, event.start + event.duration);
+	}
+	stream << std::fixed << std::setprecision(6);
+	stream << "  " << std::left << std::setw(36) << "timer" << std::right
+			<< std::setw(10) << "calls" << std::setw(14) << "total (s)"
+			<< std::setw(14) << "mean (s)" << std::endl;
+	for (const auto & total : totals) {
+		stream << "  " << std::left << std::setw(36) << total.first
+				<< std::right << std::setw(10) << total.second.first
+				<< std::setw(14) << total.second.second * 1.0e-9
+				<< std::setw(14)
+				<< total.second.second * 1.0e-9 / total.second.first
+				<< std::endl;
+	}
+
+	// The counters
+	stream << "  counters" << std::endl;
+	for (int k = 0; k < NumCounters; k++) {
+		stream << "    " << std::left << std::setw(34) << name((Counter) k)
+				<< std::right << std::setw(24) << counter((Counter) k)
+				<< std::endl;
+	}
+
+	// The time that every thread spent inside of any event, compared to
+	// the time from the first event to the last
+	double span = (last - first) * 1.0e-9;
+	stream << "  thread busy time (s), of " << span << " s" << std::endl;
+	for (const auto & thread : threadIntervals) {
+		double busy = coveredTime(thread.second) * 1.0e-9;
+		stream << "    thread " << std::left << std::setw(27) << thread.first
+				<< std::right << std::setw(24) << busy << std::setw(8)
+				<< std::setprecision(1)
+				<< (span > 0.0 ? 100.0 * busy / span : 0.0) << " %"
+				<< std::setprecision(6) << std::endl;
+	}
+
+	stream.flags(flags);
+	stream.precision(precision);
+}
+
+void Profiler::writeTrace(const std::string & fileName) {
+	std::ofstream file(fileName.c_str());
+	if (!file.is_open()) {
+		throw "Unable to open trace file for writing!";
+	}
+	auto allEvents = events();
+
+	// Complete events carry their start and duration in microseconds
+	file << "{\"traceEvents\":[" << std::fixed << std::setprecision(3);
+	long last = 0;
+	for (size_t k = 0; k < allEvents.size(); k++) {
+		const Event & event = allEvents[k];
+		file << (k > 0 ? ",\n" : "\n") << "{\"name\":\"" << event.name
+				<< "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread
+				<< ",\"ts\":" << event.start * 1.0e-3 << ",\"dur\":"
+				<< event.duration * 1.0e-3 << "}";
+		last = std::max(last, event.start + event.duration);
+	}
+
+	// The counters are shown at the end of the trace
+	for (int k = 0; k < NumCounters; k++) {
+		file << (allEvents.empty() && k == 0 ? "\n" : ",\n") << "{\"name\":\""
+				<< name((Counter) k) << "\",\"ph\":\"C\",\"pid\":1,\"tid\":0,"
+				<< "\"ts\":" << last * 1.0e-3 << ",\"args\":{\"value\":"
+				<< counter((Counter) k) << "}}";
+	}
+	file << "\n]}\n";
+	if (!file.good()) {
+		throw "Unable to write trace file!";
+	}
+}
+
+} /* namespace planets */
@@ -0,0 +1,238 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <ostream>
+
+/**
+ * Profiling is compiled in unless PLANETS_PROFILING is defined to 0, for
+ * example with make PROFILING=0. When it is compiled out, the
+ * PLANETS_TIMER and PLANETS_COUNT macros do nothing at all.
+ */
+#ifndef PLANETS_PROFILING
+#define PLANETS_PROFILING 1
+#endif
+
+#define PLANETS_CONCAT_(a, b) a##b
+#define PLANETS_CONCAT(a, b) PLANETS_CONCAT_(a, b)
+
+#if PLANETS_PROFILING
+/// Times the rest of the enclosing scope under the given name
+#define PLANETS_TIMER(name) \
+	planets::ScopedTimer PLANETS_CONCAT(planetsTimer, __LINE__)(name)
+/// Adds n to one of the Profiler::Counter counters
+#define PLANETS_COUNT(counter, n) \
+	planets::Profiler::count(planets::Profiler::counter, n)
+#else
+#define PLANETS_TIMER(name)
+#define PLANETS_COUNT(counter, n) ((void) (n))
+#endif
+
+namespace planets {
+
+/**
+ * The Profiler collects timed events and counters from the hot paths of
+ * the code: parsing, potential evaluation and output. It is off until it
+ * is enabled, and a timer that runs while it is off costs one relaxed
+ * atomic load.
+ *
+ * Every thread records its events into its own log without locking, so
+ * the timers can be used inside of parallel loops. The logs must only be
+ * read, by report(), writeTrace() or events(), when no other thread is
+ * recording.
+ */
+class Profiler {
+
+	/// Whether the profiler records anything
+	static std::atomic<bool> isEnabled;
+
+public:
+
+	/**
+	 * The counters
+	 */
+	enum Counter {
+		/// The number of bytes read from input files
+		BytesRead,
+		/// The number of bodies read from input files
+		BodiesParsed,
+		/// The number of pairwise interactions evaluated by the solvers
+		Interactions,
+		NumCounters
+	};
+
+	/**
+	 * A timed event
+	 */
+	struct Event {
+		/// The name of the event, which must be a string literal
+		const char * name;
+		/// The thread that recorded the event, numbered from 0 in the order
+		/// that threads first recorded an event
+		int thread;
+		/// The start of the event in nanoseconds since the program started
+		long start;
+		/// The duration of the event in nanoseconds
+		long duration;
+	};
+
+	/// The clock used for timing
+	typedef std::chrono::steady_clock Clock;
+
+	/**
+	 * This operation returns whether the profiler records anything.
+	 * @return true if it is enabled
+	 */
+	static bool enabled() {
+		return isEnabled.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * This operation turns the profiler on or off.
+	 * @param _enabled true to record events and counters
+	 */
+	static void enabled(const bool & _enabled);
+
+	/**
+	 * This operation returns whether profiling was compiled in.
+	 * @return true if the macros record anything
+	 */
+	static bool compiled();
+
+	/**
+	 * This operation adds to a counter if the profiler is enabled.
+	 * @param counter the counter
+	 * @param amount the amount to add
+	 */
+	static void count(Counter counter, long amount);
+
+	/**
+	 * This operation returns the value of a counter.
+	 * @param counter the counter
+	 * @return the value
+	 */
+	static long counter(Counter counter);
+
+	/**
+	 * This operation returns the name of a counter.
+	 * @param counter the counter
+	 * @return the name
+	 */
+	static const char * name(Counter counter);
+
+	/**
+	 * This operation records an event on the calling thread if the
+	 * profiler is enabled.
+	 * @param name the name of the event, which must be a string literal
+	 * @param start the time the event started
+	 * @param end the time the event ended
+	 */
+	static void record(const char * name, Clock::time_point start,
+			Clock::time_point end);
+
+	/**
+	 * This operation returns the events of all threads, sorted by start.
+	 * @return the events
+	 */
+	static std::vector<Event> events();
+
+	/**
+	 * This operation clears all events and counters.
+	 */
+	static void reset();
+
+	/**
+	 * This operation writes a report of the total time and number of calls
+	 * of every kind of event, the counters and the busy time of every
+	 * thread.
+	 * @param stream the stream to write to
+	 */
+	static void report(std::ostream & stream);
+
+	/**
+	 * This operation writes the events and counters to a file in the
+	 * Chrome trace event format, which chrome://tracing and Perfetto can
+	 * display. It throws an exception if the file can not be written.
+	 * @param fileName the name of the file
+	 */
+	static void writeTrace(const std::string & fileName);
+};
+
+/**
+ * A ScopedTimer records an event from its construction to its destruction.
+ * It is normally created by the PLANETS_TIMER macro.
+ */
+class ScopedTimer {
+
+	/// The name of the event
+	const char * name;
+
+	/// Whether the profiler was enabled when the timer started
+	bool active;
+
+	/// The start of the event
+	Profiler::Clock::time_point start;
+
+public:
+
+	/**
+	 * Constructor
+	 * @param _name the name of the event, which must be a string literal
+	 */
+	ScopedTimer(const char * _name) :
+			name(_name), active(Profiler::enabled()) {
+		if (active) {
+			start = Profiler::Clock::now();
+		}
+	}
+
+	/**
+	 * Destructor
+	 */
+	~ScopedTimer() {
+		if (active) {
+			Profiler::record(name, start, Profiler::Clock::now());
+		}
+	}
+
+	ScopedTimer(const ScopedTimer &) = delete;
+	ScopedTimer & operator=(const ScopedTimer &) = delete;
+};
+
+} /* namespace planets */
+
+#endif /* PROFILER_H_ */
@@ -0,0 +1,187 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include "ResultsWriter.h"
+#include <cstring>
+#include <charconv>
+#include <cerrno>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace planets {
+
+namespace {
+
+/// The magic string at the start of binary results
+const char magic[8] = { 'P', 'L', 'A', 'N', 'P', 'O', 'T', '\0' };
+
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "Binary results are only supported on little-endian processors."
+#endif
+
+/// The longest double in fixed notation, without the digits after the
+/// decimal point: a sign, 309 digits and the decimal point
+const std::size_t maxFixedChars = 311;
+
+} /* anonymous namespace */
+
+ResultsWriter::ResultsWriter(const std::string & fileName, Format format,
+		int precision, std::size_t bufferSize) :
+		fd(STDOUT_FILENO), ownsFile(false), outputFormat(format),
+		numDigits(std::min(std::max(precision, 0), 17)),
+		buffer(std::max(bufferSize, (std::size_t) 4096)), used(0) {
+	if (!fileName.empty()) {
+		fd = open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (fd < 0) {
+			throw "Unable to open results file for writing!";
+		}
+		ownsFile = true;
+	}
+}
+
+ResultsWriter::~ResultsWriter() {
+	try {
+		close();
+	} catch (const char *) {
+		// Errors are reported by close()
+	}
+}
+
+ResultsWriter::Format ResultsWriter::format() const {
+	return outputFormat;
+}
+
+int ResultsWriter::precision() const {
+	return numDigits;
+}
+
+void ResultsWriter::writeAll(const char * bytes, std::size_t numBytes) {
+	while (numBytes > 0) {
+		ssize_t written = ::write(fd, bytes, numBytes);
+		if (written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			throw "Unable to write results!";
+		}
+		bytes += written;
+		numBytes -= written;
+	}
+}
+
+void ResultsWriter::reserve(std::size_t numBytes) {
+	if (used + numBytes > buffer.size()) {
+		flush();
+		if (numBytes > buffer.size()) {
+			buffer.resize(numBytes);
+		}
+	}
+}
+
+void ResultsWriter::flush() {
+	if (used > 0) {
+		std::size_t numBytes = used;
+		used = 0;
+		writeAll(buffer.data(), numBytes);
+	}
+}
+
+void ResultsWriter::close() {
+	if (fd < 0) {
+		return;
+	}
+	flush();
+	if (ownsFile) {
+		int result = ::close(fd);
+		fd = -1;
+		if (result != 0) {
+			throw "Unable to write results!";
+		}
+	}
+	fd = -1;
+}
+
+void ResultsWriter::write(const BodySystem & bodies,
+		const std::vector<double> & potentials) {
+	if (fd < 0) {
+		throw "The results file is closed!";
+	}
+	std::size_t numBodies = bodies.size();
+	if (potentials.size() != numBodies) {
+		throw "There must be one potential per body!";
+	}
+
+	// Binary results are copied straight from the potentials
+	if (outputFormat == Binary) {
+		std::uint64_t count = numBodies;
+		reserve(sizeof(magic) + sizeof(count));
+		memcpy(buffer.data() + used, magic, sizeof(magic));
+		memcpy(buffer.data() + used + sizeof(magic), &count, sizeof(count));
+		used += sizeof(magic) + sizeof(count);
+		flush();
+		writeAll((const char *) potentials.data(),
+				numBodies * sizeof(double));
+		return;
+	}
+
+	// Format every line in place in the buffer
+	const char * separator = (outputFormat == CSV) ? "," : ", potential = ";
+	std::size_t separatorLength = strlen(separator);
+	if (outputFormat == CSV) {
+		write(std::string("label,potential\n"));
+	}
+	const LabelTable & labels = bodies.labels();
+	for (std::size_t i = 0; i < numBodies; i++) {
+		std::size_t labelLength = labels.length(i);
+		reserve(labelLength + separatorLength + maxFixedChars + numDigits + 1);
+		char * line = buffer.data() + used;
+		memcpy(line, labels.data(i), labelLength);
+		line += labelLength;
+		memcpy(line, separator, separatorLength);
+		line += separatorLength;
+		line = std::to_chars(line, buffer.data() + buffer.size(),
+				potentials[i], std::chars_format::fixed, numDigits).ptr;
+		*line++ = '\n';
+		used = line - buffer.data();
+	}
+}
+
+void ResultsWriter::write(const std::string & text) {
+	if (fd < 0) {
+		throw "The results file is closed!";
+	}
+	reserve(text.size());
+	memcpy(buffer.data() + used, text.data(), text.size());
+	used += text.size();
+}
+
+} /* namespace planets */
@@ -0,0 +1,164 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef RESULTSWRITER_H_
+#define RESULTSWRITER_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "BodySystem.h"
+
+namespace planets {
+
+/**
+ * A ResultsWriter writes the potentials of a system to a file or to
+ * standard output. Numbers are formatted with std::to_chars into a large
+ * buffer, which is handed to the operating system with one write call
+ * whenever it is full, so writing millions of results costs about as much
+ * as formatting them. Nothing is flushed per line.
+ *
+ * There are three formats:
+ * - Text: "label, potential = value" per body, like the original sample.
+ * - CSV: a "label,potential" header followed by one line per body.
+ * - Binary: the magic string "PLANPOT" with a terminating zero, the number
+ * of bodies as a little-endian 64-bit integer and then the potentials as
+ * little-endian doubles, in the order of the bodies. Values are not
+ * rounded, and the labels are left to the input file.
+ */
+class ResultsWriter {
+
+public:
+
+	/**
+	 * The output formats
+	 */
+	enum Format {
+		Text,
+		CSV,
+		Binary
+	};
+
+private:
+
+	/// The file descriptor, which is standard output for an empty name
+	int fd;
+
+	/// Whether the writer opened the file and has to close it
+	bool ownsFile;
+
+	/// The output format
+	Format outputFormat;
+
+	/// The number of digits after the decimal point of text and CSV
+	int numDigits;
+
+	/// The buffer and the number of bytes in it
+	std::vector<char> buffer;
+	std::size_t used;
+
+	/**
+	 * This operation makes room for a number of bytes at the end of the
+	 * buffer, flushing it first if they do not fit.
+	 */
+	void reserve(std::size_t numBytes);
+
+	/**
+	 * This operation writes bytes directly to the file.
+	 */
+	void writeAll(const char * bytes, std::size_t numBytes);
+
+public:
+
+	/**
+	 * Constructor. It throws an exception if the file can not be opened.
+	 * @param fileName the name of the output file, or an empty string for
+	 * standard output
+	 * @param format the output format
+	 * @param precision the number of digits after the decimal point in the
+	 * text and CSV formats
+	 * @param bufferSize the size of the buffer in bytes
+	 */
+	ResultsWriter(const std::string & fileName, Format format = Text,
+			int precision = 8, std::size_t bufferSize = 1 << 20);
+
+	/**
+	 * Destructor. It flushes the buffer, but ignores errors, so close()
+	 * should be called to find out whether everything was written.
+	 */
+	virtual ~ResultsWriter();
+
+	ResultsWriter(const ResultsWriter &) = delete;
+	ResultsWriter & operator=(const ResultsWriter &) = delete;
+
+	/**
+	 * This operation returns the output format.
+	 * @return the format
+	 */
+	Format format() const;
+
+	/**
+	 * This operation returns the number of digits after the decimal point.
+	 * @return the precision
+	 */
+	int precision() const;
+
+	/**
+	 * This operation writes the potentials of all bodies.
+	 * @param bodies the bodies, which provide the labels
+	 * @param potentials the potentials, one per body
+	 */
+	void write(const BodySystem & bodies,
+			const std::vector<double> & potentials);
+
+	/**
+	 * This operation writes text as it is, for example a summary after the
+	 * results of the text format.
+	 * @param text the text
+	 */
+	void write(const std::string & text);
+
+	/**
+	 * This operation writes out the buffer. It throws an exception if the
+	 * write fails.
+	 */
+	void flush();
+
+	/**
+	 * This operation flushes the buffer and closes the file. It throws an
+	 * exception if anything could not be written.
+	 */
+	void close();
+};
+
+} /* namespace planets */
+
+#endif /* RESULTSWRITER_H_ */
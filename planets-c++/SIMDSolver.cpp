@@ -0,0 +1,385 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include "SIMDSolver.h"
+#include "Profiler.h"
+#include <math.h>
+#include <algorithm>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PLANETS_X86 1
+#endif
+
+namespace planets {
+
+namespace {
+
+/**
+ * The scalar kernel, which is the same computation as direct summation.
+ */
+void scalarKernel(const double * x, const double * y, const double * z,
+		const double * m, int begin, int end, int jBegin, int jEnd,
+		double * sums) {
+	for (int i = begin; i < end; i++) {
+		double pot = 0.0;
+		for (int j = jBegin; j < jEnd; j++) {
+			if (j != i) {
+				double dx = x[i] - x[j];
+				double dy = y[i] - y[j];
+				double dz = z[i] - z[j];
+				pot += m[j] / sqrt(dx * dx + dy * dy + dz * dz);
+			}
+		}
+		sums[i] += pot;
+	}
+}
+
+#ifdef PLANETS_X86
+
+/// Magic constant for the initial guess of 1/sqrt(x) for doubles. The guess
+/// is good to about 3.4%, so four Newton iterations reach full precision.
+const long long rsqrtMagic = 0x5FE6EB50C7B537A9LL;
+
+/**
+ * The SSE2 kernel, which processes two source bodies at a time.
+ */
+__attribute__((target("sse2")))
+void sse2Kernel(const double * x, const double * y, const double * z,
+		const double * m, int begin, int end, int jBegin, int jEnd,
+		double * sums) {
+	const __m128d half = _mm_set1_pd(0.5), threeHalves = _mm_set1_pd(1.5);
+	const __m128i magic = _mm_set1_epi64x(rsqrtMagic);
+	const __m128d zero = _mm_setzero_pd(), infinity = _mm_set1_pd(INFINITY);
+	int vectorEnd = jEnd - (jEnd - jBegin) % 2;
+	for (int i = begin; i < end; i++) {
+		__m128d xi = _mm_set1_pd(x[i]), yi = _mm_set1_pd(y[i]),
+				zi = _mm_set1_pd(z[i]), self = _mm_set1_pd((double) i);
+		__m128d index = _mm_set_pd(jBegin + 1.0, jBegin),
+				step = _mm_set1_pd(2.0);
+		__m128d acc = _mm_setzero_pd();
+		for (int j = jBegin; j < vectorEnd; j += 2) {
+			__m128d dx = _mm_sub_pd(xi, _mm_loadu_pd(x + j));
+			__m128d dy = _mm_sub_pd(yi, _mm_loadu_pd(y + j));
+			__m128d dz = _mm_sub_pd(zi, _mm_loadu_pd(z + j));
+			__m128d r2 = _mm_add_pd(_mm_mul_pd(dx, dx),
+					_mm_add_pd(_mm_mul_pd(dy, dy), _mm_mul_pd(dz, dz)));
+			// Guess 1/r from the bits of r^2 and refine it
+			__m128d inv = _mm_castsi128_pd(_mm_sub_epi64(magic,
+					_mm_srli_epi64(_mm_castpd_si128(r2), 1)));
+			__m128d halfR2 = _mm_mul_pd(half, r2);
+			for (int k = 0; k < 4; k++) {
+				inv = _mm_mul_pd(inv, _mm_sub_pd(threeHalves,
+						_mm_mul_pd(halfR2, _mm_mul_pd(inv, inv))));
+			}
+			// Coincident bodies are infinitely close, like in the scalar
+			// kernel, instead of the NaN of the Newton iterations
+			__m128d coincident = _mm_cmpeq_pd(r2, zero);
+			inv = _mm_or_pd(_mm_and_pd(coincident, infinity),
+					_mm_andnot_pd(coincident, inv));
+			// Mask out the body itself
+			inv = _mm_andnot_pd(_mm_cmpeq_pd(index, self), inv);
+			acc = _mm_add_pd(acc, _mm_mul_pd(_mm_loadu_pd(m + j), inv));
+			index = _mm_add_pd(index, step);
+		}
+		double lanes[2];
+		_mm_storeu_pd(lanes, acc);
+		double pot = lanes[0] + lanes[1];
+		for (int j = vectorEnd; j < jEnd; j++) {
+			if (j != i) {
+				double dx = x[i] - x[j];
+				double dy = y[i] - y[j];
+				double dz = z[i] - z[j];
+				pot += m[j] / sqrt(dx * dx + dy * dy + dz * dz);
+			}
+		}
+		sums[i] += pot;
+	}
+}
+
+/**
+ * The AVX2 kernel, which processes four source bodies at a time.
+ */
+__attribute__((target("avx2,fma")))
+void avx2Kernel(const double * x, const double * y, const double * z,
+		const double * m, int begin, int end, int jBegin, int jEnd,
+		double * sums) {
+	const __m256d half = _mm256_set1_pd(0.5),
+			threeHalves = _mm256_set1_pd(1.5);
+	const __m256i magic = _mm256_set1_epi64x(rsqrtMagic);
+	const __m256d zero = _mm256_setzero_pd(),
+			infinity = _mm256_set1_pd(INFINITY);
+	int vectorEnd = jEnd - (jEnd - jBegin) % 4;
+	for (int i = begin; i < end; i++) {
+		__m256d xi = _mm256_set1_pd(x[i]), yi = _mm256_set1_pd(y[i]),
+				zi = _mm256_set1_pd(z[i]), self = _mm256_set1_pd((double) i);
+		__m256d index = _mm256_set_pd(jBegin + 3.0, jBegin + 2.0,
+				jBegin + 1.0, jBegin), step = _mm256_set1_pd(4.0);
+		__m256d acc = _mm256_setzero_pd();
+		for (int j = jBegin; j < vectorEnd; j += 4) {
+			__m256d dx = _mm256_sub_pd(xi, _mm256_loadu_pd(x + j));
+			__m256d dy = _mm256_sub_pd(yi, _mm256_loadu_pd(y + j));
+			__m256d dz = _mm256_sub_pd(zi, _mm256_loadu_pd(z + j));
+			__m256d r2 = _mm256_fmadd_pd(dx, dx,
+					_mm256_fmadd_pd(dy, dy, _mm256_mul_pd(dz, dz)));
+			// Guess 1/r from the bits of r^2 and refine it
+			__m256d inv = _mm256_castsi256_pd(_mm256_sub_epi64(magic,
+					_mm256_srli_epi64(_mm256_castpd_si256(r2), 1)));
+			__m256d halfR2 = _mm256_mul_pd(half, r2);
+			for (int k = 0; k < 4; k++) {
+				inv = _mm256_mul_pd(inv, _mm256_fnmadd_pd(halfR2,
+						_mm256_mul_pd(inv, inv), threeHalves));
+			}
+			// Coincident bodies are infinitely close, like in the scalar
+			// kernel, instead of the NaN of the Newton iterations
+			inv = _mm256_blendv_pd(inv, infinity,
+					_mm256_cmp_pd(r2, zero, _CMP_EQ_OQ));
+			// Mask out the body itself
+			inv = _mm256_andnot_pd(_mm256_cmp_pd(index, self, _CMP_EQ_OQ),
+					inv);
+			acc = _mm256_fmadd_pd(_mm256_loadu_pd(m + j), inv, acc);
+			index = _mm256_add_pd(index, step);
+		}
+		double lanes[4];
+		_mm256_storeu_pd(lanes, acc);
+		double pot = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+		for (int j = vectorEnd; j < jEnd; j++) {
+			if (j != i) {
+				double dx = x[i] - x[j];
+				double dy = y[i] - y[j];
+				double dz = z[i] - z[j];
+				pot += m[j] / sqrt(dx * dx + dy * dy + dz * dz);
+			}
+		}
+		sums[i] += pot;
+	}
+}
+
+/**
+ * The AVX-512 kernel, which processes eight source bodies at a time. The
+ * hardware reciprocal square root is good to 14 bits, so two Newton
+ * iterations are enough. The remainder is handled with masked loads.
+ */
+__attribute__((target("avx512f")))
+void avx512Kernel(const double * x, const double * y, const double * z,
+		const double * m, int begin, int end, int jBegin, int jEnd,
+		double * sums) {
+	const __m512d half = _mm512_set1_pd(0.5),
+			threeHalves = _mm512_set1_pd(1.5),
+			zero = _mm512_setzero_pd(), infinity = _mm512_set1_pd(INFINITY);
+	for (int i = begin; i < end; i++) {
+		__m512d xi = _mm512_set1_pd(x[i]), yi = _mm512_set1_pd(y[i]),
+				zi = _mm512_set1_pd(z[i]), self = _mm512_set1_pd((double) i);
+		__m512d index = _mm512_add_pd(_mm512_set1_pd(jBegin),
+				_mm512_set_pd(7.0, 6.0, 5.0, 4.0, 3.0, 2.0, 1.0, 0.0)),
+				step = _mm512_set1_pd(8.0);
+		__m512d acc = _mm512_setzero_pd();
+		for (int j = jBegin; j < jEnd; j += 8) {
+			__mmask8 valid = (jEnd - j >= 8) ?
+					0xFF : (__mmask8) ((1 << (jEnd - j)) - 1);
+			__m512d dx = _mm512_sub_pd(xi, _mm512_maskz_loadu_pd(valid, x + j));
+			__m512d dy = _mm512_sub_pd(yi, _mm512_maskz_loadu_pd(valid, y + j));
+			__m512d dz = _mm512_sub_pd(zi, _mm512_maskz_loadu_pd(valid, z + j));
+			__m512d r2 = _mm512_fmadd_pd(dx, dx,
+					_mm512_fmadd_pd(dy, dy, _mm512_mul_pd(dz, dz)));
+			__m512d inv = _mm512_maskz_rsqrt14_pd(valid, r2);
+			__m512d halfR2 = _mm512_mul_pd(half, r2);
+			for (int k = 0; k < 2; k++) {
+				inv = _mm512_mul_pd(inv, _mm512_fnmadd_pd(halfR2,
+						_mm512_mul_pd(inv, inv), threeHalves));
+			}
+			// Coincident bodies are infinitely close, like in the scalar
+			// kernel, instead of the NaN of the Newton iterations
+			inv = _mm512_mask_mov_pd(inv,
+					_mm512_mask_cmp_pd_mask(valid, r2, zero, _CMP_EQ_OQ),
+					infinity);
+			// Only accumulate real bodies that are not the body itself
+			__mmask8 active = valid
+					& _mm512_cmp_pd_mask(index, self, _CMP_NEQ_OQ);
+			acc = _mm512_mask3_fmadd_pd(_mm512_maskz_loadu_pd(valid, m + j),
+					inv, acc, active);
+			index = _mm512_add_pd(index, step);
+		}
+		double lanes[8];
+		_mm512_storeu_pd(lanes, acc);
+		sums[i] += ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3]))
+				+ ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+	}
+}
+
+#endif
+
+/**
+ * This operation returns true if the processor supports an instruction set.
+ */
+bool supported(SIMDInstructionSet isa) {
+#ifdef PLANETS_X86
+	__builtin_cpu_init();
+	switch (isa) {
+	case AVX512Instructions:
+		return __builtin_cpu_supports("avx512f");
+	case AVX2Instructions:
+		return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+	case SSE2Instructions:
+		return __builtin_cpu_supports("sse2");
+	default:
+		return true;
+	}
+#else
+	return isa == ScalarInstructions;
+#endif
+}
+
+} /* anonymous namespace */
+
+SIMDSolver::SIMDSolver() :
+		isa(detectInstructionSet()), verification(false), tolerance(1.0e-12),
+		lastError(0.0) {
+
+}
+
+SIMDSolver::SIMDSolver(SIMDInstructionSet _isa) :
+		isa(ScalarInstructions), verification(false), tolerance(1.0e-12),
+		lastError(0.0) {
+	instructionSet(_isa);
+}
+
+SIMDSolver::~SIMDSolver() {
+
+}
+
+SIMDInstructionSet SIMDSolver::detectInstructionSet() {
+	SIMDInstructionSet sets[3] = { AVX512Instructions, AVX2Instructions,
+			SSE2Instructions };
+	for (auto set : sets) {
+		if (supported(set)) {
+			return set;
+		}
+	}
+	return ScalarInstructions;
+}
+
+const char * SIMDSolver::name(SIMDInstructionSet _isa) {
+	const char * names[4] = { "scalar", "sse2", "avx2", "avx512" };
+	return names[_isa];
+}
+
+SIMDInstructionSet SIMDSolver::instructionSet() const {
+	return isa;
+}
+
+void SIMDSolver::instructionSet(const SIMDInstructionSet & _isa) {
+	if (!supported(_isa)) {
+		throw "Instruction set not supported by this processor!";
+	}
+	isa = _isa;
+}
+
+void SIMDSolver::verify(bool _verify, double _tolerance) {
+	verification = _verify;
+	tolerance = _tolerance;
+}
+
+double SIMDSolver::error() const {
+	return lastError;
+}
+
+void SIMDSolver::sumPotentials(SIMDInstructionSet _isa,
+		const BodySystem & system, int begin, int end, double * sums) {
+	std::fill(sums + begin, sums + end, 0.0);
+	addPotentials(_isa, system, begin, end, 0, system.size(), sums);
+}
+
+void SIMDSolver::addPotentials(SIMDInstructionSet _isa,
+		const BodySystem & system, int begin, int end, int sourceBegin,
+		int sourceEnd, double * sums) {
+	const double * x = system.x();
+	const double * y = system.y();
+	const double * z = system.z();
+	const double * m = system.m();
+	switch (_isa) {
+#ifdef PLANETS_X86
+	case AVX512Instructions:
+		avx512Kernel(x, y, z, m, begin, end, sourceBegin, sourceEnd, sums);
+		break;
+	case AVX2Instructions:
+		avx2Kernel(x, y, z, m, begin, end, sourceBegin, sourceEnd, sums);
+		break;
+	case SSE2Instructions:
+		sse2Kernel(x, y, z, m, begin, end, sourceBegin, sourceEnd, sums);
+		break;
+#endif
+	default:
+		scalarKernel(x, y, z, m, begin, end, sourceBegin, sourceEnd, sums);
+	}
+}
+
+std::vector<double> SIMDSolver::getPotentials(
+		const BodySystem & system) const {
+	PLANETS_TIMER("SIMDSolver::getPotentials");
+	int numBodies = system.size();
+	std::vector<double> potentials(numBodies);
+	PLANETS_COUNT(Interactions, (long) numBodies * (numBodies - 1));
+	parallelFor(numBodies, blockSize(), [&](int begin, int end, int) {
+		sumPotentials(isa, system, begin, end, potentials.data());
+	});
+
+	// Check the kernel against the scalar path
+	if (verification) {
+		std::vector<double> reference(numBodies);
+		sumPotentials(ScalarInstructions, system, 0, numBodies,
+				reference.data());
+		lastError = 0.0;
+		for (int i = 0; i < numBodies; i++) {
+			if (reference[i] != potentials[i]) {
+				// A NaN error must fail the tolerance, so it is not dropped
+				// like fmax would drop it
+				double error = fabs((potentials[i] - reference[i])
+						/ reference[i]);
+				if (!(error <= lastError)) {
+					lastError = error;
+				}
+			}
+		}
+		if (!(lastError <= tolerance)) {
+			throw "SIMD potentials do not match the scalar kernel!";
+		}
+	}
+
+	// Scale by G and M
+	const double * m = system.m();
+	for (int i = 0; i < numBodies; i++) {
+		potentials[i] *= -G * m[i];
+	}
+
+	return potentials;
+}
+
+} /* namespace planets */
@@ -0,0 +1,176 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef SIMDSOLVER_H_
+#define SIMDSOLVER_H_
+
+#include "PotentialSolver.h"
+
+namespace planets {
+
+/**
+ * The instruction sets that the SIMDSolver can use. They are listed from
+ * slowest to fastest.
+ */
+enum SIMDInstructionSet {
+	ScalarInstructions,
+	SSE2Instructions,
+	AVX2Instructions,
+	AVX512Instructions
+};
+
+/**
+ * The SIMDSolver computes the potentials by direct summation, like the
+ * DirectSolver, but with vectorized kernels that process 2 (SSE2), 4 (AVX2)
+ * or 8 (AVX-512) source bodies per instruction. The fastest instruction set
+ * that the processor supports is picked at runtime, so the same binary runs
+ * everywhere.
+ *
+ * The kernels avoid the square root and the divide by computing 1/r
+ * directly from an approximate reciprocal square root followed by Newton
+ * iterations. The self-interaction is masked out instead of branched
+ * around. The result agrees with direct summation to within a few units in
+ * the last place. In verification mode, every solve is also computed with
+ * the scalar kernel and the largest relative difference is recorded. A
+ * solve that exceeds the tolerance throws an exception.
+ */
+class SIMDSolver: public PotentialSolver {
+
+	/// The instruction set used by the kernels
+	SIMDInstructionSet isa;
+
+	/// True if every solve should be checked against the scalar kernel
+	bool verification;
+
+	/// The largest relative error that verification accepts
+	double tolerance;
+
+	/// The largest relative error found by the last verified solve
+	mutable double lastError;
+
+public:
+
+	/**
+	 * Constructor. The instruction set is detected automatically.
+	 */
+	SIMDSolver();
+
+	/**
+	 * Constructor
+	 * @param _isa the instruction set to use, which must be supported
+	 */
+	SIMDSolver(SIMDInstructionSet _isa);
+
+	/**
+	 * Destructor
+	 */
+	virtual ~SIMDSolver();
+
+	/**
+	 * This operation returns the fastest instruction set supported by the
+	 * processor.
+	 * @return the instruction set
+	 */
+	static SIMDInstructionSet detectInstructionSet();
+
+	/**
+	 * This operation returns a short name for an instruction set, such as
+	 * "avx2".
+	 * @param _isa the instruction set
+	 * @return the name
+	 */
+	static const char * name(SIMDInstructionSet _isa);
+
+	/**
+	 * This operation returns the instruction set used by the kernels.
+	 * @return the instruction set
+	 */
+	SIMDInstructionSet instructionSet() const;
+
+	/**
+	 * This operation sets the instruction set used by the kernels. It throws
+	 * an exception if the processor does not support it.
+	 * @param _isa the new instruction set
+	 */
+	void instructionSet(const SIMDInstructionSet & _isa);
+
+	/**
+	 * This operation turns verification against the scalar kernel on or off.
+	 * @param _verify true if solves should be verified
+	 * @param _tolerance the largest relative error that is accepted
+	 */
+	void verify(bool _verify, double _tolerance = 1.0e-12);
+
+	/**
+	 * This operation returns the largest relative error found by the last
+	 * verified solve.
+	 * @return the error, or 0 if no solve has been verified
+	 */
+	double error() const;
+
+	/**
+	 * This operation computes the unscaled potential sum m_j/r_ij, j != i,
+	 * for the targets i in [begin, end) with the given instruction set. It
+	 * is the building block for the other direct summation solvers.
+	 * @param _isa the instruction set to use
+	 * @param system the bodies that makeup the system
+	 * @param begin the first target
+	 * @param end one past the last target
+	 * @param sums the sums for every body, of which [begin, end) are set
+	 */
+	static void sumPotentials(SIMDInstructionSet _isa,
+			const BodySystem & system, int begin, int end, double * sums);
+
+	/**
+	 * This operation adds the unscaled potential sum m_j/r_ij, j != i, over
+	 * the sources j in [sourceBegin, sourceEnd) to the targets i in
+	 * [begin, end). It lets other solvers work on tiles of the full sum.
+	 * @param _isa the instruction set to use
+	 * @param system the bodies that makeup the system
+	 * @param begin the first target
+	 * @param end one past the last target
+	 * @param sourceBegin the first source
+	 * @param sourceEnd one past the last source
+	 * @param sums the sums for every body, of which [begin, end) are updated
+	 */
+	static void addPotentials(SIMDInstructionSet _isa,
+			const BodySystem & system, int begin, int end, int sourceBegin,
+			int sourceEnd, double * sums);
+
+	using PotentialSolver::getPotentials;
+
+	virtual std::vector<double> getPotentials(
+			const BodySystem & system) const;
+};
+
+} /* namespace planets */
+
+#endif /* SIMDSOLVER_H_ */
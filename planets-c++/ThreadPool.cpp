@@ -0,0 +1,161 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include "ThreadPool.h"
+#include "Profiler.h"
+#include <algorithm>
+
+namespace planets {
+
+ThreadPool::ThreadPool(int numThreads) :
+		body(nullptr), loopEnd(0), loopBlockSize(1), next(0), generation(0),
+		busyWorkers(0), failed(false), stopping(false) {
+	if (numThreads < 1) {
+		numThreads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	for (int i = 1; i < numThreads; i++) {
+		workers.push_back(std::thread(&ThreadPool::work, this, i));
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	start.notify_all();
+	for (auto & worker : workers) {
+		worker.join();
+	}
+}
+
+int ThreadPool::size() const {
+	return workers.size() + 1;
+}
+
+void ThreadPool::runBlocks(int thread) {
+	int blockBegin = 0;
+	while (!failed && (blockBegin = next.fetch_add(loopBlockSize)) < loopEnd) {
+		PLANETS_TIMER("ThreadPool::block");
+		try {
+			(*body)(blockBegin, std::min(blockBegin + loopBlockSize, loopEnd),
+					thread);
+		} catch (...) {
+			// Keep the first exception for the caller and stop the loop
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!error) {
+				error = std::current_exception();
+			}
+			failed = true;
+		}
+	}
+}
+
+void ThreadPool::work(int thread) {
+	long lastGeneration = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			start.wait(lock, [&] {
+				return stopping || generation != lastGeneration;
+			});
+			if (stopping) {
+				return;
+			}
+			lastGeneration = generation;
+		}
+		runBlocks(thread);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			busyWorkers--;
+		}
+		done.notify_one();
+	}
+}
+
+void ThreadPool::parallelFor(int begin, int end, int blockSize,
+		const LoopBody & loopBody) {
+	if (end <= begin) {
+		return;
+	}
+	blockSize = std::max(blockSize, 1);
+
+	// Small loops and single threaded pools run on the caller
+	if (workers.empty() || end - begin <= blockSize) {
+		for (int i = begin; i < end; i += blockSize) {
+			loopBody(i, std::min(i + blockSize, end), 0);
+		}
+		return;
+	}
+
+	// Publish the loop and wake up the workers
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		body = &loopBody;
+		loopEnd = end;
+		loopBlockSize = blockSize;
+		next = begin;
+		busyWorkers = workers.size();
+		error = nullptr;
+		failed = false;
+		generation++;
+	}
+	start.notify_all();
+
+	// Help out and then wait for the stragglers
+	runBlocks(0);
+	std::unique_lock<std::mutex> lock(mutex);
+	done.wait(lock, [&] { return busyWorkers == 0; });
+	body = nullptr;
+	if (error) {
+		std::exception_ptr loopError = error;
+		error = nullptr;
+		std::rethrow_exception(loopError);
+	}
+}
+
+std::shared_ptr<ThreadPool> ThreadPool::create(int numThreads) {
+	if (numThreads == 1) {
+		return nullptr;
+	}
+	return std::make_shared<ThreadPool>(numThreads);
+}
+
+void ThreadPool::parallelFor(const std::shared_ptr<ThreadPool> & pool,
+		int numItems, int blockSize, const LoopBody & loopBody) {
+	if (pool) {
+		pool->parallelFor(0, numItems, blockSize, loopBody);
+	} else if (numItems > 0) {
+		loopBody(0, numItems, 0);
+	}
+}
+
+} /* namespace planets */
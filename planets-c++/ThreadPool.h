@@ -0,0 +1,183 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+
+namespace planets {
+
+/**
+ * A ThreadPool is a fixed set of worker threads that execute parallel loops.
+ * The threads are created once and sleep between loops, so a loop costs a
+ * wake up instead of a thread creation.
+ *
+ * Loops are split into blocks of iterations that the threads claim one at a
+ * time from a shared counter. Threads that finish early simply claim more
+ * blocks, which balances the load without any static partitioning. The
+ * calling thread works on the loop as well, so a pool with one thread runs
+ * everything on the caller.
+ *
+ * If the body of a loop throws on any thread, the first exception is kept,
+ * the blocks that have not started yet are skipped, and parallelFor()
+ * rethrows it on the calling thread once every thread has left the loop. So
+ * the body is never used after parallelFor() returns or throws.
+ *
+ * A pool runs one loop at a time. parallelFor() is not reentrant, so a loop
+ * body must not start another loop on the same pool, and it must not be
+ * called from several threads at once. Copies of a PotentialSolver share
+ * one pool, so they must not solve concurrently either.
+ */
+class ThreadPool {
+
+public:
+
+	/**
+	 * The body of a parallel loop. It is called with the range of iterations
+	 * [begin, end) in a block and the index of the thread, in [0, size()),
+	 * which can be used to pick per-thread scratch space.
+	 */
+	typedef std::function<void(int begin, int end, int thread)> LoopBody;
+
+private:
+
+	/// The worker threads. The calling thread is not included.
+	std::vector<std::thread> workers;
+
+	/// Guards the loop state below
+	std::mutex mutex;
+
+	/// Signals the workers that a loop is ready or the pool is stopping
+	std::condition_variable start;
+
+	/// Signals the caller that all workers are done with the loop
+	std::condition_variable done;
+
+	/// The current loop
+	const LoopBody * body;
+	int loopEnd, loopBlockSize;
+
+	/// The next iteration to be claimed
+	std::atomic<int> next;
+
+	/// Incremented for every loop so that workers run each loop once
+	long generation;
+
+	/// The number of workers still busy with the current loop
+	int busyWorkers;
+
+	/// The first exception thrown by the body of the current loop
+	std::exception_ptr error;
+
+	/// True once the body of the current loop threw, so that no more
+	/// blocks are started
+	std::atomic<bool> failed;
+
+	/// True when the pool is being destroyed
+	bool stopping;
+
+	/**
+	 * This operation claims and executes blocks until the loop is done.
+	 */
+	void runBlocks(int thread);
+
+	/**
+	 * The main function of the worker threads.
+	 */
+	void work(int thread);
+
+public:
+
+	/**
+	 * Constructor
+	 * @param numThreads the total number of threads, including the caller.
+	 * If it is less than 1, one thread per core is used.
+	 */
+	ThreadPool(int numThreads = 0);
+
+	/**
+	 * Destructor
+	 */
+	virtual ~ThreadPool();
+
+	/**
+	 * This operation returns the number of threads, including the caller.
+	 * @return the number of threads
+	 */
+	int size() const;
+
+	/**
+	 * This operation runs a loop over [begin, end) in blocks of blockSize
+	 * iterations on all threads and returns when the loop is done. If the
+	 * body throws, the first exception is rethrown here after all threads
+	 * have stopped. It must not be called from inside of a loop on the same
+	 * pool or from several threads at once.
+	 * @param begin the first iteration
+	 * @param end one past the last iteration
+	 * @param blockSize the number of iterations in a block
+	 * @param loopBody the body of the loop
+	 */
+	void parallelFor(int begin, int end, int blockSize,
+			const LoopBody & loopBody);
+
+	/**
+	 * This operation creates the pool of a class that can run on several
+	 * threads. One thread needs no pool at all, so it returns null, which
+	 * the static parallelFor() runs on the caller.
+	 * @param numThreads the total number of threads, or 0 for one per core
+	 * @return the pool, or null for a single thread
+	 */
+	static std::shared_ptr<ThreadPool> create(int numThreads);
+
+	/**
+	 * This operation runs a loop over [0, numItems) in blocks of blockSize
+	 * items on a pool from create(), or directly on the caller as one block
+	 * if the pool is null.
+	 * @param pool the pool, or null
+	 * @param numItems the number of items
+	 * @param blockSize the number of items in a block
+	 * @param loopBody the body of the loop
+	 */
+	static void parallelFor(const std::shared_ptr<ThreadPool> & pool,
+			int numItems, int blockSize, const LoopBody & loopBody);
+};
+
+} /* namespace planets */
+
+#endif /* THREADPOOL_H_ */
@@ -0,0 +1,191 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include "TiledSolver.h"
+#include "Profiler.h"
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <algorithm>
+
+namespace planets {
+
+namespace {
+
+/**
+ * This operation adds the sums over all source tiles to the targets in
+ * [begin, end).
+ */
+void sumTiles(SIMDInstructionSet isa, const BodySystem & system, int begin,
+		int end, int sourceTile, double * sums) {
+	int numBodies = system.size();
+	std::fill(sums + begin, sums + end, 0.0);
+	for (int j = 0; j < numBodies; j += sourceTile) {
+		SIMDSolver::addPotentials(isa, system, begin, end, j,
+				std::min(j + sourceTile, numBodies), sums);
+	}
+}
+
+} /* anonymous namespace */
+
+TiledSolver::TiledSolver() :
+		isa(SIMDSolver::detectInstructionSet()), targetTile(0), sourceTile(0),
+		lastInteractions(0.0), lastSeconds(0.0) {
+
+}
+
+TiledSolver::~TiledSolver() {
+
+}
+
+int TiledSolver::targetTileSize() const {
+	return targetTile;
+}
+
+void TiledSolver::targetTileSize(const int & size) {
+	targetTile = std::max(size, 0);
+}
+
+int TiledSolver::sourceTileSize() const {
+	return sourceTile;
+}
+
+void TiledSolver::sourceTileSize(const int & size) {
+	sourceTile = std::max(size, 0);
+}
+
+SIMDInstructionSet TiledSolver::instructionSet() const {
+	return isa;
+}
+
+void TiledSolver::instructionSet(const SIMDInstructionSet & _isa) {
+	// Reuse the checks on the SIMDSolver
+	SIMDSolver check;
+	check.instructionSet(_isa);
+	isa = _isa;
+}
+
+void TiledSolver::tune(SIMDInstructionSet _isa, int & targetSize,
+		int & sourceSize) {
+	static std::mutex tuneMutex;
+	static int tuned[4][2] = { { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 } };
+	std::lock_guard<std::mutex> lock(tuneMutex);
+
+	if (tuned[_isa][0] == 0) {
+		// The synthetic system is bigger than a typical L2 cache, so that
+		// untiled sums have to go to memory.
+		int numBodies = 32768, numTargets = 512;
+		BodySystem system;
+		system.resize(numBodies);
+		std::mt19937 rng(123456);
+		std::uniform_real_distribution<double> dist(0.0, 1.0);
+		for (int i = 0; i < numBodies; i++) {
+			system.x()[i] = dist(rng);
+			system.y()[i] = dist(rng);
+			system.z()[i] = dist(rng);
+			system.m()[i] = dist(rng);
+		}
+		std::vector<double> sums(numBodies);
+
+		// Time every candidate and keep the fastest
+		double bestTime = 0.0;
+		for (int targets : { 32, 128, 512 }) {
+			for (int sources : { 256, 512, 1024, 2048, 4096 }) {
+				auto start = std::chrono::steady_clock::now();
+				for (int i = 0; i < numTargets; i += targets) {
+					sumTiles(_isa, system, i, std::min(i + targets, numTargets),
+							sources, sums.data());
+				}
+				std::chrono::duration<double> time =
+						std::chrono::steady_clock::now() - start;
+				if (tuned[_isa][0] == 0 || time.count() < bestTime) {
+					bestTime = time.count();
+					tuned[_isa][0] = targets;
+					tuned[_isa][1] = sources;
+				}
+			}
+		}
+	}
+
+	targetSize = tuned[_isa][0];
+	sourceSize = tuned[_isa][1];
+}
+
+double TiledSolver::interactions() const {
+	return lastInteractions;
+}
+
+double TiledSolver::seconds() const {
+	return lastSeconds;
+}
+
+double TiledSolver::gflops() const {
+	if (lastSeconds <= 0.0) {
+		return 0.0;
+	}
+	return lastInteractions * flopsPerInteraction / lastSeconds * 1.0e-9;
+}
+
+std::vector<double> TiledSolver::getPotentials(
+		const BodySystem & system) const {
+	if (targetTile == 0 || sourceTile == 0) {
+		int targetSize = 0, sourceSize = 0;
+		tune(isa, targetSize, sourceSize);
+		targetTile = (targetTile > 0) ? targetTile : targetSize;
+		sourceTile = (sourceTile > 0) ? sourceTile : sourceSize;
+	}
+
+	PLANETS_TIMER("TiledSolver::getPotentials");
+	auto start = std::chrono::steady_clock::now();
+	int numBodies = system.size();
+	std::vector<double> potentials(numBodies);
+	PLANETS_COUNT(Interactions, (long) numBodies * (numBodies - 1));
+
+	// Every target tile is a block of work for the threads
+	parallelFor(numBodies, targetTile, [&](int begin, int end, int) {
+		sumTiles(isa, system, begin, end, sourceTile, potentials.data());
+	});
+
+	// Scale by G and M
+	const double * m = system.m();
+	for (int i = 0; i < numBodies; i++) {
+		potentials[i] *= -G * m[i];
+	}
+
+	std::chrono::duration<double> time = std::chrono::steady_clock::now()
+			- start;
+	lastSeconds = time.count();
+	lastInteractions = (double) numBodies * (numBodies - 1);
+
+	return potentials;
+}
+
+} /* namespace planets */
@@ -0,0 +1,168 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef TILEDSOLVER_H_
+#define TILEDSOLVER_H_
+
+#include "PotentialSolver.h"
+#include "SIMDSolver.h"
+
+namespace planets {
+
+/**
+ * The TiledSolver computes the potentials by direct summation, but it splits
+ * the N^2 interactions into tiles of targets x sources. The positions and
+ * masses of a source tile stay in cache while every target in the target
+ * tile is summed over it, so large systems are not limited by streaming
+ * the whole system from memory once per body. The tiles are summed with the
+ * SIMDSolver kernels.
+ *
+ * The best tile sizes depend on the cache sizes of the processor, so they
+ * are tuned automatically the first time that a solver is used, unless they
+ * have been set explicitly. Tuning times a few candidates on a synthetic
+ * system and is only done once per process and instruction set.
+ *
+ * The solver records the number of interactions and the time of the last
+ * solve, so its throughput can be compared against the other solvers.
+ */
+class TiledSolver: public PotentialSolver {
+
+	/// The instruction set used by the kernels
+	SIMDInstructionSet isa;
+
+	/// The number of targets in a tile, or 0 to tune it
+	mutable int targetTile;
+
+	/// The number of sources in a tile, or 0 to tune it
+	mutable int sourceTile;
+
+	/// The number of interactions in the last solve
+	mutable double lastInteractions;
+
+	/// The time of the last solve in seconds
+	mutable double lastSeconds;
+
+public:
+
+	/**
+	 * The number of floating point operations that are counted for every
+	 * interaction: 3 for the separation, 5 for its square, 2 for the
+	 * reciprocal square root and 2 for the multiply-add.
+	 */
+	static const int flopsPerInteraction = 12;
+
+	/**
+	 * Constructor. The instruction set is detected automatically and the
+	 * tile sizes are tuned on the first solve.
+	 */
+	TiledSolver();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~TiledSolver();
+
+	/**
+	 * This operation returns the number of targets in a tile.
+	 * @return the tile size, or 0 if it has not been tuned yet
+	 */
+	int targetTileSize() const;
+
+	/**
+	 * This operation sets the number of targets in a tile.
+	 * @param size the new tile size, or 0 to tune it
+	 */
+	void targetTileSize(const int & size);
+
+	/**
+	 * This operation returns the number of sources in a tile.
+	 * @return the tile size, or 0 if it has not been tuned yet
+	 */
+	int sourceTileSize() const;
+
+	/**
+	 * This operation sets the number of sources in a tile.
+	 * @param size the new tile size, or 0 to tune it
+	 */
+	void sourceTileSize(const int & size);
+
+	/**
+	 * This operation returns the instruction set used by the kernels.
+	 * @return the instruction set
+	 */
+	SIMDInstructionSet instructionSet() const;
+
+	/**
+	 * This operation sets the instruction set used by the kernels.
+	 * @param _isa the new instruction set
+	 */
+	void instructionSet(const SIMDInstructionSet & _isa);
+
+	/**
+	 * This operation tunes the tile sizes for an instruction set by timing
+	 * candidate sizes on a synthetic system. The result is cached, so only
+	 * the first call for an instruction set does any work.
+	 * @param _isa the instruction set
+	 * @param targetSize the tuned number of targets in a tile
+	 * @param sourceSize the tuned number of sources in a tile
+	 */
+	static void tune(SIMDInstructionSet _isa, int & targetSize,
+			int & sourceSize);
+
+	/**
+	 * This operation returns the number of pairwise interactions computed
+	 * by the last solve.
+	 * @return the number of interactions
+	 */
+	double interactions() const;
+
+	/**
+	 * This operation returns the time taken by the last solve.
+	 * @return the time in seconds
+	 */
+	double seconds() const;
+
+	/**
+	 * This operation returns the floating point throughput of the last
+	 * solve.
+	 * @return the throughput in GFLOP/s
+	 */
+	double gflops() const;
+
+	using PotentialSolver::getPotentials;
+
+	virtual std::vector<double> getPotentials(
+			const BodySystem & system) const;
+};
+
+} /* namespace planets */
+
+#endif /* TILEDSOLVER_H_ */
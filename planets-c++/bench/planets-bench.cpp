@@ -0,0 +1,471 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include <vector>
+#include <string>
+#include <chrono>
+#include <ctime>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <functional>
+#include <random>
+#include <math.h>
+#include <algorithm>
+#include "../CatalogGenerator.h"
+#include "../CSVBodyParser.h"
+#include "../DirectSolver.h"
+#include "../MixedPrecisionSolver.h"
+#include "../TiledSolver.h"
+#include "../PairPotentialSolver.h"
+#include "../CellList.h"
+#include "../BodyAggregator.h"
+#include "../ResultsWriter.h"
+
+using namespace planets;
+using namespace std;
+
+/**
+ * The result of one benchmark.
+ */
+struct BenchResult {
+	/// The name of the benchmark
+	string name;
+	/// The size of the problem, usually the number of bodies
+	long size;
+	/// The best wall time of one repetition in seconds
+	double seconds;
+	/// The amount of work done per second, in units of unit
+	double rate;
+	/// The unit of the rate
+	string unit;
+};
+
+/**
+ * This function times a piece of work. It is repeated until it has run for
+ * at least minSeconds, and at least minRepetitions times, and the best time
+ * is kept because it is the least disturbed by the rest of the machine.
+ * @param work the work
+ * @param minSeconds the minimum total time
+ * @param minRepetitions the minimum number of repetitions
+ * @return the best time in seconds
+ */
+double bestTime(const function<void()> & work, double minSeconds = 0.2,
+		int minRepetitions = 3) {
+	double best = 1.0e300, total = 0.0;
+	for (int k = 0; k < minRepetitions || total < minSeconds; k++) {
+		auto start = chrono::steady_clock::now();
+		work();
+		double seconds = chrono::duration<double>(
+				chrono::steady_clock::now() - start).count();
+		best = min(best, seconds);
+		total += seconds;
+	}
+	return best;
+}
+
+/**
+ * This function hands a result to the compiler as if it were read, so that
+ * the work that computed it is not dropped as dead code. It emits no
+ * instructions.
+ * @param value the result
+ */
+template<typename T>
+void doNotOptimize(const T & value) {
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * This function adds a result to the list and prints it.
+ */
+void report(vector<BenchResult> & results, const BenchResult & result) {
+	results.push_back(result);
+	cout << left << setw(26) << result.name << right << setw(10)
+			<< result.size << setw(14) << scientific << setprecision(4)
+			<< result.seconds << " s" << setw(14) << result.rate << " "
+			<< result.unit << endl;
+}
+
+/**
+ * This function writes the results as JSON.
+ * @param fileName the name of the file
+ * @param results the results
+ */
+void writeJSON(const string & fileName, const vector<BenchResult> & results) {
+	ofstream file(fileName);
+	if (!file) {
+		throw "Unable to open file for writing!";
+	}
+	char timestamp[32];
+	time_t now = time(nullptr);
+	strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+	file << "{\n  \"timestamp\": \"" << timestamp << "\",\n"
+			<< "  \"compiler\": \"" << __VERSION__ << "\",\n"
+			<< "  \"benchmarks\": [\n";
+	file << setprecision(9);
+	for (size_t k = 0; k < results.size(); k++) {
+		const BenchResult & result = results[k];
+		file << "    {\"name\": \"" << result.name << "\", \"size\": "
+				<< result.size << ", \"seconds\": " << result.seconds
+				<< ", \"rate\": " << result.rate << ", \"unit\": \""
+				<< result.unit << "\"}" << (k + 1 < results.size() ? "," : "")
+				<< "\n";
+	}
+	file << "  ]\n}\n";
+}
+
+/**
+ * This function measures how fast CSVBodyParser reads catalogs.
+ */
+void benchParser(vector<BenchResult> & results, long maxSize,
+		const string & fileName) {
+	CatalogGenerator generator;
+	for (long size = 10000; size <= maxSize; size *= 10) {
+		generator.write(fileName, size);
+		ifstream file(fileName, ios::binary | ios::ate);
+		double megabytes = file.tellg() / 1.0e6;
+		CSVBodyParser parser;
+		double seconds = bestTime([&]() {
+			doNotOptimize(parser.parseBodies(fileName));
+		});
+		report(results, {"csv_parse_bodies", size, seconds,
+				megabytes / seconds, "MB/s"});
+		seconds = bestTime([&]() {
+			doNotOptimize(parser.parseSystem(fileName));
+		});
+		report(results, {"csv_parse_system", size, seconds,
+				megabytes / seconds, "MB/s"});
+	}
+	remove(fileName.c_str());
+}
+
+/**
+ * This function measures the interactions per second of the potential
+ * kernels. Large systems only compute the potentials of a sample of the
+ * bodies, which is enough to time the kernel without an O(N^2) wait. The
+ * tiled solver and its naive baseline, the direct solver, are also reported
+ * in GFLOP/s with the operation count of the tiled solver.
+ */
+void benchPotentials(vector<BenchResult> & results, long maxSize) {
+	CatalogGenerator generator;
+	const long maxInteractions = 20000000;
+	for (long size = 10; size <= maxSize; size *= 10) {
+		auto system = generator.generate(size);
+		auto bodies = system.bodies();
+		long numTargets = max(1L, min(size, maxInteractions / size));
+		double seconds = bestTime([&]() {
+			for (long i = 0; i < numTargets; i++) {
+				doNotOptimize(bodies[i].getGravitationalPotential(bodies, i));
+			}
+		});
+		report(results, {"celestial_body_potential", size, seconds,
+				numTargets * (double) size / seconds, "interactions/s"});
+		if (size * size <= 100 * maxInteractions) {
+			DirectSolver solver;
+			seconds = bestTime([&]() {
+				doNotOptimize(solver.getPotentials(system));
+			});
+			report(results, {"direct_solver", size, seconds,
+					size * (double) size / seconds, "interactions/s"});
+			report(results, {"direct_solver_gflops", size, seconds,
+					size * (size - 1.0) * TiledSolver::flopsPerInteraction
+							/ seconds * 1.0e-9, "GFLOP/s"});
+			SIMDSolver simd;
+			seconds = bestTime([&]() {
+				doNotOptimize(simd.getPotentials(system));
+			});
+			report(results, {"simd_solver", size, seconds,
+					size * (double) size / seconds, "interactions/s"});
+			// The first solve tunes the tiles, so it is left out
+			TiledSolver tiled;
+			tiled.getPotentials(system);
+			double gflops = 0.0;
+			seconds = bestTime([&]() {
+				doNotOptimize(tiled.getPotentials(system));
+				gflops = max(gflops, tiled.gflops());
+			});
+			report(results, {"tiled_solver", size, seconds,
+					size * (double) size / seconds, "interactions/s"});
+			report(results, {"tiled_solver_gflops", size, seconds, gflops,
+					"GFLOP/s"});
+			for (auto mode : {FloatAccumulation, CompensatedAccumulation,
+					DoubleAccumulation}) {
+				MixedPrecisionSolver mixed(mode);
+				seconds = bestTime([&]() {
+					doNotOptimize(mixed.getPotentials(system));
+				});
+				report(results, {string("mixed_solver_")
+						+ MixedPrecisionSolver::name(mode), size, seconds,
+						size * (double) size / seconds, "interactions/s"});
+			}
+		}
+	}
+}
+
+/**
+ * This function measures the softened kernels against direct summation and
+ * the cutoff potential with its cell list. The cutoff is picked so that
+ * every body has about 32 neighbors in the uniform catalog, which fills a
+ * cube 2^32 m wide.
+ */
+void benchPairPotentials(vector<BenchResult> & results, long maxSize) {
+	CatalogGenerator generator;
+	for (long size = 10000; size <= maxSize; size *= 10) {
+		auto system = generator.generate(size);
+		double seconds;
+		if (size <= 10000) {
+			PairPotentialSolver<PlummerSoftening> plummer(
+					PlummerSoftening(1.0e6));
+			seconds = bestTime([&]() {
+				doNotOptimize(plummer.getPotentials(system));
+			});
+			report(results, {"plummer_softening", size, seconds,
+					size * (double) size / seconds, "interactions/s"});
+			PairPotentialSolver<SplineSoftening> spline(SplineSoftening(2.8e6));
+			seconds = bestTime([&]() {
+				doNotOptimize(spline.getPotentials(system));
+			});
+			report(results, {"spline_softening", size, seconds,
+					size * (double) size / seconds, "interactions/s"});
+		}
+		double cutoff = 4294967296.0 * cbrt(32.0 / size);
+		PairPotentialSolver<PlummerSoftening, ShiftedCutoff> shortRange(
+				PlummerSoftening(1.0e6), ShiftedCutoff(cutoff));
+		seconds = bestTime([&]() {
+			doNotOptimize(shortRange.getPotentials(system));
+		});
+		report(results, {"cutoff_cell_list", size, seconds, size / seconds,
+				"bodies/s"});
+	}
+}
+
+/**
+ * This function measures building and updating the cell list and the
+ * nearest neighbor and range queries, with a linear scan for comparison.
+ * The cells hold about 8 bodies each, and the updates alternate between
+ * two copies of the catalog that are a few percent of a cell apart.
+ */
+void benchSpatialIndex(vector<BenchResult> & results, long maxSize) {
+	CatalogGenerator generator;
+	mt19937 rng(42);
+	for (long size = 10000; size <= maxSize; size *= 10) {
+		auto system = generator.generate(size), moved = system;
+		double width = 4294967296.0 * cbrt(8.0 / size);
+		normal_distribution<double> drift(0.0, 0.03 * width);
+		for (long i = 1; i < size; i++) {
+			moved.x()[i] += drift(rng);
+			moved.y()[i] += drift(rng);
+			moved.z()[i] += drift(rng);
+		}
+		CellList cells;
+		double seconds = bestTime([&]() {
+			cells.build(system, width);
+		});
+		report(results, {"cell_list_build", size, seconds, size / seconds,
+				"bodies/s"});
+		bool toggle = false;
+		seconds = bestTime([&]() {
+			toggle = !toggle;
+			doNotOptimize(cells.update(toggle ? moved : system));
+		});
+		report(results, {"cell_list_update", size, seconds, size / seconds,
+				"bodies/s"});
+
+		// Find the nearest neighbor and the bodies within two cells of the
+		// first thousand bodies
+		const int numQueries = 1000;
+		vector<int> neighbors;
+		seconds = bestTime([&]() {
+			for (int i = 0; i < numQueries; i++) {
+				doNotOptimize(cells.nearest({system.x()[i], system.y()[i],
+						system.z()[i]}, i));
+			}
+		});
+		report(results, {"nearest_neighbor", size, seconds,
+				numQueries / seconds, "queries/s"});
+		seconds = bestTime([&]() {
+			for (int i = 0; i < numQueries; i++) {
+				cells.range({system.x()[i], system.y()[i], system.z()[i]},
+						2.0 * width, neighbors);
+				doNotOptimize(neighbors);
+			}
+		});
+		report(results, {"range_query", size, seconds, numQueries / seconds,
+				"queries/s"});
+		if (size == 10000) {
+			const double * x = system.x(), * y = system.y(), * z = system.z();
+			seconds = bestTime([&]() {
+				for (int i = 0; i < numQueries; i++) {
+					double best = INFINITY;
+					int nearest = -1;
+					for (long j = 0; j < size; j++) {
+						double dx = x[j] - x[i], dy = y[j] - y[i],
+								dz = z[j] - z[i];
+						double d2 = dx * dx + dy * dy + dz * dz;
+						if (j != i && d2 < best) {
+							best = d2;
+							nearest = j;
+						}
+					}
+					doNotOptimize(nearest);
+				}
+			});
+			report(results, {"nearest_linear_scan", size, seconds,
+					numQueries / seconds, "queries/s"});
+		}
+	}
+}
+
+/**
+ * This function measures the aggregation of volumes and masses by type.
+ */
+void benchAggregation(vector<BenchResult> & results, long maxSize) {
+	CatalogGenerator generator;
+	for (long size = 10000; size <= 10 * maxSize; size *= 10) {
+		auto system = generator.generate(size);
+		for (int i = 0; i < size; i++) {
+			if (BodySystem::hasRadius(system.type(i))) {
+				system.radius(i, i);
+			}
+		}
+		BodyAggregator aggregator;
+		double seconds = bestTime([&]() {
+			doNotOptimize(aggregator.totals(system));
+		});
+		report(results, {"aggregate_totals", size, seconds, size / seconds,
+				"bodies/s"});
+	}
+}
+
+/**
+ * This function measures writing the potentials in the text and binary
+ * formats of ResultsWriter.
+ */
+void benchResults(vector<BenchResult> & results, long maxSize,
+		const string & fileName) {
+	CatalogGenerator generator;
+	for (long size = 10000; size <= maxSize; size *= 10) {
+		auto system = generator.generate(size);
+		vector<double> potentials(size);
+		for (long i = 0; i < size; i++) {
+			potentials[i] = -1.0e-3 * system.m()[i] / (i + 1);
+		}
+		const pair<const char *, ResultsWriter::Format> formats[] = {
+				{"write_results_text", ResultsWriter::Text},
+				{"write_results_binary", ResultsWriter::Binary}};
+		for (const auto & format : formats) {
+			double seconds = bestTime([&]() {
+				ResultsWriter writer(fileName, format.second);
+				writer.write(system, potentials);
+				writer.close();
+			});
+			report(results, {format.first, size, seconds, size / seconds,
+					"bodies/s"});
+		}
+	}
+	remove(fileName.c_str());
+}
+
+/**
+ * This function measures the whole pipeline of planets-c++: reading a
+ * catalog, computing the potentials, setting the radii and aggregating the
+ * volumes.
+ */
+void benchPipeline(vector<BenchResult> & results, long maxSize,
+		const string & fileName) {
+	CatalogGenerator generator;
+	for (long size = 1000; size <= min(maxSize, 10000L); size *= 10) {
+		generator.write(fileName, size);
+		double seconds = bestTime([&]() {
+			CSVBodyParser parser;
+			auto system = parser.parseSystem(fileName);
+			DirectSolver solver;
+			auto potentials = solver.getPotentials(system);
+			for (int i = 0; i < system.size(); i++) {
+				if (BodySystem::hasRadius(system.type(i))) {
+					system.radius(i, i + potentials[i]);
+				}
+			}
+			BodyAggregator aggregator;
+			doNotOptimize(aggregator.totals(system));
+		});
+		report(results, {"pipeline", size, seconds, size / seconds,
+				"bodies/s"});
+	}
+	remove(fileName.c_str());
+}
+
+/**
+ * This program runs the benchmarks and writes the results as JSON so that
+ * they can be compared between versions.
+ * @param argc number of input arguments
+ * @param argv pointer to an array of input arguments. --json <file> sets
+ * the output file and --quick limits the sizes for a fast check.
+ * @return EXIT_SUCCESS return code if successfully executed, otherwise not
+ */
+int main(int argc, char * argv[]) {
+
+	string jsonFile = "bench-results.json";
+	long maxSize = 1000000;
+	for (int k = 1; k < argc; k++) {
+		if (!strcmp(argv[k], "--json") && k + 1 < argc) {
+			jsonFile = argv[++k];
+		} else if (!strcmp(argv[k], "--quick")) {
+			maxSize = 10000;
+		} else {
+			cerr << "Usage: " << argv[0] << " [--json <file>] [--quick]"
+					<< endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	try {
+		vector<BenchResult> results;
+		string catalog = "bench-catalog.csv";
+		benchParser(results, maxSize, catalog);
+		benchPotentials(results, maxSize);
+		benchPairPotentials(results, maxSize);
+		benchSpatialIndex(results, maxSize);
+		benchAggregation(results, maxSize);
+		benchResults(results, maxSize, "bench-results.out");
+		benchPipeline(results, maxSize, catalog);
+		writeJSON(jsonFile, results);
+		cout << "Wrote " << results.size() << " results to " << jsonFile
+				<< endl;
+	} catch (const char * error) {
+		cerr << error << endl;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
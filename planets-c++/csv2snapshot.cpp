@@ -0,0 +1,67 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include <iostream>
+#include "CSVBodyParser.h"
+#include "BodySnapshot.h"
+
+using namespace planets;
+using namespace std;
+
+/**
+ * This program converts a CSV file of bodies into a binary snapshot file
+ * that can be read with BinaryBodyParser or BodySnapshot.
+ * @param argc number of input arguments
+ * @param argv pointer to an array of input arguments. The first is the CSV
+ * file and the second is the snapshot file.
+ * @return EXIT_SUCCESS return code if successfully executed, otherwise not
+ */
+int main(int argc, char * argv[]) {
+
+	if (argc != 3) {
+		cerr << "Usage: " << argv[0] << " <input.csv> <output.snap>" << endl;
+		return EXIT_FAILURE;
+	}
+
+	try {
+		// Parse the bodies on all cores and write them out
+		CSVBodyParser parser;
+		parser.threads(0);
+		auto system = parser.parseSystem(argv[1]);
+		BodySnapshot::write(argv[2], system);
+		cout << "Wrote " << system.size() << " bodies to " << argv[2] << endl;
+	} catch (const char * error) {
+		cerr << error << endl;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,158 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include "CatalogGenerator.h"
+#include "Options.h"
+
+using namespace planets;
+using namespace std;
+
+/**
+ * This function prints how the program is used.
+ * @param program the name of the program
+ */
+void printUsage(const char * program) {
+	cerr << "Usage: " << program << " [options] <output file>" << endl
+			<< "  --bodies <n>          number of bodies (default 10000)" << endl
+			<< "  --distribution <d>    uniform, plummer, disk or clustered"
+			<< " (default plummer)" << endl
+			<< "  --seed <s>            random seed (default 123456)" << endl
+			<< "  --scale <m>           scale radius in m (default 1 pc)"
+			<< endl
+			<< "  --mass <kg>           total mass, or the mass of the star"
+			<< " of a disk" << endl
+			<< "  --clusters <k>        number of clusters (default 16)" << endl
+			<< "  --format <f>          csv or snapshot (default from the file"
+			<< " name)" << endl;
+}
+
+/**
+ * This program writes a synthetic catalog of bodies to a CSV file that
+ * CSVBodyParser reads or to a binary snapshot file. The bodies are
+ * generated and written in batches, so catalogs can be much larger than
+ * memory.
+ * @param argc number of input arguments
+ * @param argv pointer to an array of input arguments
+ * @return EXIT_SUCCESS return code if successfully executed, otherwise not
+ */
+int main(int argc, char * argv[]) {
+
+	CatalogGenerator generator(123456, CatalogGenerator::Plummer);
+	long numBodies = 10000;
+	string format, fileName;
+
+	// Read the options. Every option takes a value. Numbers must be valid
+	// in full, and the generator rejects scales and masses that are not
+	// positive.
+	try {
+		for (int k = 1; k < argc; k++) {
+			string option = argv[k];
+			if (option.compare(0, 2, "--") != 0) {
+				if (!fileName.empty()) {
+					printUsage(argv[0]);
+					return EXIT_FAILURE;
+				}
+				fileName = option;
+				continue;
+			}
+			if (k + 1 >= argc) {
+				printUsage(argv[0]);
+				return EXIT_FAILURE;
+			}
+			string value = argv[++k];
+			if (option == "--bodies") {
+				numBodies = parseNumber<long>(value);
+			} else if (option == "--distribution") {
+				if (value == "uniform") {
+					generator.distribution(CatalogGenerator::Uniform);
+				} else if (value == "plummer") {
+					generator.distribution(CatalogGenerator::Plummer);
+				} else if (value == "disk") {
+					generator.distribution(CatalogGenerator::Disk);
+				} else if (value == "clustered") {
+					generator.distribution(CatalogGenerator::Clustered);
+				} else {
+					cerr << "Unknown distribution " << value << endl;
+					return EXIT_FAILURE;
+				}
+			} else if (option == "--seed") {
+				generator.seed(parseNumber<unsigned int>(value));
+			} else if (option == "--scale") {
+				generator.scale(parseNumber<double>(value));
+			} else if (option == "--mass") {
+				generator.totalMass(parseNumber<double>(value));
+			} else if (option == "--clusters") {
+				generator.clusters(parseNumber<int>(value));
+			} else if (option == "--format") {
+				format = value;
+			} else {
+				printUsage(argv[0]);
+				return EXIT_FAILURE;
+			}
+		}
+	} catch (const char * error) {
+		cerr << error << endl;
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+	if (fileName.empty() || numBodies < 1) {
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	// Pick the format from the file name if it was not given
+	if (format.empty()) {
+		bool snapshot = fileName.size() > 5
+				&& fileName.compare(fileName.size() - 5, 5, ".snap") == 0;
+		format = snapshot ? "snapshot" : "csv";
+	}
+
+	try {
+		if (format == "csv") {
+			generator.write(fileName, numBodies);
+		} else if (format == "snapshot") {
+			generator.writeSnapshot(fileName, numBodies);
+		} else {
+			cerr << "Unknown format " << format << endl;
+			return EXIT_FAILURE;
+		}
+		cout << "Wrote " << numBodies << " bodies to " << fileName << endl;
+	} catch (const char * error) {
+		cerr << error << endl;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
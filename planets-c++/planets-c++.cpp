@@ -31,69 +31,270 @@
  -----------------------------------------------------------------------------*/
 #include <vector>
 #include <random>
+#include <memory>
+#include <string>
+#include <sstream>
 #include <iostream>
 #include <iomanip>
+#include <cstdlib>
+#include <limits>
 #include "CSVBodyParser.h"
-#include "Planet.h"
-#include "DwarfPlanet.h"
+#include "BinaryBodyParser.h"
+#include "DirectSolver.h"
+#include "SIMDSolver.h"
+#include "MixedPrecisionSolver.h"
+#include "TiledSolver.h"
+#include "BarnesHutSolver.h"
+#include "FMMSolver.h"
+#include "BodyAggregator.h"
+#include "ResultsWriter.h"
+#include "Options.h"
+#include "Profiler.h"
 
 using namespace planets;
 using namespace std;
 
 /**
- * This operation computes the gravitational potential at each body and sets
- * the fictitious planetary radius for planets and dwarf planets.
+ * This operation prints how the program is used.
+ * @param program the name of the program
+ */
+void printUsage(const char * program) {
+	cerr << "Usage: " << program << " [options]" << endl
+			<< "  --input <file>        CSV or .snap input (default"
+			<< " planetary-system.csv)" << endl
+			<< "  --output <file>       output file (default standard output)"
+			<< endl
+			<< "  --solver <s>          direct, simd, mixed, tiled, tree or fmm"
+			<< " (default direct)" << endl
+			<< "  --accumulation <a>    float, compensated or double sums"
+			<< " for mixed (default compensated)" << endl
+			<< "  --error-report        compare mixed with double precision"
+			<< endl
+			<< "  --threads <n>         number of threads, 0 for all cores"
+			<< " (default 1)" << endl
+			<< "  --theta <t>           opening angle of tree and fmm"
+			<< " (default 0.5)" << endl
+			<< "  --precision <p>       digits after the decimal point"
+			<< " (default 8)" << endl
+			<< "  --format <f>          text, csv or binary (default text)"
+			<< endl
+			<< "  --profile             print a profile at exit" << endl
+			<< "  --trace <file>        write a Chrome trace at exit" << endl
+			<< "  --help                print this message" << endl;
+}
+
+/**
+ * This operation reads the bodies from the input file.
+ * @param options the options of the run
+ * @return the bodies
+ */
+BodySystem readBodies(const Options & options) {
+	PLANETS_TIMER("main::parse");
+	const string & input = options.input;
+	if (input.size() > 5 && input.compare(input.size() - 5, 5, ".snap") == 0) {
+		BinaryBodyParser parser;
+		return parser.parseSystem(input);
+	}
+	CSVBodyParser parser;
+	parser.threads(options.threads);
+	return parser.parseSystem(input);
+}
+
+/**
+ * This operation creates the solver that was asked for. It throws an
+ * exception for unknown solvers.
+ * @param options the options of the run
+ * @return the solver
+ */
+unique_ptr<PotentialSolver> makeSolver(const Options & options) {
+	unique_ptr<PotentialSolver> solver;
+	if (options.solver == "direct") {
+		solver.reset(new DirectSolver());
+	} else if (options.solver == "simd") {
+		solver.reset(new SIMDSolver());
+	} else if (options.solver == "mixed") {
+		auto mixed = new MixedPrecisionSolver(options.accumulation);
+		// Report the errors without rejecting any of them
+		mixed->verify(options.errorReport,
+				numeric_limits<double>::infinity());
+		solver.reset(mixed);
+	} else if (options.solver == "tiled") {
+		solver.reset(new TiledSolver());
+	} else if (options.solver == "tree") {
+		solver.reset(new BarnesHutSolver(options.theta));
+	} else if (options.solver == "fmm") {
+		solver.reset(new FMMSolver(4, options.theta));
+	} else {
+		throw "Unknown solver!";
+	}
+	solver->threads(options.threads);
+	return solver;
+}
+
+/**
+ * This operation computes the gravitational potential at each body.
  * @param bodies the list of bodies for which I should compute the potential
- * and set the planetary radius if applicable
+ * @param solver the solver used to compute the potentials. DirectSolver is
+ * exact, while BarnesHutSolver and FMMSolver are much faster for large
+ * systems. Solvers can use several threads.
+ */
+vector<double> getPotentials(const BodySystem & bodies,
+		const PotentialSolver & solver) {
+
+	// Compute the potentials for the whole system at once
+	PLANETS_TIMER("main::potentials");
+	return solver.getPotentials(bodies);
+}
+
+/**
+ * This operation prints the errors of the mixed precision solver relative
+ * to double precision.
+ * @param solver the solver, which must be a verifying MixedPrecisionSolver
+ * @param bodies the bodies
  */
-vector<double> getPotentials(const vector<CelestialBody> & bodies) {
+void printErrorReport(const PotentialSolver & solver,
+		const BodySystem & bodies) {
+	const auto & mixed = dynamic_cast<const MixedPrecisionSolver &>(solver);
+	PrecisionReport report = mixed.report();
+	cerr << std::scientific << setprecision(3)
+			<< "Mixed precision (" << SIMDSolver::name(mixed.instructionSet())
+			<< ", " << MixedPrecisionSolver::name(mixed.accumulation())
+			<< " accumulation) vs double precision over " << report.numBodies
+			<< " bodies:" << endl
+			<< "  max relative error = " << report.maxError;
+	if (report.worstBody >= 0) {
+		cerr << " (" << bodies.label(report.worstBody) << ")";
+	}
+	cerr << endl << "  rms relative error = " << report.rmsError << endl;
+}
+
+/**
+ * This operation prints the throughput of the last solve of the tiled
+ * solver. It does nothing for the other solvers, which do not count their
+ * floating point operations.
+ * @param solver the solver
+ */
+void printThroughput(const PotentialSolver & solver) {
+	auto tiled = dynamic_cast<const TiledSolver *>(&solver);
+	if (tiled) {
+		cerr << std::scientific << setprecision(3) << "Tiled solver ("
+				<< SIMDSolver::name(tiled->instructionSet()) << "): "
+				<< (long) tiled->interactions() << " interactions in "
+				<< tiled->seconds() << " s, " << tiled->gflops()
+				<< " GFLOP/s" << endl;
+	}
+}
+
+/**
+ * This operation sets the fictitious planetary radius for planets and dwarf
+ * planets. It is kept apart from the potentials so that the random numbers
+ * are always drawn in the same order, no matter how the potentials are
+ * computed.
+ * @param bodies the list of bodies for which I should set the planetary
+ * radius if applicable
+ */
+void setRadii(BodySystem & bodies) {
 
 	// Create a random number generator for radii
 	mt19937 rng(123456);
 
-	// Compute the gravitational potential at each body and set other properties
+	// Set radius for planets and dwarf planets. The radii are stored only
+	// for the types of bodies that have one.
 	int numBodies = bodies.size();
-	vector<double> potentials(numBodies);
 	for (int i = 0; i < numBodies; i++) {
-		// Compute the potential
-		potentials[i] = bodies[i].getGravitationalPotential(bodies,i);
-		// Set radius for planets and dwarf planets
-		if (bodies[i].type() != Star) {
+		if (BodySystem::hasRadius(bodies.type(i))) {
 			double radius = ((double) i+rng());
-			((Planet &) bodies[i]).radius(radius);
+			bodies.radius(i, radius);
 		}
 	}
 
-	return potentials;
+	return;
+}
+
+/**
+ * This operation writes the potentials, followed by the volume of all
+ * dwarf planets in the text format.
+ * @param bodies the bodies
+ * @param potentials the potentials of the bodies
+ * @param options the options of the run
+ */
+void writeResults(const BodySystem & bodies,
+		const vector<double> & potentials, const Options & options) {
+	PLANETS_TIMER("main::output");
+
+	// Write the results in large blocks instead of line by line
+	ResultsWriter writer(options.output, options.format, options.precision);
+	writer.write(bodies, potentials);
+
+	// Compute the volume of all dwarf planets, and the mass that their
+	// density implies, in one pass over the radii of the dwarf planets
+	if (options.format == ResultsWriter::Text) {
+		BodyAggregator aggregator;
+		aggregator.threads(options.threads);
+		auto totals = aggregator.totals(bodies);
+		const BodyTotals & dwarfPlanets = totals[DwarfPlanetary];
+		ostringstream summary;
+		summary << std::scientific << setprecision(options.precision)
+				<< "dwarf planets (" << dwarfPlanets.count << "), volume = "
+				<< dwarfPlanets.volume << " m^3, implied mass = "
+				<< dwarfPlanets.impliedMass << " kg\n";
+		writer.write(summary.str());
+	}
+	writer.close();
 }
 
 /**
  * Main function
  * @param argc number of input arguments
- * @param argv pointer to an array of input arguments
+ * @param argv pointer to an array of input arguments. Run with --help for
+ * the options.
  * @return EXIT_SUCCESS return code if successfully executed, otherwise not
  */
 int main(int argc, char * argv[]) {
 
-	// Set output precision to double
-	cout << std::fixed << setprecision(8);
+	// Read the options and turn on profiling if it was asked for
+	Options options;
+	try {
+		options = parseOptions(argc, argv);
+	} catch (const char * error) {
+		cerr << error << endl;
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+	if (options.help) {
+		printUsage(argv[0]);
+		return EXIT_SUCCESS;
+	}
+	Profiler::enabled(options.profile || !options.trace.empty());
 
-	// Load the celestial body parse
-	CSVBodyParser parser;
-	// Parse the bodies. The result is acquired by value and takes advantage of
-	// move semantics.
-	auto bodies = parser.parseBodies("planetary-system.csv");
+	try {
+		// Parse the bodies. The result is acquired by value and takes
+		// advantage of move semantics.
+		BodySystem bodies = readBodies(options);
 
-	// Get the potentials
-	auto potentials = getPotentials(bodies);
+		// Get the potentials with the solver that was asked for
+		auto solver = makeSolver(options);
+		auto potentials = getPotentials(bodies, *solver);
+		if (options.errorReport) {
+			printErrorReport(*solver, bodies);
+		}
+		setRadii(bodies);
 
-	// Pretty-print the results. Set precision to double.
-	int numBodies = bodies.size();
-	for (int i = 0; i < numBodies; i++) {
-		cout << bodies[i].name() << ", potential = " << potentials[i] << endl;
-	}
+		// Write the results to the output file or standard output
+		writeResults(bodies, potentials, options);
 
-	// Compute the volume of all dwarf planets
+		// Report where the time went
+		if (options.profile) {
+			printThroughput(*solver);
+			Profiler::report(cerr);
+		}
+		if (!options.trace.empty()) {
+			Profiler::writeTrace(options.trace);
+		}
+	} catch (const char * error) {
+		cerr << error << endl;
+		return EXIT_FAILURE;
+	}
 
 	return EXIT_SUCCESS;
 }
@@ -0,0 +1,127 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE planets
+
+#if defined __GNUC__ && __GNUC__>=6
+  #pragma GCC diagnostic ignored "-Wwrite-strings"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+#include <vector>
+#include <math.h>
+#include "../BarnesHutSolver.h"
+#include "RandomSystem.h"
+
+using namespace std;
+using namespace planets;
+
+/**
+ * This operation computes the largest relative error of the tree potentials
+ * with respect to direct summation.
+ */
+double getMaxError(const vector<CelestialBody> & bodies,
+		const vector<double> & potentials) {
+	double maxError = 0.0;
+	for (int i = 0; i < bodies.size(); i++) {
+		double ref = bodies[i].getGravitationalPotential(bodies, i);
+		maxError = max(maxError, fabs((potentials[i] - ref) / ref));
+	}
+	return maxError;
+}
+
+/**
+ * This operation checks that the tree reproduces direct summation exactly
+ * when every cell is opened.
+ */
+BOOST_AUTO_TEST_CASE(checkZeroOpeningAngle) {
+
+	auto bodies = getRandomSystem(500, 1.0, 1.0e10, 2.0e10).bodies();
+	BarnesHutSolver solver(0.0);
+	auto potentials = solver.getPotentials(bodies);
+	BOOST_REQUIRE_EQUAL(bodies.size(), potentials.size());
+	BOOST_REQUIRE_SMALL(getMaxError(bodies, potentials), 1.0e-12);
+
+	return;
+}
+
+/**
+ * This operation checks the accuracy of the tree against direct summation
+ * and that it improves as the opening angle shrinks.
+ */
+BOOST_AUTO_TEST_CASE(checkAccuracy) {
+
+	auto bodies = getRandomSystem(2000, 1.0, 1.0e10, 2.0e10).bodies();
+	BarnesHutSolver solver;
+	BOOST_REQUIRE_CLOSE(0.5, solver.theta(), 1.0e-15);
+	double coarseError = getMaxError(bodies, solver.getPotentials(bodies));
+	solver.theta(0.25);
+	double fineError = getMaxError(bodies, solver.getPotentials(bodies));
+	BOOST_REQUIRE_SMALL(coarseError, 1.0e-2);
+	BOOST_REQUIRE(fineError < coarseError);
+
+	return;
+}
+
+/**
+ * This operation checks that empty and single body systems are handled.
+ */
+BOOST_AUTO_TEST_CASE(checkSmallSystems) {
+
+	BarnesHutSolver solver;
+	BOOST_REQUIRE(solver.getPotentials(vector<CelestialBody>()).empty());
+	auto bodies = getRandomSystem(1, 1.0, 1.0e10, 2.0e10).bodies();
+	auto potentials = solver.getPotentials(bodies);
+	BOOST_REQUIRE_EQUAL(1, potentials.size());
+	BOOST_REQUIRE_EQUAL(0.0, potentials[0]);
+
+	return;
+}
+
+/**
+ * This operation checks that the results do not depend on the number of
+ * threads.
+ */
+BOOST_AUTO_TEST_CASE(checkThreads) {
+
+	auto bodies = getRandomSystem(2000, 1.0, 1.0e10, 2.0e10).bodies();
+	BarnesHutSolver solver;
+	auto serial = solver.getPotentials(bodies);
+	solver.threads(3);
+	solver.blockSize(50);
+	auto parallel = solver.getPotentials(bodies);
+	for (int i = 0; i < bodies.size(); i++) {
+		BOOST_REQUIRE_EQUAL(serial[i], parallel[i]);
+	}
+
+	return;
+}
@@ -0,0 +1,161 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE planets
+
+#if defined __GNUC__ && __GNUC__>=6
+  #pragma GCC diagnostic ignored "-Wwrite-strings"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+#include <vector>
+#include <random>
+#include "../BodyAggregator.h"
+#include "../DwarfPlanet.h"
+
+using namespace std;
+using namespace planets;
+
+/**
+ * This function creates a random system with all three types of bodies and
+ * random radii for the planets and dwarf planets.
+ * @param size the number of bodies
+ * @return the system
+ */
+BodySystem makeSystem(int size) {
+	const CelestialBodyType types[3] = {Star, Planetary, DwarfPlanetary};
+	mt19937 rng(98765);
+	uniform_real_distribution<double> distribution(1.0, 2.0);
+	uniform_int_distribution<int> typeDistribution(0, 2);
+	BodySystem system;
+	for (int i = 0; i < size; i++) {
+		CelestialBodyData data;
+		data.mass = distribution(rng);
+		data.type = types[typeDistribution(rng)];
+		system.add(data);
+		if (BodySystem::hasRadius(data.type)) {
+			system.radius(i, distribution(rng));
+		}
+	}
+	return system;
+}
+
+/**
+ * This operation checks the volumes and totals against the DwarfPlanet and
+ * against a plain loop over the bodies.
+ */
+BOOST_AUTO_TEST_CASE(checkTotals) {
+
+	int size = 10000;
+	BodySystem system = makeSystem(size);
+	BodyAggregator aggregator;
+	aggregator.blockSize(1000);
+
+	// The volumes of the dwarf planets should match DwarfPlanet
+	int numDwarfPlanets = system.count(DwarfPlanetary);
+	vector<double> volumes(numDwarfPlanets), masses(numDwarfPlanets);
+	aggregator.volumes(system, DwarfPlanetary, volumes.data(), masses.data());
+	for (int k = 0; k < numDwarfPlanets; k++) {
+		DwarfPlanet planet(system.data(system.members(DwarfPlanetary)[k]));
+		planet.radius(system.radii(DwarfPlanetary)[k]);
+		BOOST_REQUIRE_CLOSE(planet.volume(), volumes[k], 1.0e-12);
+		BOOST_REQUIRE_CLOSE(1000.0 * DwarfPlanet::density * planet.volume(),
+				masses[k], 1.0e-12);
+	}
+
+	// Stars have no volume
+	vector<double> starVolumes(system.count(Star), 1.0);
+	aggregator.volumes(system, Star, starVolumes.data());
+	for (double volume : starVolumes) {
+		BOOST_REQUIRE_EQUAL(0.0, volume);
+	}
+
+	// Sum everything by hand
+	vector<BodyTotals> expected(3);
+	for (int i = 0; i < size; i++) {
+		BodyTotals & total = expected[system.type(i)];
+		total.count++;
+		total.mass += system.m()[i];
+		total.volume += DwarfPlanet::volume(system.radius(i));
+	}
+	auto totals = aggregator.totals(system);
+	BOOST_REQUIRE_EQUAL(3, totals.size());
+	int count = 0;
+	for (int t = 0; t < 3; t++) {
+		count += totals[t].count;
+		BOOST_REQUIRE_EQUAL(expected[t].count, totals[t].count);
+		BOOST_REQUIRE_CLOSE(expected[t].mass, totals[t].mass, 1.0e-10);
+		BOOST_REQUIRE_CLOSE(expected[t].volume, totals[t].volume, 1.0e-10);
+	}
+	BOOST_REQUIRE_EQUAL(size, count);
+	BOOST_REQUIRE_EQUAL(0.0, totals[Star].volume);
+	BOOST_REQUIRE_EQUAL(0.0, totals[Planetary].impliedMass);
+	// 1.88 g/cm^3 is 1880 kg/m^3, which goes with volumes in m^3
+	BOOST_REQUIRE_CLOSE(1880.0, BodyAggregator::density(DwarfPlanetary),
+			1.0e-12);
+	BOOST_REQUIRE_CLOSE(
+			1000.0 * DwarfPlanet::density * expected[DwarfPlanetary].volume,
+			totals[DwarfPlanetary].impliedMass, 1.0e-10);
+
+	// An empty system has empty totals
+	auto emptyTotals = aggregator.totals(BodySystem());
+	for (const auto & total : emptyTotals) {
+		BOOST_REQUIRE_EQUAL(0, total.count);
+		BOOST_REQUIRE_EQUAL(0.0, total.mass);
+	}
+
+	return;
+}
+
+/**
+ * This operation checks that the totals do not depend on the number of
+ * threads.
+ */
+BOOST_AUTO_TEST_CASE(checkThreads) {
+
+	BodySystem system = makeSystem(20000);
+	BodyAggregator aggregator;
+	aggregator.blockSize(500);
+	auto totals = aggregator.totals(system);
+	aggregator.threads(4);
+	BOOST_REQUIRE_EQUAL(4, aggregator.threads());
+	auto threadedTotals = aggregator.totals(system);
+	for (int t = 0; t < 3; t++) {
+		BOOST_REQUIRE_EQUAL(totals[t].count, threadedTotals[t].count);
+		BOOST_REQUIRE_EQUAL(totals[t].mass, threadedTotals[t].mass);
+		BOOST_REQUIRE_EQUAL(totals[t].volume, threadedTotals[t].volume);
+		BOOST_REQUIRE_EQUAL(totals[t].impliedMass,
+				threadedTotals[t].impliedMass);
+	}
+
+	return;
+}
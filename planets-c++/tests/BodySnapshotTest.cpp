@@ -0,0 +1,242 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE planets
+
+#if defined __GNUC__ && __GNUC__>=6
+  #pragma GCC diagnostic ignored "-Wwrite-strings"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include "../BodySnapshot.h"
+#include "../BinaryBodyParser.h"
+
+using namespace std;
+using namespace planets;
+
+/**
+ * This function creates a small system of bodies for the tests.
+ * @param size the number of bodies
+ * @return the system
+ */
+BodySystem getTestSystem(int size) {
+	BodySystem system;
+	for (int i = 0; i < size; i++) {
+		double iD = ((double) i) + 1.0;
+		CelestialBodyData data;
+		data.pos = {iD, 2.0 * iD, 3.0 * iD};
+		data.vel = {4.0 * iD, 5.0 * iD, 6.0 * iD};
+		data.mass = 7.0 * iD;
+		// Include an empty label to check the label offsets
+		data.label = (i == 3) ? "" : "Kitten" + to_string(i);
+		data.type = (CelestialBodyType) (i % 3);
+		system.add(data);
+	}
+	return system;
+}
+
+/**
+ * This operation checks that bodies survive the trip into and out of a
+ * snapshot file and that the columns are aligned.
+ */
+BOOST_AUTO_TEST_CASE(checkRoundTrip) {
+
+	const string fileName = "test.snap";
+	int size = 11;
+	auto system = getTestSystem(size);
+	BodySnapshot::write(fileName, system);
+
+	// Check the snapshot itself
+	BodySnapshot snapshot(fileName);
+	BOOST_REQUIRE_EQUAL(size, snapshot.size());
+	const double * columns[7] = { snapshot.x(), snapshot.y(), snapshot.z(),
+			snapshot.vx(), snapshot.vy(), snapshot.vz(), snapshot.m() };
+	for (auto column : columns) {
+		BOOST_REQUIRE_EQUAL(0, ((uintptr_t) column) % 64);
+	}
+	for (int i = 0; i < size; i++) {
+		BOOST_REQUIRE_EQUAL(system.x()[i], snapshot.x()[i]);
+		BOOST_REQUIRE_EQUAL(system.y()[i], snapshot.y()[i]);
+		BOOST_REQUIRE_EQUAL(system.z()[i], snapshot.z()[i]);
+		BOOST_REQUIRE_EQUAL(system.vx()[i], snapshot.vx()[i]);
+		BOOST_REQUIRE_EQUAL(system.vy()[i], snapshot.vy()[i]);
+		BOOST_REQUIRE_EQUAL(system.vz()[i], snapshot.vz()[i]);
+		BOOST_REQUIRE_EQUAL(system.m()[i], snapshot.m()[i]);
+		BOOST_REQUIRE_EQUAL(system.label(i), snapshot.label(i));
+		BOOST_REQUIRE_EQUAL(system.type(i), snapshot.type(i));
+	}
+
+	// Check the copy
+	auto copy = snapshot.system();
+	BOOST_REQUIRE_EQUAL(size, copy.size());
+	for (int i = 0; i < size; i++) {
+		BOOST_REQUIRE_EQUAL(system.m()[i], copy.m()[i]);
+		BOOST_REQUIRE_EQUAL(system.label(i), copy.label(i));
+		BOOST_REQUIRE_EQUAL(system.type(i), copy.type(i));
+	}
+
+	// Check the parser
+	BinaryBodyParser parser;
+	auto bodies = parser.parseBodies(fileName);
+	BOOST_REQUIRE_EQUAL(size, bodies.size());
+	for (int i = 0; i < size; i++) {
+		BOOST_REQUIRE_EQUAL(system.z()[i], bodies[i].pos()[2]);
+		BOOST_REQUIRE_EQUAL(system.vx()[i], bodies[i].vel()[0]);
+		BOOST_REQUIRE_EQUAL(system.label(i), bodies[i].name());
+		BOOST_REQUIRE_EQUAL(system.type(i), bodies[i].type());
+	}
+
+	// Check streaming in batches
+	vector<int> batchSizes;
+	int next = 0;
+	parser.parseBodies(fileName, 5, [&](vector<CelestialBody> & batch) {
+		batchSizes.push_back(batch.size());
+		for (auto & body : batch) {
+			BOOST_REQUIRE_EQUAL(system.label(next), body.name());
+			BOOST_REQUIRE_EQUAL(system.m()[next++], body.mass());
+		}
+	});
+	BOOST_REQUIRE_EQUAL(size, next);
+	BOOST_REQUIRE_EQUAL(3, batchSizes.size());
+	BOOST_REQUIRE_EQUAL(1, batchSizes[2]);
+
+	remove(fileName.c_str());
+
+	return;
+}
+
+/**
+ * This operation checks that a snapshot written in batches is the same as
+ * one written at once.
+ */
+BOOST_AUTO_TEST_CASE(checkWriter) {
+
+	const string fileName = "batches.snap", wholeFileName = "whole.snap";
+	int size = 23;
+	auto system = getTestSystem(size);
+	BodySnapshot::write(wholeFileName, system);
+
+	// Write the bodies in uneven batches
+	{
+		BodySnapshotWriter writer(fileName, size);
+		BodySystem batch;
+		for (int i = 0; i < size; i++) {
+			batch.add(system.data(i));
+			if (batch.size() == 5 || i == size - 1) {
+				writer.add(batch);
+				batch.resize(0);
+			}
+		}
+		writer.close();
+	}
+
+	// The files should be identical
+	ifstream batchInput(fileName.c_str(), ios::binary);
+	string batchContents((istreambuf_iterator<char>(batchInput)),
+			istreambuf_iterator<char>());
+	ifstream wholeInput(wholeFileName.c_str(), ios::binary);
+	string wholeContents((istreambuf_iterator<char>(wholeInput)),
+			istreambuf_iterator<char>());
+	BOOST_REQUIRE(batchContents == wholeContents);
+	BodySnapshot snapshot(fileName);
+	BOOST_REQUIRE_EQUAL(size, snapshot.size());
+	BOOST_REQUIRE_EQUAL(system.label(22), snapshot.label(22));
+
+	// Too many or too few bodies are errors
+	BodySnapshotWriter writer(fileName, 3);
+	BOOST_REQUIRE_THROW(writer.add(system), const char *);
+	BOOST_REQUIRE_THROW(writer.close(), const char *);
+
+	remove(fileName.c_str());
+	remove(wholeFileName.c_str());
+
+	return;
+}
+
+/**
+ * This operation checks that empty systems can be written and read.
+ */
+BOOST_AUTO_TEST_CASE(checkEmpty) {
+
+	const string fileName = "empty.snap";
+	BodySnapshot::write(fileName, BodySystem());
+	BodySnapshot snapshot(fileName);
+	BOOST_REQUIRE_EQUAL(0, snapshot.size());
+	BOOST_REQUIRE_EQUAL(0, snapshot.system().size());
+	remove(fileName.c_str());
+
+	return;
+}
+
+/**
+ * This operation checks that files that are not snapshots, are truncated
+ * or have the wrong version are rejected.
+ */
+BOOST_AUTO_TEST_CASE(checkInvalid) {
+
+	const string fileName = "invalid.snap";
+	BodySnapshot::write(fileName, getTestSystem(5));
+
+	// Read the file back in
+	ifstream input(fileName.c_str(), ios::binary);
+	string contents((istreambuf_iterator<char>(input)),
+			istreambuf_iterator<char>());
+	input.close();
+
+	// Truncate it
+	ofstream output(fileName.c_str(), ios::binary);
+	output.write(contents.data(), contents.size() - 1);
+	output.close();
+	BOOST_REQUIRE_THROW(BodySnapshot snapshot(fileName), const char *);
+
+	// Change the version, which follows the magic string
+	string badVersion = contents;
+	badVersion[8] = 2;
+	output.open(fileName.c_str(), ios::binary);
+	output.write(badVersion.data(), badVersion.size());
+	output.close();
+	BOOST_REQUIRE_THROW(BodySnapshot snapshot(fileName), const char *);
+
+	// Write text instead
+	output.open(fileName.c_str());
+	output << "1,2,3,4,5,6,7,Kitten,1" << endl;
+	output.close();
+	BOOST_REQUIRE_THROW(BodySnapshot snapshot(fileName), const char *);
+
+	remove(fileName.c_str());
+
+	return;
+}
@@ -0,0 +1,251 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE planets
+
+#if defined __GNUC__ && __GNUC__>=6
+  #pragma GCC diagnostic ignored "-Wwrite-strings"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+#include <vector>
+#include <string>
+#include "../BodySystem.h"
+
+using namespace std;
+using namespace planets;
+
+/**
+ * This operation checks that bodies survive the trip into and out of the
+ * structure of arrays layout.
+ */
+BOOST_AUTO_TEST_CASE(checkConversion) {
+
+	int size = 10;
+	vector<CelestialBody> bodies;
+	for (int i = 0; i < size; i++) {
+		double iD = ((double) i) + 1.0;
+		CelestialBodyData data;
+		data.pos = {iD, 2.0 * iD, 3.0 * iD};
+		data.vel = {4.0 * iD, 5.0 * iD, 6.0 * iD};
+		data.mass = 7.0 * iD;
+		data.label = "Kitten" + to_string(i);
+		data.type = (i % 2) ? Planetary : DwarfPlanetary;
+		bodies.push_back(CelestialBody(data));
+	}
+
+	// Check the arrays
+	BodySystem system(bodies);
+	BOOST_REQUIRE_EQUAL(size, system.size());
+	for (int i = 0; i < size; i++) {
+		double iD = ((double) i) + 1.0;
+		BOOST_REQUIRE_EQUAL(iD, system.x()[i]);
+		BOOST_REQUIRE_EQUAL(2.0 * iD, system.y()[i]);
+		BOOST_REQUIRE_EQUAL(3.0 * iD, system.z()[i]);
+		BOOST_REQUIRE_EQUAL(4.0 * iD, system.vx()[i]);
+		BOOST_REQUIRE_EQUAL(5.0 * iD, system.vy()[i]);
+		BOOST_REQUIRE_EQUAL(6.0 * iD, system.vz()[i]);
+		BOOST_REQUIRE_EQUAL(7.0 * iD, system.m()[i]);
+		BOOST_REQUIRE_EQUAL(bodies[i].name(), system.label(i));
+		BOOST_REQUIRE_EQUAL(bodies[i].type(), system.type(i));
+	}
+
+	// Change a body and convert back
+	system.x()[3] = -1.0;
+	system.m()[3] = 42.0;
+	system.label(3, "Cat");
+	system.type(3, Star);
+	auto result = system.bodies();
+	BOOST_REQUIRE_EQUAL(size, result.size());
+	for (int i = 0; i < size; i++) {
+		if (i != 3) {
+			BOOST_REQUIRE(bodies[i].pos() == result[i].pos());
+			BOOST_REQUIRE(bodies[i].vel() == result[i].vel());
+			BOOST_REQUIRE_EQUAL(bodies[i].mass(), result[i].mass());
+			BOOST_REQUIRE_EQUAL(bodies[i].name(), result[i].name());
+			BOOST_REQUIRE_EQUAL(bodies[i].type(), result[i].type());
+		}
+	}
+	BOOST_REQUIRE_EQUAL(-1.0, result[3].pos()[0]);
+	BOOST_REQUIRE_EQUAL(42.0, result[3].mass());
+	BOOST_REQUIRE_EQUAL("Cat", result[3].name());
+	BOOST_REQUIRE_EQUAL(Star, result[3].type());
+
+	return;
+}
+
+/**
+ * This operation checks adding and resizing.
+ */
+BOOST_AUTO_TEST_CASE(checkAddAndResize) {
+
+	BodySystem system;
+	BOOST_REQUIRE_EQUAL(0, system.size());
+	CelestialBodyData data;
+	data.pos = {1.0, 2.0, 3.0};
+	data.vel = {4.0, 5.0, 6.0};
+	data.mass = 7.0;
+	data.label = "Kitten";
+	data.type = DwarfPlanetary;
+	system.add(data);
+	system.resize(3);
+	BOOST_REQUIRE_EQUAL(3, system.size());
+	BOOST_REQUIRE_EQUAL(7.0, system.m()[0]);
+	BOOST_REQUIRE_EQUAL(0.0, system.m()[2]);
+	auto copy = system.data(0);
+	BOOST_REQUIRE(data.pos == copy.pos);
+	BOOST_REQUIRE(data.vel == copy.vel);
+	BOOST_REQUIRE_EQUAL("Kitten", copy.label);
+	BOOST_REQUIRE_EQUAL(DwarfPlanetary, copy.type);
+
+	return;
+}
+
+/**
+ * This operation checks that the arrays survive growing the storage, that
+ * systems can be appended and copied, and that shrinking and growing again
+ * zeroes the new bodies.
+ */
+BOOST_AUTO_TEST_CASE(checkStorage) {
+
+	// Add enough bodies to grow the storage several times
+	BodySystem system;
+	int size = 1000;
+	for (int i = 0; i < size; i++) {
+		CelestialBodyData data;
+		data.pos = {(double) i, 2.0 * i, 3.0 * i};
+		data.vel = {4.0 * i, 5.0 * i, 6.0 * i};
+		data.mass = 7.0 * i;
+		data.label = "Kitten" + to_string(i);
+		data.type = Planetary;
+		system.add(data);
+	}
+	BOOST_REQUIRE_GE(system.capacity(), size);
+	for (int i = 0; i < size; i++) {
+		BOOST_REQUIRE_EQUAL((double) i, system.x()[i]);
+		BOOST_REQUIRE_EQUAL(6.0 * i, system.vz()[i]);
+		BOOST_REQUIRE_EQUAL(7.0 * i, system.m()[i]);
+		BOOST_REQUIRE_EQUAL("Kitten" + to_string(i), system.label(i));
+	}
+
+	// Append it to itself
+	BodySystem copy = system;
+	system.append(system);
+	BOOST_REQUIRE_EQUAL(2 * size, system.size());
+	for (int i = 0; i < size; i++) {
+		BOOST_REQUIRE_EQUAL(system.y()[i], system.y()[i + size]);
+		BOOST_REQUIRE_EQUAL(system.vx()[i], system.vx()[i + size]);
+		BOOST_REQUIRE_EQUAL(system.label(i), system.label(i + size));
+		BOOST_REQUIRE_EQUAL(system.type(i), system.type(i + size));
+	}
+
+	// The copy should not have changed
+	BOOST_REQUIRE_EQUAL(size, copy.size());
+	BOOST_REQUIRE_EQUAL(7.0 * (size - 1), copy.m()[size - 1]);
+
+	// Shrink and grow again
+	system.resize(10);
+	system.resize(20);
+	BOOST_REQUIRE_EQUAL(9.0, system.x()[9]);
+	BOOST_REQUIRE_EQUAL(0.0, system.x()[10]);
+	BOOST_REQUIRE_EQUAL(0.0, system.m()[19]);
+	BOOST_REQUIRE_EQUAL("", system.label(15));
+	BOOST_REQUIRE_EQUAL(Star, system.type(15));
+
+	return;
+}
+
+/**
+ * This operation checks that the members of each type and their radii are
+ * kept consistent as bodies are added, removed and change their type.
+ */
+BOOST_AUTO_TEST_CASE(checkTypes) {
+
+	// Make a system with all three types in turn
+	int size = 30;
+	const CelestialBodyType types[3] = {Star, Planetary, DwarfPlanetary};
+	BodySystem system;
+	for (int i = 0; i < size; i++) {
+		CelestialBodyData data;
+		data.mass = i;
+		data.type = types[i % 3];
+		system.add(data);
+	}
+	BOOST_REQUIRE_EQUAL(10, system.count(Star));
+	BOOST_REQUIRE_EQUAL(10, system.count(Planetary));
+	BOOST_REQUIRE_EQUAL(10, system.count(DwarfPlanetary));
+	BOOST_REQUIRE(system.radii(Star) == nullptr);
+	BOOST_REQUIRE_THROW(system.radius(0, 1.0), const char *);
+
+	// Set the radii by body and check them through the dense columns
+	for (int i = 0; i < size; i++) {
+		if (BodySystem::hasRadius(system.type(i))) {
+			system.radius(i, 2.0 * i);
+		}
+	}
+	for (auto type : {Planetary, DwarfPlanetary}) {
+		const int * members = system.members(type);
+		const double * radii = system.radii(type);
+		for (int k = 0; k < system.count(type); k++) {
+			BOOST_REQUIRE_EQUAL(type, system.type(members[k]));
+			BOOST_REQUIRE_EQUAL(k, system.slot(members[k]));
+			BOOST_REQUIRE_EQUAL(2.0 * members[k], radii[k]);
+		}
+	}
+
+	// Changing a type moves the body and drops its radius
+	system.type(1, DwarfPlanetary);
+	system.type(3, Planetary);
+	BOOST_REQUIRE_EQUAL(9, system.count(Star));
+	BOOST_REQUIRE_EQUAL(10, system.count(Planetary));
+	BOOST_REQUIRE_EQUAL(11, system.count(DwarfPlanetary));
+	BOOST_REQUIRE_EQUAL(0.0, system.radius(1));
+	BOOST_REQUIRE_EQUAL(0.0, system.radius(3));
+	BOOST_REQUIRE_EQUAL(4.0, system.radius(2));
+	BOOST_REQUIRE_EQUAL(58.0, system.radius(29));
+
+	// Appending and shrinking keep the radii of the remaining bodies
+	system.append(system);
+	BOOST_REQUIRE_EQUAL(22, system.count(DwarfPlanetary));
+	BOOST_REQUIRE_EQUAL(58.0, system.radius(59));
+	system.resize(25);
+	BOOST_REQUIRE_EQUAL(8, system.count(Star));
+	BOOST_REQUIRE_EQUAL(8, system.count(Planetary));
+	BOOST_REQUIRE_EQUAL(9, system.count(DwarfPlanetary));
+	for (int i = 0; i < 25; i++) {
+		BOOST_REQUIRE_EQUAL(i, system.members(system.type(i))[system.slot(i)]);
+	}
+	BOOST_REQUIRE_EQUAL(46.0, system.radius(23));
+	BOOST_REQUIRE_EQUAL(0.0, system.radius(24));
+
+	return;
+}
@@ -122,6 +122,19 @@ void writeTestData(const string & filename,
 	output.close();
 }
 
+/**
+ * This is a parser that only implements the required operation, so that the
+ * default batch implementation on IBodyParser can be checked.
+ */
+class WholeFileParser: public IBodyParser {
+public:
+	virtual std::vector<CelestialBody> parseBodies(
+			const std::string & inputFile) const {
+		return CSVBodyParser().parseBodies(inputFile);
+	}
+	using IBodyParser::parseBodies;
+};
+
 /**
  * This is the test fixture that is executed at setup and teardown.
  */
@@ -171,4 +184,149 @@ BOOST_AUTO_TEST_CASE(checkParse) {
 	return;
 }
 
+/**
+ * This operation checks that comments, empty lines, carriage returns and
+ * padded numbers are handled.
+ */
+BOOST_AUTO_TEST_CASE(checkFormatting) {
+
+	// Write a file with a bit of everything in it
+	const string fileName = "formatting.csv";
+	ofstream output(fileName.c_str());
+	output << "# x,y,z,vx,vy,vz,mass,label,type\n";
+	output << "\n";
+	output << "1.5, 2.5e3,-3.0,4,5,6,7.25,Kitten,1\r\n";
+	output << "\r\n";
+	output << "0.0,0.0,0.0,0.0,0.0,0.0,1.0e30,Momma cat,0";
+	output.close();
+
+	// Load the data
+	CSVBodyParser bodyParser;
+	auto parsedBodies = bodyParser.parseBodies(fileName);
+	remove(fileName.c_str());
+
+	// Check it
+	BOOST_REQUIRE_EQUAL(2,parsedBodies.size());
+	BOOST_REQUIRE_CLOSE(1.5,parsedBodies[0].pos()[0],1.0e-15);
+	BOOST_REQUIRE_CLOSE(2500.0,parsedBodies[0].pos()[1],1.0e-15);
+	BOOST_REQUIRE_CLOSE(-3.0,parsedBodies[0].pos()[2],1.0e-15);
+	BOOST_REQUIRE_CLOSE(7.25,parsedBodies[0].mass(),1.0e-15);
+	BOOST_REQUIRE_EQUAL("Kitten",parsedBodies[0].name());
+	BOOST_REQUIRE_EQUAL(Planetary,parsedBodies[0].type());
+	BOOST_REQUIRE_CLOSE(1.0e30,parsedBodies[1].mass(),1.0e-15);
+	BOOST_REQUIRE_EQUAL("Momma cat",parsedBodies[1].name());
+	BOOST_REQUIRE_EQUAL(Star,parsedBodies[1].type());
+
+	// Missing files should throw
+	BOOST_REQUIRE_THROW(bodyParser.parseBodies("missing.csv"),const char *);
+
+	return;
+}
+
+/**
+ * This operation checks that parsing in chunks on several threads gives the
+ * same bodies as parsing on one thread.
+ */
+BOOST_AUTO_TEST_CASE(checkThreads) {
+
+	// Write a file with comments and empty lines mixed in so that they land
+	// on chunk boundaries
+	const string fileName = "threads.csv";
+	auto data = getTestBodyData(numTestBodies);
+	ofstream output(fileName.c_str());
+	output << std::fixed << std::setprecision(8);
+	for (int i = 0; i < 1000; i++) {
+		auto & body = data[i % numTestBodies];
+		if (i % 7 == 0) {
+			output << "# Comment " << i << "\n";
+		}
+		if (i % 11 == 0) {
+			output << "\n";
+		}
+		output << body.pos[0] << "," << body.pos[1] << "," << body.pos[2]
+				<< "," << body.vel[0] << "," << body.vel[1] << ","
+				<< body.vel[2] << "," << body.mass + i << "," << i << ","
+				<< body.type << "\n";
+	}
+	output.close();
+
+	// Parse it on one thread and then in small chunks on several threads
+	CSVBodyParser bodyParser;
+	auto refBodies = bodyParser.parseBodies(fileName);
+	bodyParser.threads(4);
+	BOOST_REQUIRE_EQUAL(4,bodyParser.threads());
+	for (long chunkSize : {1L, 37L, 100L, 4096L}) {
+		bodyParser.chunkSize(chunkSize);
+		auto bodies = bodyParser.parseBodies(fileName);
+		BOOST_REQUIRE_EQUAL(1000,bodies.size());
+		for (int i = 0; i < 1000; i++) {
+			BOOST_REQUIRE_EQUAL(refBodies[i].mass(),bodies[i].mass());
+			BOOST_REQUIRE_EQUAL(refBodies[i].pos()[2],bodies[i].pos()[2]);
+			BOOST_REQUIRE_EQUAL(to_string(i),bodies[i].name());
+			BOOST_REQUIRE_EQUAL(refBodies[i].type(),bodies[i].type());
+		}
+	}
+
+	// Parsing straight into a system should give the same bodies
+	for (int threads : {1, 4}) {
+		bodyParser.threads(threads);
+		auto system = bodyParser.parseSystem(fileName);
+		BOOST_REQUIRE_EQUAL(1000,system.size());
+		for (int i = 0; i < 1000; i++) {
+			BOOST_REQUIRE_EQUAL(refBodies[i].mass(),system.m()[i]);
+			BOOST_REQUIRE_EQUAL(refBodies[i].pos()[1],system.y()[i]);
+			BOOST_REQUIRE_EQUAL(to_string(i),system.label(i));
+			BOOST_REQUIRE_EQUAL(refBodies[i].type(),system.type(i));
+		}
+	}
+
+	// Errors in a chunk should reach the caller
+	output.open(fileName.c_str(), ios::app);
+	output << "0,0,0,0,0,0,1,Bad,7\n";
+	output.close();
+	BOOST_REQUIRE_THROW(bodyParser.parseBodies(fileName),const char *);
+	remove(fileName.c_str());
+
+	return;
+}
+
+/**
+ * This operation checks that streaming the file in batches gives the same
+ * bodies as parsing it all at once.
+ */
+BOOST_AUTO_TEST_CASE(checkBatches) {
+
+	// Write a file that does not divide evenly into batches
+	const string fileName = "batches.csv";
+	writeTestData(fileName,getTestBodyData(10));
+	CSVBodyParser bodyParser;
+	auto refBodies = bodyParser.parseBodies(fileName);
+
+	// Stream it with both the CSV parser and the default implementation
+	WholeFileParser wholeFileParser;
+	const IBodyParser * parsers[2] = { &bodyParser, &wholeFileParser };
+	for (auto parser : parsers) {
+		vector<CelestialBody> bodies;
+		vector<int> batchSizes;
+		parser->parseBodies(fileName, 4, [&](vector<CelestialBody> & batch) {
+			batchSizes.push_back(batch.size());
+			move(batch.begin(), batch.end(), back_inserter(bodies));
+		});
+		BOOST_REQUIRE_EQUAL(3,batchSizes.size());
+		BOOST_REQUIRE_EQUAL(4,batchSizes[0]);
+		BOOST_REQUIRE_EQUAL(4,batchSizes[1]);
+		BOOST_REQUIRE_EQUAL(2,batchSizes[2]);
+		BOOST_REQUIRE_EQUAL(refBodies.size(),bodies.size());
+		for (int i = 0; i < bodies.size(); i++) {
+			BOOST_REQUIRE_EQUAL(refBodies[i].pos()[0],bodies[i].pos()[0]);
+			BOOST_REQUIRE_EQUAL(refBodies[i].mass(),bodies[i].mass());
+			BOOST_REQUIRE_EQUAL(refBodies[i].name(),bodies[i].name());
+			BOOST_REQUIRE_EQUAL(refBodies[i].type(),bodies[i].type());
+		}
+	}
+	remove(fileName.c_str());
+
+	return;
+}
+
 BOOST_AUTO_TEST_SUITE_END()
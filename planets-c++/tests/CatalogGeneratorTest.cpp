@@ -0,0 +1,271 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE planets
+
+#if defined __GNUC__ && __GNUC__>=6
+  #pragma GCC diagnostic ignored "-Wwrite-strings"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include "../CatalogGenerator.h"
+#include "../CSVBodyParser.h"
+#include "../BodySnapshot.h"
+#include "../DirectSolver.h"
+
+using namespace std;
+using namespace planets;
+
+/**
+ * This operation checks that catalogs are reproducible from the seed and
+ * that they start with the central star.
+ */
+BOOST_AUTO_TEST_CASE(checkGenerate) {
+
+	CatalogGenerator generator(42);
+	BOOST_REQUIRE_EQUAL(42, generator.seed());
+	auto system = generator.generate(100);
+	BOOST_REQUIRE_EQUAL(100, system.size());
+	BOOST_REQUIRE_EQUAL(Star, system.type(0));
+	BOOST_REQUIRE_EQUAL("central-star", system.label(0));
+	BOOST_REQUIRE_EQUAL(0.0, system.x()[0]);
+	BOOST_REQUIRE_EQUAL(1, system.count(Star));
+	BOOST_REQUIRE(system.count(Planetary) > 0);
+	BOOST_REQUIRE(system.count(DwarfPlanetary) > 0);
+
+	// The same seed gives the same catalog and another seed does not
+	auto again = generator.generate(100);
+	for (int i = 0; i < 100; i++) {
+		BOOST_REQUIRE_EQUAL(system.x()[i], again.x()[i]);
+		BOOST_REQUIRE_EQUAL(system.m()[i], again.m()[i]);
+		BOOST_REQUIRE_EQUAL(system.type(i), again.type(i));
+	}
+	generator.seed(43);
+	auto other = generator.generate(100);
+	BOOST_REQUIRE(system.x()[1] != other.x()[1]);
+
+	return;
+}
+
+/**
+ * This operation checks that written catalogs can be read by the parser.
+ */
+BOOST_AUTO_TEST_CASE(checkWrite) {
+
+	const string fileName = "catalog.csv";
+	CatalogGenerator generator(5, CatalogGenerator::Plummer);
+	generator.write(fileName, 1000);
+	CSVBodyParser parser;
+	auto bodies = parser.parseSystem(fileName);
+	auto system = generator.generate(1000);
+	BOOST_REQUIRE_EQUAL(system.size(), bodies.size());
+	for (int i = 0; i < system.size(); i++) {
+		BOOST_REQUIRE_EQUAL(system.x()[i], bodies.x()[i]);
+		BOOST_REQUIRE_EQUAL(system.vz()[i], bodies.vz()[i]);
+		BOOST_REQUIRE_EQUAL(system.m()[i], bodies.m()[i]);
+		BOOST_REQUIRE_EQUAL(system.label(i), bodies.label(i));
+		BOOST_REQUIRE_EQUAL(system.type(i), bodies.type(i));
+	}
+	remove(fileName.c_str());
+
+	BOOST_REQUIRE_THROW(generator.write("missing/catalog.csv", 10),
+			const char *);
+
+	return;
+}
+
+/**
+ * This operation checks that catalogs generated in batches are the same as
+ * catalogs generated at once.
+ */
+BOOST_AUTO_TEST_CASE(checkBatches) {
+
+	for (auto distribution : {CatalogGenerator::Uniform,
+			CatalogGenerator::Plummer, CatalogGenerator::Disk,
+			CatalogGenerator::Clustered}) {
+		CatalogGenerator generator(7, distribution);
+		BOOST_REQUIRE_EQUAL(distribution, generator.distribution());
+		auto system = generator.generate(100);
+		int next = 0, numBatches = 0;
+		generator.generate(100, 7, [&](const BodySystem & batch) {
+			BOOST_REQUIRE(batch.size() <= 7);
+			for (int i = 0; i < batch.size(); i++, next++) {
+				BOOST_REQUIRE_EQUAL(system.x()[next], batch.x()[i]);
+				BOOST_REQUIRE_EQUAL(system.vy()[next], batch.vy()[i]);
+				BOOST_REQUIRE_EQUAL(system.m()[next], batch.m()[i]);
+				BOOST_REQUIRE_EQUAL(system.label(next), batch.label(i));
+			}
+			numBatches++;
+		});
+		BOOST_REQUIRE_EQUAL(100, next);
+		BOOST_REQUIRE_EQUAL(15, numBatches);
+	}
+
+	return;
+}
+
+/**
+ * This operation checks that a Plummer sphere has the right total mass,
+ * half-mass radius and is close to virial equilibrium, 2K = -W.
+ */
+BOOST_AUTO_TEST_CASE(checkPlummer) {
+
+	int size = 2000;
+	CatalogGenerator generator(11, CatalogGenerator::Plummer);
+	generator.scale(1.0e16);
+	generator.totalMass(1.0e33);
+	auto system = generator.generate(size);
+	BOOST_REQUIRE_EQUAL(size, system.count(Star));
+
+	// The half-mass radius of a Plummer sphere is 1.305 scale radii
+	vector<double> radii(size);
+	double mass = 0.0, kinetic = 0.0;
+	for (int i = 0; i < size; i++) {
+		radii[i] = sqrt(system.x()[i] * system.x()[i]
+				+ system.y()[i] * system.y()[i]
+				+ system.z()[i] * system.z()[i]);
+		mass += system.m()[i];
+		kinetic += 0.5 * system.m()[i] * (system.vx()[i] * system.vx()[i]
+				+ system.vy()[i] * system.vy()[i]
+				+ system.vz()[i] * system.vz()[i]);
+	}
+	BOOST_REQUIRE_CLOSE(1.0e33, mass, 1.0e-10);
+	nth_element(radii.begin(), radii.begin() + size / 2, radii.end());
+	BOOST_REQUIRE_CLOSE(1.305e16, radii[size / 2], 10.0);
+
+	// Check the virial ratio
+	DirectSolver solver;
+	auto potentials = solver.getPotentials(system);
+	double potential = 0.0;
+	for (double p : potentials) {
+		potential += 0.5 * p;
+	}
+	BOOST_REQUIRE_CLOSE(1.0, -2.0 * kinetic / potential, 10.0);
+
+	return;
+}
+
+/**
+ * This operation checks that the bodies of a disk are on nearly circular
+ * orbits around the central star.
+ */
+BOOST_AUTO_TEST_CASE(checkDisk) {
+
+	CatalogGenerator generator(13, CatalogGenerator::Disk);
+	generator.scale(1.0e12);
+	generator.totalMass(2.0e30);
+	auto system = generator.generate(1000);
+	BOOST_REQUIRE_EQUAL(Star, system.type(0));
+	BOOST_REQUIRE_EQUAL(2.0e30, system.m()[0]);
+	BOOST_REQUIRE_EQUAL(1, system.count(Star));
+	// About a hundredth of the other bodies are planets
+	BOOST_REQUIRE(system.count(Planetary) > 0);
+	BOOST_REQUIRE(system.count(Planetary) < 30);
+	BOOST_REQUIRE_EQUAL(999 - system.count(Planetary),
+			system.count(DwarfPlanetary));
+	for (int i = 1; i < system.size(); i++) {
+		double r = sqrt(system.x()[i] * system.x()[i]
+				+ system.y()[i] * system.y()[i]);
+		BOOST_REQUIRE(r >= 0.99e11 && r <= 1.01e12);
+		BOOST_REQUIRE(fabs(system.z()[i]) < 0.1 * r);
+		double speed = sqrt(system.vx()[i] * system.vx()[i]
+				+ system.vy()[i] * system.vy()[i]
+				+ system.vz()[i] * system.vz()[i]);
+		BOOST_REQUIRE_CLOSE(sqrt(PotentialSolver::G * 2.0e30 / r), speed, 10.0);
+		BOOST_REQUIRE(system.m()[i] < 1.0e-5 * 2.0e30);
+	}
+
+	return;
+}
+
+/**
+ * This operation checks that clustered bodies gather around a small number
+ * of points.
+ */
+BOOST_AUTO_TEST_CASE(checkClustered) {
+
+	CatalogGenerator generator(17, CatalogGenerator::Clustered);
+	generator.clusters(0);
+	BOOST_REQUIRE_EQUAL(1, generator.clusters());
+	// Scales and masses that give no finite catalog are rejected
+	for (double bad : {0.0, -1.0, (double) NAN, (double) INFINITY}) {
+		BOOST_REQUIRE_THROW(generator.scale(bad), const char *);
+		BOOST_REQUIRE_THROW(generator.totalMass(bad), const char *);
+	}
+	generator.clusters(4);
+	generator.scale(1.0);
+	auto system = generator.generate(4000);
+
+	// Put the bodies in a coarse grid and count the cells that hold most of
+	// them. A uniform distribution would need a large part of the grid.
+	vector<int> cells(20 * 20 * 20, 0);
+	for (int i = 0; i < system.size(); i++) {
+		int cx = min(max((int) ((system.x()[i] + 1.5) / 0.15), 0), 19);
+		int cy = min(max((int) ((system.y()[i] + 1.5) / 0.15), 0), 19);
+		int cz = min(max((int) ((system.z()[i] + 1.5) / 0.15), 0), 19);
+		cells[(cx * 20 + cy) * 20 + cz]++;
+	}
+	sort(cells.rbegin(), cells.rend());
+	int numCells = 0, numBodies = 0;
+	while (numBodies < 0.8 * system.size()) {
+		numBodies += cells[numCells++];
+	}
+	BOOST_REQUIRE(numCells < 100);
+
+	return;
+}
+
+/**
+ * This operation checks that catalogs can be written to snapshots.
+ */
+BOOST_AUTO_TEST_CASE(checkSnapshot) {
+
+	const string fileName = "catalog.snap";
+	CatalogGenerator generator(19, CatalogGenerator::Disk);
+	generator.writeSnapshot(fileName, 70000);
+	auto system = generator.generate(70000);
+	BodySnapshot snapshot(fileName);
+	BOOST_REQUIRE_EQUAL(70000, snapshot.size());
+	for (int i = 0; i < system.size(); i += 997) {
+		BOOST_REQUIRE_EQUAL(system.x()[i], snapshot.x()[i]);
+		BOOST_REQUIRE_EQUAL(system.m()[i], snapshot.m()[i]);
+		BOOST_REQUIRE_EQUAL(system.label(i), snapshot.label(i));
+		BOOST_REQUIRE_EQUAL(system.type(i), snapshot.type(i));
+	}
+	BOOST_REQUIRE_EQUAL(system.label(69999), snapshot.label(69999));
+	remove(fileName.c_str());
+
+	return;
+}
@@ -0,0 +1,332 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE planets
+
+#if defined __GNUC__ && __GNUC__>=6
+  #pragma GCC diagnostic ignored "-Wwrite-strings"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+#include <vector>
+#include <random>
+#include <set>
+#include <algorithm>
+#include <math.h>
+#include "../CellList.h"
+#include "RandomSystem.h"
+
+using namespace std;
+using namespace planets;
+
+/**
+ * This operation returns the distance between a body and a point.
+ */
+double getDistance(const BodySystem & system, int i,
+		const array<double, 3> & point) {
+	double dx = system.x()[i] - point[0];
+	double dy = system.y()[i] - point[1];
+	double dz = system.z()[i] - point[2];
+	return sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+/**
+ * This operation checks that every body of the list is in the cell that
+ * holds its position and appears exactly once.
+ */
+void checkCells(const BodySystem & system, const CellList & cells) {
+	BOOST_REQUIRE_EQUAL(system.size(), cells.size());
+	vector<int> seen(system.size(), 0);
+	for (int c = 0; c < cells.cellCount(); c++) {
+		for (int k = cells.begin(c); k < cells.end(c); k++) {
+			int i = cells.indices()[k];
+			seen[i]++;
+			BOOST_REQUIRE_EQUAL(c, cells.cellOf(i));
+			BOOST_REQUIRE_EQUAL(system.x()[i], cells.x()[k]);
+			BOOST_REQUIRE_EQUAL(system.y()[i], cells.y()[k]);
+			BOOST_REQUIRE_EQUAL(system.z()[i], cells.z()[k]);
+			int coords[3] = { c % cells.dimensions()[0],
+					(c / cells.dimensions()[0]) % cells.dimensions()[1],
+					c / (cells.dimensions()[0] * cells.dimensions()[1]) };
+			const double * pos[3] = { cells.x(), cells.y(), cells.z() };
+			for (int d = 0; d < 3; d++) {
+				double lower = cells.origin()[d]
+						+ coords[d] * cells.widths()[d];
+				BOOST_REQUIRE(pos[d][k] >= lower - 1.0e-9);
+				BOOST_REQUIRE(pos[d][k] <= lower + cells.widths()[d] + 1.0e-9);
+			}
+		}
+	}
+	BOOST_REQUIRE(count(seen.begin(), seen.end(), 1) == system.size());
+}
+
+/**
+ * This operation checks that every body is sorted into the cell that
+ * contains it.
+ */
+BOOST_AUTO_TEST_CASE(checkBuild) {
+
+	auto system = getRandomSystem(1000, 10.0, 1.0, 1.0);
+	CellList cells(system, 1.5);
+	BOOST_REQUIRE_EQUAL(1000, cells.size());
+	BOOST_REQUIRE_EQUAL(6 * 6 * 6, cells.cellCount());
+	for (int k = 0; k < 3; k++) {
+		BOOST_REQUIRE_EQUAL(6, cells.dimensions()[k]);
+		BOOST_REQUIRE(cells.widths()[k] >= 1.5);
+	}
+
+	set<int> found;
+	for (int c = 0; c < cells.cellCount(); c++) {
+		for (int k = cells.begin(c); k < cells.end(c); k++) {
+			int i = cells.indices()[k];
+			found.insert(i);
+			BOOST_REQUIRE_EQUAL(c, cells.cellOf(i));
+			BOOST_REQUIRE_EQUAL(system.x()[i], cells.x()[k]);
+			BOOST_REQUIRE_EQUAL(system.y()[i], cells.y()[k]);
+			BOOST_REQUIRE_EQUAL(system.z()[i], cells.z()[k]);
+			int ix = c % 6, iy = (c / 6) % 6, iz = c / 36;
+			BOOST_REQUIRE_EQUAL(c, cells.cell(ix, iy, iz));
+			double lowerX = cells.origin()[0] + ix * cells.widths()[0];
+			BOOST_REQUIRE(cells.x()[k] >= lowerX - 1.0e-12);
+			BOOST_REQUIRE(cells.x()[k] <= lowerX + cells.widths()[0] + 1.0e-12);
+		}
+	}
+	BOOST_REQUIRE_EQUAL(1000, found.size());
+
+	return;
+}
+
+/**
+ * This operation checks that every pair closer than the minimum width is in
+ * neighboring cells.
+ */
+BOOST_AUTO_TEST_CASE(checkNeighbors) {
+
+	auto system = getRandomSystem(400, 5.0, 1.0, 1.0);
+	double width = 0.7;
+	CellList cells(system, width);
+	int neighborCells[27];
+	BOOST_REQUIRE_EQUAL(27, cells.neighbors(cells.cell(1, 1, 1),
+			neighborCells));
+	BOOST_REQUIRE_EQUAL(8, cells.neighbors(cells.cell(0, 0, 0),
+			neighborCells));
+	for (int i = 0; i < system.size(); i++) {
+		int numNeighbors = cells.neighbors(cells.cellOf(i), neighborCells);
+		set<int> near(neighborCells, neighborCells + numNeighbors);
+		for (int j = 0; j < system.size(); j++) {
+			double dx = system.x()[i] - system.x()[j];
+			double dy = system.y()[i] - system.y()[j];
+			double dz = system.z()[i] - system.z()[j];
+			if (dx * dx + dy * dy + dz * dz < width * width) {
+				BOOST_REQUIRE(near.count(cells.cellOf(j)));
+			}
+		}
+	}
+
+	return;
+}
+
+/**
+ * This operation checks that the number of cells stays bounded when the
+ * bodies are far apart, and the edge cases.
+ */
+BOOST_AUTO_TEST_CASE(checkLimits) {
+
+	auto system = getRandomSystem(10, 1.0e12, 1.0, 1.0);
+	CellList cells(system, 1.0);
+	BOOST_REQUIRE(cells.cellCount() <= 2 * 10 + 26);
+	for (int k = 0; k < 3; k++) {
+		BOOST_REQUIRE(cells.widths()[k] >= 1.0);
+	}
+	BOOST_REQUIRE_EQUAL(10, cells.end(cells.cellCount() - 1));
+
+	BodySystem empty;
+	cells.build(empty, 1.0);
+	BOOST_REQUIRE_EQUAL(0, cells.size());
+	BOOST_REQUIRE_EQUAL(1, cells.cellCount());
+
+	BOOST_REQUIRE_THROW(cells.build(system, 0.0), const char *);
+
+	return;
+}
+
+/**
+ * This operation checks the range queries against a linear scan, including
+ * spheres that are larger than the cells or outside of the grid.
+ */
+BOOST_AUTO_TEST_CASE(checkRange) {
+
+	auto system = getRandomSystem(2000, 10.0, 1.0, 1.0);
+	CellList cells(system, 1.0);
+	mt19937 rng(42);
+	uniform_real_distribution<double> position(-2.0, 12.0), size(0.0, 4.0);
+	vector<int> found;
+	for (int query = 0; query < 200; query++) {
+		array<double, 3> point = {position(rng), position(rng),
+				position(rng)};
+		double radius = size(rng);
+		cells.range(point, radius, found);
+		sort(found.begin(), found.end());
+		vector<int> expected;
+		for (int i = 0; i < system.size(); i++) {
+			if (getDistance(system, i, point) <= radius) {
+				expected.push_back(i);
+			}
+		}
+		BOOST_REQUIRE(found == expected);
+	}
+	cells.range({100.0, 100.0, 100.0}, 1.0, found);
+	BOOST_REQUIRE(found.empty());
+
+	return;
+}
+
+/**
+ * This operation checks the nearest neighbor queries against a linear scan.
+ */
+BOOST_AUTO_TEST_CASE(checkNearest) {
+
+	auto system = getRandomSystem(1000, 10.0, 1.0, 1.0);
+	CellList cells(system, 0.5);
+	mt19937 rng(42);
+	uniform_real_distribution<double> position(-5.0, 15.0);
+	vector<int> found;
+	vector<double> distances;
+	for (int query = 0; query < 200; query++) {
+		array<double, 3> point = {position(rng), position(rng),
+				position(rng)};
+		int exclude = query % 2 ? query : -1;
+		vector<pair<double, int>> expected;
+		for (int i = 0; i < system.size(); i++) {
+			if (i != exclude) {
+				expected.push_back({getDistance(system, i, point), i});
+			}
+		}
+		sort(expected.begin(), expected.end());
+		int k = 1 + query % 9;
+		cells.nearest(point, k, found, distances, exclude);
+		BOOST_REQUIRE_EQUAL(k, found.size());
+		for (int n = 0; n < k; n++) {
+			BOOST_REQUIRE_EQUAL(expected[n].second, found[n]);
+			BOOST_REQUIRE_CLOSE(expected[n].first, distances[n], 1.0e-10);
+		}
+		BOOST_REQUIRE_EQUAL(expected[0].second, cells.nearest(point, exclude));
+	}
+
+	// The nearest neighbor of a body, and more neighbors than bodies
+	array<double, 3> point = {system.x()[7], system.y()[7], system.z()[7]};
+	BOOST_REQUIRE_EQUAL(7, cells.nearest(point));
+	BOOST_REQUIRE(cells.nearest(point, 7) != 7);
+	cells.nearest(point, 5000, found, distances);
+	BOOST_REQUIRE_EQUAL(1000, found.size());
+	BOOST_REQUIRE(is_sorted(distances.begin(), distances.end()));
+
+	return;
+}
+
+/**
+ * This operation checks the close pairs against a linear scan, for
+ * distances smaller and larger than the cells.
+ */
+BOOST_AUTO_TEST_CASE(checkClosePairs) {
+
+	auto system = getRandomSystem(800, 10.0, 1.0, 1.0);
+	CellList cells(system, 1.0);
+	vector<pair<int, int>> pairs;
+	for (double distance : {0.3, 1.0, 2.5}) {
+		cells.closePairs(distance, pairs);
+		vector<pair<int, int>> expected;
+		for (int i = 0; i < system.size(); i++) {
+			array<double, 3> point = {system.x()[i], system.y()[i],
+					system.z()[i]};
+			for (int j = i + 1; j < system.size(); j++) {
+				if (getDistance(system, j, point) < distance) {
+					expected.push_back({i, j});
+				}
+			}
+		}
+		BOOST_REQUIRE(!expected.empty());
+		BOOST_REQUIRE(pairs == expected);
+	}
+
+	return;
+}
+
+/**
+ * This operation checks that updates only move the bodies that changed
+ * cells and build the list again when a body leaves the grid.
+ */
+BOOST_AUTO_TEST_CASE(checkUpdate) {
+
+	auto system = getRandomSystem(2000, 10.0, 1.0, 1.0);
+	CellList cells(system, 1.0);
+	auto dims = cells.dimensions();
+
+	// Bodies that stay in their cells only update the positions
+	for (int i = 0; i < system.size(); i++) {
+		double c = floor((system.z()[i] - cells.origin()[2])
+				/ cells.widths()[2]);
+		system.z()[i] = cells.origin()[2]
+				+ (min(c, dims[2] - 1.0) + 0.5) * cells.widths()[2];
+	}
+	BOOST_REQUIRE_EQUAL(0, cells.update(system));
+	checkCells(system, cells);
+
+	// Small moves change the cells of a few bodies
+	mt19937 rng(42);
+	uniform_real_distribution<double> step(-0.2, 0.2);
+	for (int i = 0; i < system.size(); i++) {
+		system.x()[i] = min(max(system.x()[i] + step(rng),
+				cells.origin()[0]), cells.origin()[0] + 9.9);
+	}
+	int numMoved = cells.update(system);
+	BOOST_REQUIRE(numMoved > 0);
+	BOOST_REQUIRE(numMoved < system.size() / 2);
+	BOOST_REQUIRE(cells.dimensions() == dims);
+	checkCells(system, cells);
+	vector<int> found;
+	array<double, 3> point = {5.0, 5.0, 5.0};
+	cells.range(point, 2.0, found);
+	int numInside = 0;
+	for (int i = 0; i < system.size(); i++) {
+		numInside += getDistance(system, i, point) <= 2.0;
+	}
+	BOOST_REQUIRE_EQUAL(numInside, found.size());
+
+	// A body outside of the grid needs a new one
+	system.x()[3] = 50.0;
+	BOOST_REQUIRE_EQUAL(-1, cells.update(system));
+	checkCells(system, cells);
+	BOOST_REQUIRE(cells.dimensions() != dims);
+
+	return;
+}
@@ -0,0 +1,116 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE planets
+
+#if defined __GNUC__ && __GNUC__>=6
+  #pragma GCC diagnostic ignored "-Wwrite-strings"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+#include <vector>
+#include <math.h>
+#include "../DirectSolver.h"
+#include "RandomSystem.h"
+
+using namespace std;
+using namespace planets;
+
+/**
+ * This operation checks that the batch potentials match the per-body
+ * potentials from CelestialBody.
+ */
+BOOST_AUTO_TEST_CASE(checkPotentials) {
+
+	auto bodies = getRandomSystem(100).bodies();
+
+	DirectSolver solver;
+	const PotentialSolver & base = solver;
+	auto potentials = base.getPotentials(bodies);
+	BOOST_REQUIRE_EQUAL(bodies.size(), potentials.size());
+	for (int i = 0; i < bodies.size(); i++) {
+		BOOST_REQUIRE_CLOSE(bodies[i].getGravitationalPotential(bodies, i),
+				potentials[i], 1.0e-12);
+	}
+
+	return;
+}
+
+/**
+ * This operation checks that the results do not depend on the number of
+ * threads or the block size.
+ */
+BOOST_AUTO_TEST_CASE(checkThreads) {
+
+	auto system = getRandomSystem(1000);
+
+	DirectSolver solver;
+	BOOST_REQUIRE_EQUAL(1, solver.threads());
+	auto serial = solver.getPotentials(system);
+	solver.threads(4);
+	solver.blockSize(13);
+	BOOST_REQUIRE_EQUAL(4, solver.threads());
+	BOOST_REQUIRE_EQUAL(13, solver.blockSize());
+	auto parallel = solver.getPotentials(system);
+	for (int i = 0; i < system.size(); i++) {
+		BOOST_REQUIRE_EQUAL(serial[i], parallel[i]);
+	}
+
+	return;
+}
+
+/**
+ * This operation checks that symmetric mode matches the normal mode for
+ * block counts that are odd, even and one, and for any number of threads.
+ */
+BOOST_AUTO_TEST_CASE(checkSymmetric) {
+
+	auto system = getRandomSystem(1001);
+
+	DirectSolver direct;
+	auto ref = direct.getPotentials(system);
+	DirectSolver solver(true);
+	BOOST_REQUIRE(solver.symmetric());
+	for (int block : {64, 100, 2000}) {
+		solver.blockSize(block);
+		solver.threads(1);
+		auto serial = solver.getPotentials(system);
+		solver.threads(3);
+		auto parallel = solver.getPotentials(system);
+		for (int i = 0; i < system.size(); i++) {
+			BOOST_REQUIRE_CLOSE(ref[i], serial[i], 1.0e-10);
+			BOOST_REQUIRE_EQUAL(serial[i], parallel[i]);
+		}
+	}
+
+	return;
+}
@@ -0,0 +1,117 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE planets
+
+#if defined __GNUC__ && __GNUC__>=6
+  #pragma GCC diagnostic ignored "-Wwrite-strings"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+#include <vector>
+#include <math.h>
+#include "../FMMSolver.h"
+#include "../DirectSolver.h"
+#include "RandomSystem.h"
+
+using namespace std;
+using namespace planets;
+
+/**
+ * This operation computes the largest relative error of a solver with
+ * respect to direct summation.
+ */
+double getMaxError(const vector<CelestialBody> & bodies,
+		const PotentialSolver & solver) {
+	DirectSolver direct;
+	auto ref = direct.getPotentials(bodies);
+	auto potentials = solver.getPotentials(bodies);
+	double maxError = 0.0;
+	for (int i = 0; i < bodies.size(); i++) {
+		maxError = max(maxError, fabs((potentials[i] - ref[i]) / ref[i]));
+	}
+	return maxError;
+}
+
+/**
+ * This operation checks the accuracy of the FMM against direct summation and
+ * that it improves with the expansion order.
+ */
+BOOST_AUTO_TEST_CASE(checkAccuracy) {
+
+	auto bodies = getRandomSystem(3000, 1.0, 1.0e10, 2.0e10, true).bodies();
+	FMMSolver solver(2);
+	BOOST_REQUIRE_EQUAL(2, solver.order());
+	double lowError = getMaxError(bodies, solver);
+	solver.order(6);
+	double highError = getMaxError(bodies, solver);
+	BOOST_REQUIRE_SMALL(lowError, 5.0e-2);
+	BOOST_REQUIRE_SMALL(highError, 1.0e-3);
+	BOOST_REQUIRE(highError < lowError);
+
+	return;
+}
+
+/**
+ * This operation checks that a monopole with a small opening angle still
+ * converges and that bad parameters are rejected.
+ */
+BOOST_AUTO_TEST_CASE(checkParameters) {
+
+	auto bodies = getRandomSystem(500, 1.0, 1.0e10, 2.0e10, true).bodies();
+	FMMSolver solver(0, 0.2);
+	BOOST_REQUIRE_CLOSE(0.2, solver.theta(), 1.0e-15);
+	BOOST_REQUIRE_SMALL(getMaxError(bodies, solver), 1.0e-1);
+	solver.theta(1.5);
+	BOOST_REQUIRE_THROW(solver.getPotentials(bodies), const char *);
+	BOOST_REQUIRE(FMMSolver().getPotentials(vector<CelestialBody>()).empty());
+
+	return;
+}
+
+/**
+ * This operation checks that the results do not depend on the number of
+ * threads.
+ */
+BOOST_AUTO_TEST_CASE(checkThreads) {
+
+	auto bodies = getRandomSystem(3000, 1.0, 1.0e10, 2.0e10, true).bodies();
+	FMMSolver solver;
+	auto serial = solver.getPotentials(bodies);
+	solver.threads(4);
+	auto parallel = solver.getPotentials(bodies);
+	for (int i = 0; i < bodies.size(); i++) {
+		BOOST_REQUIRE_EQUAL(serial[i], parallel[i]);
+	}
+
+	return;
+}
@@ -0,0 +1,152 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE planets
+
+#if defined __GNUC__ && __GNUC__>=6
+  #pragma GCC diagnostic ignored "-Wwrite-strings"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+#include <vector>
+#include <random>
+#include "../IncrementalSolver.h"
+#include "../DirectSolver.h"
+#include "RandomSystem.h"
+
+using namespace std;
+using namespace planets;
+
+/**
+ * This function checks a set of potentials against direct summation.
+ * @param bodies the bodies
+ * @param potentials the potentials
+ */
+void checkAgainstDirect(const vector<CelestialBody> & bodies,
+		const vector<double> & potentials) {
+	DirectSolver direct;
+	auto refPotentials = direct.getPotentials(bodies);
+	BOOST_REQUIRE_EQUAL(refPotentials.size(), potentials.size());
+	for (int i = 0; i < potentials.size(); i++) {
+		BOOST_REQUIRE_CLOSE(refPotentials[i], potentials[i], 1.0e-9);
+	}
+}
+
+/**
+ * This operation checks that moving bodies and changing their masses with
+ * the setters gives the same potentials as starting over, and that only
+ * the changed bodies are recomputed.
+ */
+BOOST_AUTO_TEST_CASE(checkUpdates) {
+
+	auto bodies = getRandomSystem(500, 2.0e9, 1.0e24, 1.6e24).bodies();
+	IncrementalSolver solver(1000);
+	solver.threads(2);
+	mt19937 rng(654321);
+	uniform_int_distribution<int> pick(0, bodies.size() - 1);
+	uniform_real_distribution<double> shift(-1.0e8, 1.0e8);
+
+	// The first call is a full recompute
+	checkAgainstDirect(bodies, solver.getPotentials(bodies));
+	BOOST_REQUIRE_EQUAL(1, solver.fullRecomputes());
+
+	for (int update = 0; update < 50; update++) {
+		// Move a few bodies and change the mass of one of them
+		int numMoved = 1 + update % 5;
+		for (int k = 0; k < numMoved; k++) {
+			auto & body = bodies[pick(rng)];
+			auto pos = body.pos();
+			pos[0] += shift(rng);
+			pos[2] += shift(rng);
+			body.pos(pos);
+		}
+		bodies[pick(rng)].mass(1.0e24 * (1 + update % 3));
+		auto potentials = solver.getPotentials(bodies);
+		BOOST_REQUIRE_LE(solver.changedBodies(), numMoved + 1);
+		checkAgainstDirect(bodies, potentials);
+	}
+	BOOST_REQUIRE_EQUAL(1, solver.fullRecomputes());
+
+	// Nothing changed, so nothing should be recomputed
+	solver.getPotentials(bodies);
+	BOOST_REQUIRE_EQUAL(0, solver.changedBodies());
+
+	// A massless body still gets a field, which shows up once it gets mass
+	bodies[3].mass(0.0);
+	checkAgainstDirect(bodies, solver.getPotentials(bodies));
+	bodies[3].mass(2.0e24);
+	checkAgainstDirect(bodies, solver.getPotentials(bodies));
+	BOOST_REQUIRE_EQUAL(1, solver.fullRecomputes());
+
+	// Adding a body forces a full recompute
+	auto newBody = bodies[0];
+	newBody.pos({1.0e10, 0.0, 0.0});
+	bodies.push_back(newBody);
+	checkAgainstDirect(bodies, solver.getPotentials(bodies));
+	BOOST_REQUIRE_EQUAL(2, solver.fullRecomputes());
+
+	return;
+}
+
+/**
+ * This operation checks that the sums are recomputed periodically and when
+ * most bodies change.
+ */
+BOOST_AUTO_TEST_CASE(checkRecomputes) {
+
+	auto bodies = getRandomSystem(100, 2.0e9, 1.0e24, 1.6e24).bodies();
+	IncrementalSolver solver(3);
+	BOOST_REQUIRE_EQUAL(3, solver.recomputeInterval());
+
+	solver.getPotentials(bodies);
+	for (int update = 1; update <= 8; update++) {
+		bodies[update].mass(2.0e24);
+		solver.getPotentials(bodies);
+	}
+	// One at the start and one after every three incremental updates
+	BOOST_REQUIRE_EQUAL(3, solver.fullRecomputes());
+
+	// Change most of the bodies
+	for (int i = 0; i < 60; i++) {
+		bodies[i].mass(3.0e24);
+	}
+	checkAgainstDirect(bodies, solver.getPotentials(bodies));
+	BOOST_REQUIRE_EQUAL(4, solver.fullRecomputes());
+	BOOST_REQUIRE_EQUAL(100, solver.changedBodies());
+
+	// Reset starts over
+	solver.reset();
+	solver.getPotentials(bodies);
+	BOOST_REQUIRE_EQUAL(5, solver.fullRecomputes());
+
+	return;
+}
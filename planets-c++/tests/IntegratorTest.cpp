@@ -0,0 +1,286 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE planets
+
+#if defined __GNUC__ && __GNUC__>=6
+  #pragma GCC diagnostic ignored "-Wwrite-strings"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+#include <vector>
+#include <math.h>
+#include "../DirectSolver.h"
+#include "../BarnesHutSolver.h"
+#include "../LeapfrogIntegrator.h"
+#include "../HermiteIntegrator.h"
+#include "../BlockTimestepIntegrator.h"
+#include "RandomSystem.h"
+
+using namespace std;
+using namespace planets;
+
+/**
+ * This function creates a binary of two equal masses on a circular orbit of
+ * radius 1 around their center of mass. The masses are chosen so that
+ * G m = 1, which makes the speed 1/2 and the period 4 pi.
+ * @return the binary
+ */
+BodySystem getBinary() {
+	BodySystem system;
+	CelestialBodyData data;
+	data.mass = 1.0 / PotentialSolver::G;
+	data.type = Star;
+	data.pos = {1.0, 0.0, 0.0};
+	data.vel = {0.0, 0.5, 0.0};
+	data.label = "A";
+	system.add(data);
+	data.pos = {-1.0, 0.0, 0.0};
+	data.vel = {0.0, -0.5, 0.0};
+	data.label = "B";
+	system.add(data);
+	return system;
+}
+
+/**
+ * This function integrates the binary over one period and returns the
+ * distance of the first body from where it started.
+ * @param integrator the integrator
+ * @param numSteps the number of steps in the period
+ * @return the error
+ */
+double getOrbitError(Integrator & integrator, int numSteps) {
+	auto system = getBinary();
+	integrator.reset();
+	integrator.run(system, 4.0 * M_PI / numSteps, numSteps);
+	double dx = system.x()[0] - 1.0, dy = system.y()[0], dz = system.z()[0];
+	return sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+/**
+ * This operation checks the accelerations and jerks of the solvers against
+ * the binary, where they are known exactly.
+ */
+BOOST_AUTO_TEST_CASE(checkAccelerations) {
+
+	auto system = getBinary();
+	vector<double> ax(2), ay(2), az(2), jx(2), jy(2), jz(2);
+
+	// The separation is 2 and G m = 1, so |a| = 1/4 toward the center.
+	DirectSolver direct;
+	direct.getAccelerationsAndJerks(system, ax.data(), ay.data(), az.data(),
+			jx.data(), jy.data(), jz.data());
+	BOOST_REQUIRE_CLOSE(-0.25, ax[0], 1.0e-12);
+	BOOST_REQUIRE_CLOSE(0.25, ax[1], 1.0e-12);
+	BOOST_REQUIRE_SMALL(ay[0], 1.0e-15);
+	// On a circular orbit the jerk is -w^2 v with w = 1/2
+	BOOST_REQUIRE_CLOSE(-0.125, jy[0], 1.0e-12);
+	BOOST_REQUIRE_CLOSE(0.125, jy[1], 1.0e-12);
+	BOOST_REQUIRE_SMALL(jx[0], 1.0e-15);
+
+	// Barnes-Hut with theta = 0 is direct summation
+	BodySystem cloud = getRandomSystem(500, 2.0, 0.0, 2.0);
+	vector<double> refX(500), refY(500), refZ(500), bhX(500), bhY(500),
+			bhZ(500);
+	direct.getAccelerations(cloud, refX.data(), refY.data(), refZ.data());
+	BarnesHutSolver exactTree(0.0);
+	exactTree.getAccelerations(cloud, bhX.data(), bhY.data(), bhZ.data());
+	for (int i = 0; i < 500; i++) {
+		BOOST_REQUIRE_CLOSE(refX[i], bhX[i], 1.0e-8);
+		BOOST_REQUIRE_CLOSE(refY[i], bhY[i], 1.0e-8);
+		BOOST_REQUIRE_CLOSE(refZ[i], bhZ[i], 1.0e-8);
+	}
+
+	// Barnes-Hut with the default opening angle is close, on several threads
+	BarnesHutSolver tree;
+	tree.threads(4);
+	tree.getAccelerations(cloud, bhX.data(), bhY.data(), bhZ.data());
+	double error = 0.0, norm = 0.0;
+	for (int i = 0; i < 500; i++) {
+		double dx = bhX[i] - refX[i], dy = bhY[i] - refY[i],
+				dz = bhZ[i] - refZ[i];
+		error += dx * dx + dy * dy + dz * dz;
+		norm += refX[i] * refX[i] + refY[i] * refY[i] + refZ[i] * refZ[i];
+	}
+	BOOST_REQUIRE_LT(sqrt(error / norm), 1.0e-2);
+
+	return;
+}
+
+/**
+ * This operation checks that the leapfrog integrator is second order and
+ * conserves the energy of the binary.
+ */
+BOOST_AUTO_TEST_CASE(checkLeapfrog) {
+
+	DirectSolver direct;
+	LeapfrogIntegrator leapfrog(direct);
+
+	// Halving the step should cut the error by four
+	double coarse = getOrbitError(leapfrog, 200);
+	double fine = getOrbitError(leapfrog, 400);
+	BOOST_REQUIRE_LT(coarse, 0.1);
+	BOOST_REQUIRE_GT(coarse / fine, 3.5);
+	BOOST_REQUIRE_LT(coarse / fine, 4.5);
+	BOOST_REQUIRE_EQUAL(600, leapfrog.steps());
+	BOOST_REQUIRE_GT(leapfrog.stepsPerSecond(), 0.0);
+
+	// The separation of a circular orbit should stay close to 2 over many
+	// orbits, since the scheme does not drift.
+	auto system = getBinary();
+	leapfrog.reset();
+	leapfrog.run(system, 4.0 * M_PI / 100, 1000);
+	double dx = system.x()[0] - system.x()[1];
+	double dy = system.y()[0] - system.y()[1];
+	BOOST_REQUIRE_CLOSE(2.0, sqrt(dx * dx + dy * dy), 1.0);
+
+	// The center of mass should not move
+	BOOST_REQUIRE_SMALL(system.x()[0] + system.x()[1], 1.0e-10);
+	BOOST_REQUIRE_SMALL(system.y()[0] + system.y()[1], 1.0e-10);
+
+	return;
+}
+
+/**
+ * This operation checks that the Hermite integrator is fourth order and
+ * much more accurate than leapfrog.
+ */
+BOOST_AUTO_TEST_CASE(checkHermite) {
+
+	DirectSolver direct;
+	HermiteIntegrator hermite(direct);
+	LeapfrogIntegrator leapfrog(direct);
+
+	// Halving the step should cut the error by sixteen
+	double coarse = getOrbitError(hermite, 100);
+	double fine = getOrbitError(hermite, 200);
+	BOOST_REQUIRE_GT(coarse / fine, 12.0);
+	BOOST_REQUIRE_LT(coarse / fine, 20.0);
+	BOOST_REQUIRE_LT(coarse, 1.0e-2 * getOrbitError(leapfrog, 100));
+
+	return;
+}
+
+/**
+ * This function creates a hierarchical system with a star, a fast inner
+ * planet and slow outer planets on circular orbits. The star has G M = 1 and
+ * the planets are light enough to barely disturb it.
+ * @param numOuter the number of outer planets
+ * @return the system
+ */
+BodySystem getHierarchicalSystem(int numOuter) {
+	BodySystem system;
+	CelestialBodyData data;
+	data.pos = {0.0, 0.0, 0.0};
+	data.vel = {0.0, 0.0, 0.0};
+	data.mass = 1.0 / PotentialSolver::G;
+	data.type = Star;
+	system.add(data);
+	data.mass = 1.0e-9 / PotentialSolver::G;
+	data.type = Planetary;
+	for (int i = 0; i <= numOuter; i++) {
+		// The inner planet is at 0.1 and the others are spread out beyond 1
+		double radius = (i == 0) ? 0.1 : 1.0 + i, angle = 0.7 * i;
+		double speed = sqrt(1.0 / radius);
+		data.pos = {radius * cos(angle), radius * sin(angle), 0.0};
+		data.vel = {-speed * sin(angle), speed * cos(angle), 0.0};
+		system.add(data);
+	}
+	return system;
+}
+
+/**
+ * This operation checks that block time steps reproduce leapfrog when there
+ * is only one level and that they match a fine global step on a
+ * hierarchical system with far fewer force evaluations.
+ */
+BOOST_AUTO_TEST_CASE(checkBlockTimesteps) {
+
+	DirectSolver direct;
+
+	// A single level is plain leapfrog
+	auto refSystem = getHierarchicalSystem(4);
+	auto system = refSystem;
+	LeapfrogIntegrator leapfrog(direct);
+	BlockTimestepIntegrator singleLevel(direct, 1.0e-3, 0.025, 0);
+	leapfrog.run(refSystem, 0.01, 20);
+	singleLevel.run(system, 0.01, 20);
+	for (int i = 0; i < system.size(); i++) {
+		BOOST_REQUIRE_EQUAL(refSystem.x()[i], system.x()[i]);
+		BOOST_REQUIRE_EQUAL(refSystem.vy()[i], system.vy()[i]);
+	}
+	BOOST_REQUIRE_EQUAL(leapfrog.forceEvaluations(),
+			singleLevel.forceEvaluations());
+
+	// Integrate the hierarchical system for one orbit of the first outer
+	// planet with block steps, on both backends, and with a global step
+	// that is as small as the finest block step.
+	int numOuter = 20, numSteps = 64;
+	double dt = 2.0 * M_PI * pow(2.0, 1.5) / numSteps;
+	refSystem = getHierarchicalSystem(numOuter);
+	auto treeSystem = refSystem;
+	system = refSystem;
+	BlockTimestepIntegrator block(direct, 1.0e-3);
+	block.run(system, dt, numSteps);
+	LeapfrogIntegrator fineLeapfrog(direct);
+	fineLeapfrog.run(refSystem, dt / (1 << block.maxLevel()),
+			numSteps << block.maxLevel());
+	BarnesHutSolver tree(0.5, 1);
+	BlockTimestepIntegrator treeBlock(tree, 1.0e-3);
+	treeBlock.run(treeSystem, dt, numSteps);
+
+	// The inner planet should be on a fine level and the outer ones on
+	// coarse levels
+	BOOST_REQUIRE_GT(block.levels()[1], block.levels()[numOuter + 1] + 2);
+
+	// The orbits should match closely
+	for (int i = 0; i < system.size(); i++) {
+		double dx = system.x()[i] - refSystem.x()[i];
+		double dy = system.y()[i] - refSystem.y()[i];
+		BOOST_REQUIRE_SMALL(sqrt(dx * dx + dy * dy), 1.0e-3);
+		dx = treeSystem.x()[i] - system.x()[i];
+		dy = treeSystem.y()[i] - system.y()[i];
+		BOOST_REQUIRE_SMALL(sqrt(dx * dx + dy * dy), 1.0e-3);
+	}
+	// The inner orbit should still be circular
+	double radius = sqrt(pow(system.x()[1] - system.x()[0], 2.0)
+			+ pow(system.y()[1] - system.y()[0], 2.0));
+	BOOST_REQUIRE_CLOSE(0.1, radius, 1.0);
+
+	// It should need far fewer force evaluations
+	BOOST_REQUIRE_LT(10 * block.forceEvaluations(),
+			fineLeapfrog.forceEvaluations());
+	BOOST_REQUIRE_EQUAL(block.forceEvaluations(),
+			treeBlock.forceEvaluations());
+
+	return;
+}
@@ -0,0 +1,109 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE planets
+
+#if defined __GNUC__ && __GNUC__>=6
+  #pragma GCC diagnostic ignored "-Wwrite-strings"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+#include <string>
+#include <cstdint>
+#include "../LabelTable.h"
+
+using namespace std;
+using namespace planets;
+
+/**
+ * This operation checks adding, reading and replacing labels.
+ */
+BOOST_AUTO_TEST_CASE(checkLabels) {
+
+	LabelTable table;
+	table.add("Kitten");
+	table.add("");
+	table.add(string("Momma cat"));
+	BOOST_REQUIRE_EQUAL(3, table.size());
+	BOOST_REQUIRE_EQUAL("Kitten", table.get(0));
+	BOOST_REQUIRE_EQUAL("", table.get(1));
+	BOOST_REQUIRE_EQUAL("Momma cat", table.get(2));
+	BOOST_REQUIRE_EQUAL(9, table.length(2));
+	BOOST_REQUIRE_EQUAL(0, string(table.data(2), 5).compare("Momma"));
+
+	// Replace with a shorter label, which fits in place, and a longer one
+	table.set(0, "Cat", 3);
+	table.set(1, "Tiger", 5);
+	BOOST_REQUIRE_EQUAL("Cat", table.get(0));
+	BOOST_REQUIRE_EQUAL("Tiger", table.get(1));
+	BOOST_REQUIRE_EQUAL("Momma cat", table.get(2));
+
+	// Replace with a label from the table itself
+	table.set(0, table.data(2), table.length(2));
+	BOOST_REQUIRE_EQUAL("Momma cat", table.get(0));
+
+	// Growing adds empty labels and shrinking drops them
+	table.resize(5);
+	BOOST_REQUIRE_EQUAL("", table.get(4));
+	table.resize(2);
+	BOOST_REQUIRE_EQUAL(2, table.size());
+	BOOST_REQUIRE_EQUAL("Tiger", table.get(1));
+
+	return;
+}
+
+/**
+ * This operation checks assigning packed labels and appending tables.
+ */
+BOOST_AUTO_TEST_CASE(checkAssignAndAppend) {
+
+	const char chars[] = "SunEarthMoon";
+	const uint64_t offsets[] = {0, 3, 8, 8, 12};
+	LabelTable table;
+	table.assign(4, chars, offsets);
+	BOOST_REQUIRE_EQUAL(4, table.size());
+	BOOST_REQUIRE_EQUAL("Sun", table.get(0));
+	BOOST_REQUIRE_EQUAL("Earth", table.get(1));
+	BOOST_REQUIRE_EQUAL("", table.get(2));
+	BOOST_REQUIRE_EQUAL("Moon", table.get(3));
+
+	LabelTable other;
+	other.add("Mars");
+	table.append(other);
+	table.append(table);
+	BOOST_REQUIRE_EQUAL(10, table.size());
+	BOOST_REQUIRE_EQUAL("Mars", table.get(4));
+	BOOST_REQUIRE_EQUAL("Sun", table.get(5));
+	BOOST_REQUIRE_EQUAL("Mars", table.get(9));
+
+	return;
+}
@@ -0,0 +1,157 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE planets
+
+#if defined __GNUC__ && __GNUC__>=6
+  #pragma GCC diagnostic ignored "-Wwrite-strings"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+#include <vector>
+#include <math.h>
+#include "../MixedPrecisionSolver.h"
+#include "../DirectSolver.h"
+#include "RandomSystem.h"
+
+using namespace std;
+using namespace planets;
+
+/**
+ * This operation checks every instruction set that this processor supports
+ * and every accumulation mode against direct summation, including system
+ * sizes that do not fill the vectors.
+ */
+BOOST_AUTO_TEST_CASE(checkKernels) {
+
+	SIMDInstructionSet sets[4] = { ScalarInstructions, SSE2Instructions,
+			AVX2Instructions, AVX512Instructions };
+	AccumulationMode modes[3] = { FloatAccumulation, CompensatedAccumulation,
+			DoubleAccumulation };
+	DirectSolver direct;
+	for (int size : {1, 2, 7, 17, 100, 1000}) {
+		auto bodies = getRandomSystem(size).bodies();
+		auto ref = direct.getPotentials(bodies);
+		for (auto isa : sets) {
+			if (isa > SIMDSolver::detectInstructionSet()) {
+				continue;
+			}
+			for (auto mode : modes) {
+				MixedPrecisionSolver solver(isa, mode);
+				BOOST_REQUIRE_EQUAL(isa, solver.instructionSet());
+				BOOST_REQUIRE_EQUAL(mode, solver.accumulation());
+				auto potentials = solver.getPotentials(bodies);
+				BOOST_REQUIRE_EQUAL(size, potentials.size());
+				for (int i = 0; i < size; i++) {
+					// BOOST_REQUIRE_CLOSE takes percent
+					BOOST_REQUIRE_CLOSE(ref[i], potentials[i], 1.0e-3);
+				}
+			}
+		}
+	}
+
+	return;
+}
+
+/**
+ * This operation checks that two distinct bodies at the same position get
+ * an infinite potential in every kernel and accumulation mode, as they do
+ * in double precision, and that the other bodies are not disturbed. The
+ * pair sits in different vectors so that terms are still added after the
+ * infinite one.
+ */
+BOOST_AUTO_TEST_CASE(checkCoincident) {
+
+	SIMDInstructionSet sets[4] = { ScalarInstructions, SSE2Instructions,
+			AVX2Instructions, AVX512Instructions };
+	AccumulationMode modes[3] = { FloatAccumulation, CompensatedAccumulation,
+			DoubleAccumulation };
+	auto bodies = getRandomSystem(37).bodies();
+	bodies[20].pos(bodies[3].pos());
+	auto ref = DirectSolver().getPotentials(bodies);
+	BOOST_REQUIRE(isinf(ref[3]) && isinf(ref[20]) && isfinite(ref[0]));
+	for (auto isa : sets) {
+		if (isa > SIMDSolver::detectInstructionSet()) {
+			continue;
+		}
+		for (auto mode : modes) {
+			MixedPrecisionSolver solver(isa, mode);
+			solver.verify(true);
+			auto potentials = solver.getPotentials(bodies);
+			for (int i = 0; i < 37; i++) {
+				if (isinf(ref[i])) {
+					BOOST_REQUIRE_EQUAL(ref[i], potentials[i]);
+				} else {
+					BOOST_REQUIRE_CLOSE(ref[i], potentials[i], 1.0e-3);
+				}
+			}
+		}
+	}
+
+	return;
+}
+
+/**
+ * This operation checks the error report and that compensated summation
+ * is more accurate than plain float summation.
+ */
+BOOST_AUTO_TEST_CASE(checkReport) {
+
+	auto bodies = getRandomSystem(5000).bodies();
+	MixedPrecisionSolver solver(FloatAccumulation);
+	BOOST_REQUIRE_EQUAL(SIMDSolver::detectInstructionSet(),
+			solver.instructionSet());
+	BOOST_REQUIRE_EQUAL(0, solver.report().numBodies);
+	solver.verify(true);
+	solver.threads(2);
+	solver.getPotentials(bodies);
+	PrecisionReport floatReport = solver.report();
+	BOOST_REQUIRE_EQUAL(5000, floatReport.numBodies);
+	BOOST_REQUIRE(floatReport.worstBody >= 0);
+	BOOST_REQUIRE(floatReport.rmsError <= floatReport.maxError);
+	BOOST_REQUIRE_SMALL(floatReport.maxError, 1.0e-5);
+
+	solver.accumulation(CompensatedAccumulation);
+	solver.getPotentials(bodies);
+	PrecisionReport compensatedReport = solver.report();
+	BOOST_REQUIRE_SMALL(compensatedReport.maxError, 1.0e-6);
+	BOOST_REQUIRE(compensatedReport.rmsError < floatReport.rmsError);
+
+	// An impossible tolerance must fail
+	solver.verify(true, -1.0);
+	BOOST_REQUIRE_THROW(solver.getPotentials(bodies), const char *);
+
+	BOOST_REQUIRE_EQUAL(string("compensated"),
+			MixedPrecisionSolver::name(CompensatedAccumulation));
+
+	return;
+}
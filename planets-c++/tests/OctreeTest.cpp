@@ -0,0 +1,106 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE planets
+
+#if defined __GNUC__ && __GNUC__>=6
+  #pragma GCC diagnostic ignored "-Wwrite-strings"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+#include <vector>
+#include <math.h>
+#include "../Octree.h"
+#include "RandomSystem.h"
+
+using namespace std;
+using namespace planets;
+
+/**
+ * This operation checks that every body lands in exactly one leaf, that the
+ * leaves are no bigger than requested and that the root carries all of the
+ * mass of the system.
+ */
+BOOST_AUTO_TEST_CASE(checkBuild) {
+
+	int size = 1000, leafSize = 4;
+	BodySystem system = getRandomSystem(size, 2.0, 0.0, 2.0);
+	double totalMass = 0.0;
+	for (int i = 0; i < size; i++) {
+		totalMass += system.m()[i];
+	}
+
+	Octree tree(system, leafSize);
+	const auto & cells = tree.nodes();
+	BOOST_REQUIRE_CLOSE(totalMass, cells[0].mass, 1.0e-10);
+	BOOST_REQUIRE_EQUAL(0, cells[0].begin);
+	BOOST_REQUIRE_EQUAL(size, cells[0].end);
+
+	// Check the leaves
+	vector<int> seen(size, 0);
+	for (auto & cell : cells) {
+		if (cell.leaf) {
+			BOOST_REQUIRE(cell.end - cell.begin <= leafSize);
+			for (int i = cell.begin; i < cell.end; i++) {
+				seen[tree.order()[i]]++;
+				// The bodies must be inside of their cell
+				BOOST_REQUIRE(fabs(tree.x()[i] - cell.center[0]) <= cell.halfWidth);
+				BOOST_REQUIRE(fabs(tree.y()[i] - cell.center[1]) <= cell.halfWidth);
+				BOOST_REQUIRE(fabs(tree.z()[i] - cell.center[2]) <= cell.halfWidth);
+			}
+		}
+	}
+	for (int i = 0; i < size; i++) {
+		BOOST_REQUIRE_EQUAL(1, seen[i]);
+	}
+
+	return;
+}
+
+/**
+ * This operation checks that bodies at the same position do not cause the
+ * tree to split forever.
+ */
+BOOST_AUTO_TEST_CASE(checkCoincidentBodies) {
+
+	CelestialBodyData data;
+	data.pos = {1.0, 1.0, 1.0};
+	data.vel = {0.0, 0.0, 0.0};
+	data.mass = 1.0;
+	data.type = Planetary;
+	vector<CelestialBody> bodies(20, CelestialBody(data));
+
+	Octree tree(BodySystem(bodies), 2);
+	BOOST_REQUIRE_CLOSE(20.0, tree.nodes()[0].mass, 1.0e-12);
+
+	return;
+}
@@ -0,0 +1,155 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE planets
+
+#if defined __GNUC__ && __GNUC__>=6
+  #pragma GCC diagnostic ignored "-Wwrite-strings"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+#include <vector>
+#include <string>
+#include "../Options.h"
+
+using namespace std;
+using namespace planets;
+
+namespace {
+
+/**
+ * This operation parses a command line given without the program name.
+ */
+Options parse(vector<string> arguments) {
+	vector<char *> argv = { (char *) "planets-c++" };
+	for (auto & argument : arguments) {
+		argv.push_back(&argument[0]);
+	}
+	return parseOptions(argv.size(), argv.data());
+}
+
+/**
+ * This operation returns the error thrown for a command line, or an empty
+ * string if it is valid.
+ */
+string error(const vector<string> & arguments) {
+	try {
+		parse(arguments);
+	} catch (const char * message) {
+		return message;
+	}
+	return "";
+}
+
+} /* anonymous namespace */
+
+/**
+ * This operation checks the defaults and that every option is read.
+ */
+BOOST_AUTO_TEST_CASE(checkOptions) {
+
+	Options defaults = parse({});
+	BOOST_REQUIRE_EQUAL("planetary-system.csv", defaults.input);
+	BOOST_REQUIRE_EQUAL("direct", defaults.solver);
+	BOOST_REQUIRE_EQUAL(1, defaults.threads);
+	BOOST_REQUIRE_EQUAL(0.5, defaults.theta);
+	BOOST_REQUIRE_EQUAL(8, defaults.precision);
+	BOOST_REQUIRE_EQUAL(ResultsWriter::Text, defaults.format);
+	BOOST_REQUIRE(!defaults.errorReport && !defaults.profile
+			&& !defaults.help);
+
+	Options options = parse({"--input", "in.snap", "--output", "out.txt",
+			"--solver", "mixed", "--accumulation", "double",
+			"--error-report", "--threads", "4", "--theta", "0.25",
+			"--precision", "17", "--format", "csv", "--profile", "--trace",
+			"trace.json", "--help"});
+	BOOST_REQUIRE_EQUAL("in.snap", options.input);
+	BOOST_REQUIRE_EQUAL("out.txt", options.output);
+	BOOST_REQUIRE_EQUAL("mixed", options.solver);
+	BOOST_REQUIRE_EQUAL(DoubleAccumulation, options.accumulation);
+	BOOST_REQUIRE(options.errorReport);
+	BOOST_REQUIRE_EQUAL(4, options.threads);
+	BOOST_REQUIRE_EQUAL(0.25, options.theta);
+	BOOST_REQUIRE_EQUAL(17, options.precision);
+	BOOST_REQUIRE_EQUAL(ResultsWriter::CSV, options.format);
+	BOOST_REQUIRE(options.profile);
+	BOOST_REQUIRE_EQUAL("trace.json", options.trace);
+	BOOST_REQUIRE(options.help);
+
+	return;
+}
+
+/**
+ * This operation checks that the numbers are only accepted whole and in
+ * range.
+ */
+BOOST_AUTO_TEST_CASE(checkNumbers) {
+
+	BOOST_REQUIRE_EQUAL(42, parseNumber<int>("42"));
+	BOOST_REQUIRE_EQUAL(-1.5e3, parseNumber<double>("-1.5e3"));
+	for (string value : {"", "2x", "x2", " 2", "1.5", "99999999999"}) {
+		BOOST_REQUIRE_THROW(parseNumber<int>(value), const char *);
+	}
+	BOOST_REQUIRE_THROW(parseNumber<double>("0.5e"), const char *);
+
+	string invalid = "Invalid option value!";
+	BOOST_REQUIRE_EQUAL(invalid, error({"--threads", "2x"}));
+	BOOST_REQUIRE_EQUAL(invalid, error({"--threads", "-1"}));
+	BOOST_REQUIRE_EQUAL(invalid, error({"--theta", "nan"}));
+	BOOST_REQUIRE_EQUAL(invalid, error({"--theta", "-0.5"}));
+	BOOST_REQUIRE_EQUAL(invalid, error({"--precision", "18"}));
+	BOOST_REQUIRE_EQUAL(invalid, error({"--precision", "abc"}));
+	BOOST_REQUIRE_EQUAL("", error({"--threads", "0", "--theta", "0"}));
+
+	return;
+}
+
+/**
+ * This operation checks the errors of unknown and inconsistent options.
+ */
+BOOST_AUTO_TEST_CASE(checkErrors) {
+
+	BOOST_REQUIRE_EQUAL("Unknown solver!", error({"--solver", "magic"}));
+	BOOST_REQUIRE_EQUAL("Unknown output format!",
+			error({"--format", "xml"}));
+	BOOST_REQUIRE_EQUAL("Unknown accumulation mode!",
+			error({"--accumulation", "half"}));
+	BOOST_REQUIRE_EQUAL("Unknown option!", error({"--fast", "1"}));
+	BOOST_REQUIRE_EQUAL("Missing option value!", error({"--threads"}));
+	BOOST_REQUIRE_EQUAL("The error report needs the mixed solver!",
+			error({"--error-report"}));
+	BOOST_REQUIRE_EQUAL("The error report needs the mixed solver!",
+			error({"--error-report", "--solver", "simd"}));
+	BOOST_REQUIRE_EQUAL("", error({"--error-report", "--solver", "mixed"}));
+
+	return;
+}
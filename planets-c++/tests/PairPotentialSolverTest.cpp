@@ -0,0 +1,178 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE planets
+
+#if defined __GNUC__ && __GNUC__>=6
+  #pragma GCC diagnostic ignored "-Wwrite-strings"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+#include <vector>
+#include <math.h>
+#include "../PairPotentialSolver.h"
+#include "../DirectSolver.h"
+#include "RandomSystem.h"
+
+using namespace std;
+using namespace planets;
+
+/**
+ * This operation creates a system of two unit masses a distance r apart.
+ */
+BodySystem getPair(double r) {
+	BodySystem system;
+	CelestialBodyData data = {};
+	data.mass = 1.0;
+	data.type = Star;
+	system.add(data);
+	data.pos = {r, 0.0, 0.0};
+	system.add(data);
+	return system;
+}
+
+/**
+ * This operation checks that the plain kernel matches direct summation and
+ * that the units only change G.
+ */
+BOOST_AUTO_TEST_CASE(checkPlain) {
+
+	auto system = getRandomSystem(300, 1.0e11, 0.5, 1.5);
+	auto ref = DirectSolver().getPotentials(system);
+	PairPotentialSolver<> solver;
+	BOOST_REQUIRE_EQUAL(PotentialSolver::G, solver.G);
+	auto potentials = solver.getPotentials(system);
+	PairPotentialSolver<NoSoftening, NoCutoff, NBodyUnits> nbody;
+	auto nbodyPotentials = nbody.getPotentials(system);
+	for (int i = 0; i < system.size(); i++) {
+		BOOST_REQUIRE_CLOSE(ref[i], potentials[i], 1.0e-11);
+		BOOST_REQUIRE_CLOSE(ref[i] / PotentialSolver::G, nbodyPotentials[i],
+				1.0e-11);
+	}
+	BOOST_REQUIRE_CLOSE(4.0 * M_PI * M_PI,
+			(PairPotentialSolver<NoSoftening, NoCutoff, SolarUnits>::G),
+			1.0e-12);
+
+	return;
+}
+
+/**
+ * This operation checks the softening kernels on a single pair.
+ */
+BOOST_AUTO_TEST_CASE(checkSoftening) {
+
+	typedef PairPotentialSolver<PlummerSoftening, NoCutoff, NBodyUnits>
+			PlummerSolver;
+	typedef PairPotentialSolver<SplineSoftening, NoCutoff, NBodyUnits>
+			SplineSolver;
+	PlummerSolver plummer(PlummerSoftening(0.1));
+	SplineSolver spline(SplineSoftening(0.28));
+
+	// Coincident bodies have a finite potential
+	auto potentials = plummer.getPotentials(getPair(0.0));
+	BOOST_REQUIRE_CLOSE(-10.0, potentials[0], 1.0e-12);
+	potentials = spline.getPotentials(getPair(0.0));
+	BOOST_REQUIRE_CLOSE(-10.0, potentials[1], 1.0e-12);
+
+	// Plummer softening changes every distance, the spline does not
+	potentials = plummer.getPotentials(getPair(1.0));
+	BOOST_REQUIRE_CLOSE(-1.0 / sqrt(1.01), potentials[0], 1.0e-12);
+	potentials = spline.getPotentials(getPair(1.0));
+	BOOST_REQUIRE_CLOSE(-1.0, potentials[0], 1.0e-12);
+
+	// The spline is continuous where its pieces meet, decreasing, and
+	// below the Newtonian kernel inside of h
+	SplineSoftening kernel(1.0);
+	for (double r : {0.5, 1.0}) {
+		BOOST_REQUIRE_CLOSE(kernel.inverse((r - 1.0e-9) * (r - 1.0e-9)),
+				kernel.inverse((r + 1.0e-9) * (r + 1.0e-9)), 1.0e-6);
+	}
+	double last = kernel.inverse(0.0);
+	for (double r = 0.01; r < 1.0; r += 0.01) {
+		BOOST_REQUIRE(kernel.inverse(r * r) < last);
+		BOOST_REQUIRE(kernel.inverse(r * r) < 1.0 / r);
+		last = kernel.inverse(r * r);
+	}
+
+	return;
+}
+
+/**
+ * This operation checks the cutoffs against a brute force sum over the
+ * pairs inside of the cutoff.
+ */
+BOOST_AUTO_TEST_CASE(checkCutoff) {
+
+	auto system = getRandomSystem(2000, 10.0, 0.5, 1.5);
+	double cutoff = 1.3, epsilon = 0.05;
+	PlummerSoftening softening(epsilon);
+	PairPotentialSolver<PlummerSoftening, SharpCutoff, NBodyUnits> sharp(
+			softening, SharpCutoff(cutoff));
+	PairPotentialSolver<PlummerSoftening, ShiftedCutoff, NBodyUnits> shifted(
+			softening, ShiftedCutoff(cutoff));
+	auto sharpPotentials = sharp.getPotentials(system);
+	auto shiftedPotentials = shifted.getPotentials(system);
+
+	double shift = 1.0 / sqrt(cutoff * cutoff + epsilon * epsilon);
+	for (int i = 0; i < system.size(); i++) {
+		double sharpSum = 0.0, shiftedSum = 0.0;
+		for (int j = 0; j < system.size(); j++) {
+			double dx = system.x()[i] - system.x()[j];
+			double dy = system.y()[i] - system.y()[j];
+			double dz = system.z()[i] - system.z()[j];
+			double r2 = dx * dx + dy * dy + dz * dz;
+			if (j != i && r2 < cutoff * cutoff) {
+				sharpSum += system.m()[j] / sqrt(r2 + epsilon * epsilon);
+				shiftedSum += system.m()[j]
+						* (1.0 / sqrt(r2 + epsilon * epsilon) - shift);
+			}
+		}
+		BOOST_REQUIRE_CLOSE(-system.m()[i] * sharpSum, sharpPotentials[i],
+				1.0e-10);
+		BOOST_REQUIRE_CLOSE(-system.m()[i] * shiftedSum, shiftedPotentials[i],
+				1.0e-10);
+	}
+
+	// The results do not depend on the number of threads
+	sharp.threads(3);
+	BOOST_REQUIRE(sharp.getPotentials(system) == sharpPotentials);
+
+	// A pair just inside of a shifted cutoff barely interacts
+	auto potentials = shifted.getPotentials(getPair(cutoff - 1.0e-9));
+	BOOST_REQUIRE_SMALL(potentials[0], 1.0e-8);
+
+	BOOST_REQUIRE_THROW(
+			(PairPotentialSolver<NoSoftening, SharpCutoff>(NoSoftening(),
+					SharpCutoff(0.0))), const char *);
+
+	return;
+}
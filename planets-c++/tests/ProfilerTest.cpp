@@ -0,0 +1,182 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE planets
+
+#if defined __GNUC__ && __GNUC__>=6
+  #pragma GCC diagnostic ignored "-Wwrite-strings"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include "../Profiler.h"
+#include "../ThreadPool.h"
+#include "../DirectSolver.h"
+#include "../CatalogGenerator.h"
+#include "../CSVBodyParser.h"
+
+using namespace std;
+using namespace planets;
+
+/**
+ * This operation checks that nothing is recorded while the profiler is off.
+ */
+BOOST_AUTO_TEST_CASE(checkDisabled) {
+
+	Profiler::reset();
+	Profiler::enabled(false);
+	BOOST_REQUIRE(!Profiler::enabled());
+	{
+		PLANETS_TIMER("test::disabled");
+		PLANETS_COUNT(BodiesParsed, 5);
+	}
+	BOOST_REQUIRE(Profiler::events().empty());
+	BOOST_REQUIRE_EQUAL(0, Profiler::counter(Profiler::BodiesParsed));
+
+	return;
+}
+
+/**
+ * This operation checks that nothing is recorded when profiling is compiled
+ * out with make PROFILING=0, even while the profiler is on. Neither the
+ * macros of the test nor the timers and counters of the library count.
+ */
+BOOST_AUTO_TEST_CASE(checkCompiledOut) {
+
+	// The test and the library must be built with the same switch
+	BOOST_REQUIRE_EQUAL(PLANETS_PROFILING != 0, Profiler::compiled());
+	if (Profiler::compiled()) {
+		return;
+	}
+
+	Profiler::reset();
+	Profiler::enabled(true);
+	{
+		PLANETS_TIMER("test::compiledOut");
+		PLANETS_COUNT(BodiesParsed, 5);
+		DirectSolver solver;
+		solver.threads(2);
+		solver.getPotentials(CatalogGenerator().generate(100));
+	}
+	Profiler::enabled(false);
+	BOOST_REQUIRE(Profiler::events().empty());
+	BOOST_REQUIRE_EQUAL(0, Profiler::counter(Profiler::BodiesParsed));
+	BOOST_REQUIRE_EQUAL(0, Profiler::counter(Profiler::Interactions));
+	ostringstream report;
+	Profiler::report(report);
+	BOOST_REQUIRE(report.str().find("compiled out") != string::npos);
+
+	return;
+}
+
+/**
+ * This operation checks the events and counters of a small pipeline. There
+ * is nothing to check when profiling is compiled out.
+ */
+BOOST_AUTO_TEST_CASE(checkPipeline) {
+
+	if (!Profiler::compiled()) {
+		return;
+	}
+	const string fileName = "profile.csv";
+	CatalogGenerator generator;
+	generator.write(fileName, 500);
+
+	Profiler::reset();
+	Profiler::enabled(true);
+	CSVBodyParser parser;
+	auto system = parser.parseSystem(fileName);
+	DirectSolver solver;
+	solver.threads(3);
+	solver.blockSize(50);
+	{
+		PLANETS_TIMER("test::potentials");
+		solver.getPotentials(system);
+	}
+	Profiler::enabled(false);
+
+	// Check the counters
+	ifstream file(fileName, ios::binary | ios::ate);
+	BOOST_REQUIRE_EQUAL((long) file.tellg(),
+			Profiler::counter(Profiler::BytesRead));
+	BOOST_REQUIRE_EQUAL(500, Profiler::counter(Profiler::BodiesParsed));
+	BOOST_REQUIRE_EQUAL(500 * 499, Profiler::counter(Profiler::Interactions));
+
+	// Every block of the solver is an event, and the timer surrounds them
+	auto events = Profiler::events();
+	int numBlocks = 0;
+	long potentialsStart = -1, potentialsEnd = -1;
+	for (const auto & event : events) {
+		BOOST_REQUIRE(event.duration >= 0);
+		if (string(event.name) == "ThreadPool::block") {
+			numBlocks++;
+		} else if (string(event.name) == "test::potentials") {
+			potentialsStart = event.start;
+			potentialsEnd = event.start + event.duration;
+		}
+	}
+	BOOST_REQUIRE_EQUAL(10, numBlocks);
+	BOOST_REQUIRE(potentialsStart >= 0);
+	for (const auto & event : events) {
+		if (string(event.name) == "ThreadPool::block") {
+			BOOST_REQUIRE(event.start >= potentialsStart);
+			BOOST_REQUIRE(event.start + event.duration <= potentialsEnd);
+		}
+	}
+
+	// Check the report and the trace
+	ostringstream report;
+	Profiler::report(report);
+	BOOST_REQUIRE(report.str().find("DirectSolver::getPotentials")
+			!= string::npos);
+	BOOST_REQUIRE(report.str().find("interactions") != string::npos);
+	BOOST_REQUIRE(report.str().find("thread 0") != string::npos);
+	const string traceName = "profile.json";
+	Profiler::writeTrace(traceName);
+	ifstream trace(traceName);
+	string contents((istreambuf_iterator<char>(trace)),
+			istreambuf_iterator<char>());
+	BOOST_REQUIRE_EQUAL(0, contents.find("{\"traceEvents\":["));
+	BOOST_REQUIRE(contents.find("\"ph\":\"X\"") != string::npos);
+	BOOST_REQUIRE(contents.find("\"ph\":\"C\"") != string::npos);
+	BOOST_REQUIRE_THROW(Profiler::writeTrace("missing/profile.json"),
+			const char *);
+
+	remove(fileName.c_str());
+	remove(traceName.c_str());
+	Profiler::reset();
+	BOOST_REQUIRE(Profiler::events().empty());
+
+	return;
+}
@@ -0,0 +1,80 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#ifndef TESTS_RANDOMSYSTEM_H_
+#define TESTS_RANDOMSYSTEM_H_
+
+#include <string>
+#include <random>
+#include "../BodySystem.h"
+
+namespace planets {
+
+/**
+ * This operation creates a reproducible random system of bodies for the
+ * tests. The bodies are spread uniformly over a cube, or every other body is
+ * put in a small clump to give the trees an uneven distribution. Use
+ * BodySystem::bodies() for the solvers that take a list of bodies.
+ * @param numBodies the number of bodies
+ * @param size the width of the cube, which starts at the origin. The
+ * default of 2^32 gives the scales of planetary-system.csv.
+ * @param minMass the smallest mass
+ * @param maxMass the largest mass
+ * @param clumped whether every other body is in a clump around a quarter of
+ * the way along the diagonal, with a spread of a twentieth of the width
+ * @return the system
+ */
+inline BodySystem getRandomSystem(int numBodies, double size = 4294967296.0,
+		double minMass = 0.0, double maxMass = 4294967296.0,
+		bool clumped = false) {
+	std::mt19937 rng(123456);
+	std::uniform_real_distribution<double> position(0.0, size),
+			mass(minMass, maxMass);
+	std::normal_distribution<double> clump(0.25 * size, 0.05 * size);
+	BodySystem system;
+	for (int i = 0; i < numBodies; i++) {
+		CelestialBodyData data = {};
+		if (clumped && i % 2) {
+			data.pos = {clump(rng), clump(rng), clump(rng)};
+		} else {
+			data.pos = {position(rng), position(rng), position(rng)};
+		}
+		data.mass = mass(rng);
+		data.label = std::to_string(i);
+		data.type = Planetary;
+		system.add(data);
+	}
+	return system;
+}
+
+} /* namespace planets */
+
+#endif /* TESTS_RANDOMSYSTEM_H_ */
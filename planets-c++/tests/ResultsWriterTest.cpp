@@ -0,0 +1,179 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE planets
+
+#if defined __GNUC__ && __GNUC__>=6
+  #pragma GCC diagnostic ignored "-Wwrite-strings"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include "../ResultsWriter.h"
+
+using namespace std;
+using namespace planets;
+
+namespace {
+
+/**
+ * This operation creates a small system with known labels and potentials.
+ */
+BodySystem makeSystem(int numBodies, vector<double> & potentials) {
+	BodySystem bodies;
+	potentials.clear();
+	for (int i = 0; i < numBodies; i++) {
+		CelestialBodyData data = {};
+		data.label = "body" + to_string(i);
+		bodies.add(data);
+		potentials.push_back(-1.0e3 * (i + 1) / 7.0);
+	}
+	return bodies;
+}
+
+/**
+ * This operation reads a whole file into a string.
+ */
+string readFile(const string & fileName) {
+	ifstream file(fileName, ios::binary);
+	stringstream contents;
+	contents << file.rdbuf();
+	return contents.str();
+}
+
+} /* anonymous namespace */
+
+/**
+ * This operation checks that the text format matches what iostreams write,
+ * even when the buffer is much smaller than the output.
+ */
+BOOST_AUTO_TEST_CASE(checkText) {
+
+	const string fileName = "results.txt";
+	vector<double> potentials;
+	BodySystem bodies = makeSystem(2000, potentials);
+	ResultsWriter writer(fileName, ResultsWriter::Text, 8, 4096);
+	BOOST_REQUIRE_EQUAL(ResultsWriter::Text, writer.format());
+	BOOST_REQUIRE_EQUAL(8, writer.precision());
+	writer.write(bodies, potentials);
+	writer.write("done\n");
+	writer.close();
+
+	stringstream expected;
+	expected << fixed << setprecision(8);
+	for (int i = 0; i < bodies.size(); i++) {
+		expected << bodies.label(i) << ", potential = " << potentials[i]
+				<< "\n";
+	}
+	expected << "done\n";
+	BOOST_REQUIRE_EQUAL(expected.str(), readFile(fileName));
+
+	// Closing twice is fine, writing after closing is not
+	writer.close();
+	BOOST_REQUIRE_THROW(writer.write("more\n"), const char *);
+	remove(fileName.c_str());
+
+	return;
+}
+
+/**
+ * This operation checks the CSV format and the precision.
+ */
+BOOST_AUTO_TEST_CASE(checkCSV) {
+
+	const string fileName = "results.csv";
+	vector<double> potentials;
+	BodySystem bodies = makeSystem(3, potentials);
+	{
+		ResultsWriter writer(fileName, ResultsWriter::CSV, 2);
+		writer.write(bodies, potentials);
+	}
+	BOOST_REQUIRE_EQUAL("label,potential\n"
+			"body0,-142.86\n"
+			"body1,-285.71\n"
+			"body2,-428.57\n", readFile(fileName));
+	remove(fileName.c_str());
+
+	return;
+}
+
+/**
+ * This operation checks that the binary format keeps the potentials exactly.
+ */
+BOOST_AUTO_TEST_CASE(checkBinary) {
+
+	const string fileName = "results.bin";
+	vector<double> potentials;
+	BodySystem bodies = makeSystem(10000, potentials);
+	{
+		ResultsWriter writer(fileName, ResultsWriter::Binary, 8, 4096);
+		writer.write(bodies, potentials);
+	}
+
+	string contents = readFile(fileName);
+	BOOST_REQUIRE_EQUAL(16 + 8 * potentials.size(), contents.size());
+	BOOST_REQUIRE_EQUAL(0, memcmp(contents.data(), "PLANPOT", 8));
+	uint64_t numBodies;
+	memcpy(&numBodies, contents.data() + 8, sizeof(numBodies));
+	BOOST_REQUIRE_EQUAL(potentials.size(), numBodies);
+	vector<double> readPotentials(numBodies);
+	memcpy(readPotentials.data(), contents.data() + 16, 8 * numBodies);
+	BOOST_REQUIRE(readPotentials == potentials);
+	remove(fileName.c_str());
+
+	return;
+}
+
+/**
+ * This operation checks the errors.
+ */
+BOOST_AUTO_TEST_CASE(checkErrors) {
+
+	BOOST_REQUIRE_THROW(ResultsWriter("no/such/directory/results.txt"),
+			const char *);
+
+	const string fileName = "results.err";
+	vector<double> potentials;
+	BodySystem bodies = makeSystem(3, potentials);
+	potentials.pop_back();
+	ResultsWriter writer(fileName);
+	BOOST_REQUIRE_THROW(writer.write(bodies, potentials), const char *);
+	writer.close();
+	remove(fileName.c_str());
+
+	return;
+}
@@ -0,0 +1,128 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE planets
+
+#if defined __GNUC__ && __GNUC__>=6
+  #pragma GCC diagnostic ignored "-Wwrite-strings"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+#include <vector>
+#include <math.h>
+#include "../SIMDSolver.h"
+#include "../DirectSolver.h"
+#include "RandomSystem.h"
+
+using namespace std;
+using namespace planets;
+
+/**
+ * This operation checks every instruction set that this processor supports
+ * against direct summation, including system sizes that do not fill the
+ * vectors.
+ */
+BOOST_AUTO_TEST_CASE(checkInstructionSets) {
+
+	SIMDInstructionSet sets[4] = { ScalarInstructions, SSE2Instructions,
+			AVX2Instructions, AVX512Instructions };
+	DirectSolver direct;
+	for (int size : {1, 2, 7, 9, 100, 257}) {
+		auto bodies = getRandomSystem(size).bodies();
+		auto ref = direct.getPotentials(bodies);
+		for (auto isa : sets) {
+			if (isa > SIMDSolver::detectInstructionSet()) {
+				continue;
+			}
+			SIMDSolver solver(isa);
+			BOOST_REQUIRE_EQUAL(isa, solver.instructionSet());
+			auto potentials = solver.getPotentials(bodies);
+			BOOST_REQUIRE_EQUAL(size, potentials.size());
+			for (int i = 0; i < size; i++) {
+				BOOST_REQUIRE_CLOSE(ref[i], potentials[i], 1.0e-11);
+			}
+		}
+	}
+
+	return;
+}
+
+/**
+ * This operation checks the verification mode.
+ */
+BOOST_AUTO_TEST_CASE(checkVerification) {
+
+	auto bodies = getRandomSystem(100).bodies();
+	SIMDSolver solver;
+	BOOST_REQUIRE_EQUAL(SIMDSolver::detectInstructionSet(),
+			solver.instructionSet());
+	BOOST_REQUIRE_EQUAL(0.0, solver.error());
+	solver.verify(true);
+	solver.getPotentials(bodies);
+	BOOST_REQUIRE_SMALL(solver.error(), 1.0e-12);
+
+	// An impossible tolerance must fail unless the kernel is scalar
+	if (solver.instructionSet() != ScalarInstructions) {
+		solver.verify(true, -1.0);
+		BOOST_REQUIRE_THROW(solver.getPotentials(bodies), const char *);
+	}
+
+	return;
+}
+
+/**
+ * This operation checks that coincident bodies give infinite potentials in
+ * every kernel, like direct summation, and pass verification.
+ */
+BOOST_AUTO_TEST_CASE(checkCoincident) {
+
+	SIMDInstructionSet sets[4] = { ScalarInstructions, SSE2Instructions,
+			AVX2Instructions, AVX512Instructions };
+	auto bodies = getRandomSystem(3).bodies();
+	bodies[1].pos(bodies[0].pos());
+	auto ref = DirectSolver().getPotentials(bodies);
+	BOOST_REQUIRE(isinf(ref[0]) && isinf(ref[1]) && isfinite(ref[2]));
+	for (auto isa : sets) {
+		if (isa > SIMDSolver::detectInstructionSet()) {
+			continue;
+		}
+		SIMDSolver solver(isa);
+		solver.verify(true);
+		auto potentials = solver.getPotentials(bodies);
+		BOOST_REQUIRE_EQUAL(0.0, solver.error());
+		BOOST_REQUIRE_EQUAL(ref[0], potentials[0]);
+		BOOST_REQUIRE_EQUAL(ref[1], potentials[1]);
+		BOOST_REQUIRE_CLOSE(ref[2], potentials[2], 1.0e-11);
+	}
+
+	return;
+}
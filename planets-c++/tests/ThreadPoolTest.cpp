@@ -0,0 +1,173 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE planets
+
+#if defined __GNUC__ && __GNUC__>=6
+  #pragma GCC diagnostic ignored "-Wwrite-strings"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include "../ThreadPool.h"
+
+using namespace std;
+using namespace planets;
+
+/**
+ * This operation checks that every iteration of a loop runs exactly once,
+ * over several loops on the same pool.
+ */
+BOOST_AUTO_TEST_CASE(checkParallelFor) {
+
+	ThreadPool pool(4);
+	BOOST_REQUIRE_EQUAL(4, pool.size());
+	for (int loop = 0; loop < 20; loop++) {
+		int size = 1000 + loop;
+		vector<int> counts(size, 0);
+		atomic<int> badThreads(0);
+		pool.parallelFor(0, size, 7, [&](int begin, int end, int thread) {
+			if (thread < 0 || thread >= pool.size()) {
+				badThreads++;
+			}
+			for (int i = begin; i < end; i++) {
+				counts[i]++;
+			}
+		});
+		BOOST_REQUIRE_EQUAL(0, badThreads.load());
+		for (int i = 0; i < size; i++) {
+			BOOST_REQUIRE_EQUAL(1, counts[i]);
+		}
+	}
+
+	// Empty loops do nothing
+	pool.parallelFor(5, 5, 1, [&](int, int, int) {
+		BOOST_FAIL("Empty loop ran");
+	});
+
+	return;
+}
+
+/**
+ * This operation checks the default pool size.
+ */
+BOOST_AUTO_TEST_CASE(checkDefaultSize) {
+
+	ThreadPool pool;
+	BOOST_REQUIRE(pool.size() >= 1);
+	ThreadPool single(1);
+	BOOST_REQUIRE_EQUAL(1, single.size());
+
+	return;
+}
+
+/**
+ * This operation checks the pools of classes that can run on several
+ * threads, where a single thread has no pool and runs on the caller.
+ */
+BOOST_AUTO_TEST_CASE(checkCreate) {
+
+	BOOST_REQUIRE(!ThreadPool::create(1));
+	auto pool = ThreadPool::create(3);
+	BOOST_REQUIRE(pool);
+	BOOST_REQUIRE_EQUAL(3, pool->size());
+	BOOST_REQUIRE(ThreadPool::create(0));
+
+	for (auto loopPool : {shared_ptr<ThreadPool>(), pool}) {
+		vector<int> counts(100, 0);
+		int numBlocks = 0;
+		mutex countMutex;
+		ThreadPool::parallelFor(loopPool, 100, 10,
+				[&](int begin, int end, int thread) {
+					lock_guard<mutex> lock(countMutex);
+					numBlocks++;
+					for (int i = begin; i < end; i++) {
+						counts[i]++;
+					}
+				});
+		for (int i = 0; i < 100; i++) {
+			BOOST_REQUIRE_EQUAL(1, counts[i]);
+		}
+		// Without a pool the whole loop is one block
+		BOOST_REQUIRE_EQUAL(loopPool ? 10 : 1, numBlocks);
+		ThreadPool::parallelFor(loopPool, 0, 10, [&](int, int, int) {
+			BOOST_FAIL("Empty loop ran");
+		});
+	}
+
+	return;
+}
+
+/**
+ * This operation checks that an exception thrown by the body of a loop, on
+ * a worker or on the caller, comes out of parallelFor() after every thread
+ * has left the loop, and that the pool still works afterwards.
+ */
+BOOST_AUTO_TEST_CASE(checkExceptions) {
+
+	ThreadPool pool(4);
+	for (int thrower : {0, 1, 2, 3}) {
+		atomic<int> running(0), blocks(0);
+		bool thrown = false;
+		try {
+			pool.parallelFor(0, 1000, 1, [&](int begin, int, int thread) {
+				running++;
+				blocks++;
+				this_thread::sleep_for(chrono::microseconds(100));
+				if (thread == thrower || begin == 500) {
+					running--;
+					throw runtime_error("loop body failed");
+				}
+				running--;
+			});
+		} catch (const runtime_error & error) {
+			thrown = true;
+			BOOST_REQUIRE_EQUAL(string("loop body failed"), error.what());
+		}
+		BOOST_REQUIRE(thrown);
+		// Nothing is still running and the rest of the loop was skipped
+		BOOST_REQUIRE_EQUAL(0, running);
+		BOOST_REQUIRE(blocks < 1000);
+	}
+
+	// The next loop runs normally
+	atomic<int> sum(0);
+	pool.parallelFor(0, 100, 3, [&](int begin, int end, int) {
+		sum += end - begin;
+	});
+	BOOST_REQUIRE_EQUAL(100, sum);
+
+	return;
+}
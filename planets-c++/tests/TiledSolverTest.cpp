@@ -0,0 +1,95 @@
+/**----------------------------------------------------------------------------
+ Copyright (c) 2018-, UT-Battelle, LLC
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ Author(s): Jay Jay Billings (jayjaybillings <at> gmail <dot> com)
+ -----------------------------------------------------------------------------*/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE planets
+
+#if defined __GNUC__ && __GNUC__>=6
+  #pragma GCC diagnostic ignored "-Wwrite-strings"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+#include <vector>
+#include "../TiledSolver.h"
+#include "../DirectSolver.h"
+#include "RandomSystem.h"
+
+using namespace std;
+using namespace planets;
+
+/**
+ * This operation checks the tiled sums against direct summation for tiles
+ * that do not divide the system evenly.
+ */
+BOOST_AUTO_TEST_CASE(checkTiles) {
+
+	auto system = getRandomSystem(1000);
+	auto ref = DirectSolver().getPotentials(system);
+	TiledSolver solver;
+	solver.targetTileSize(33);
+	solver.sourceTileSize(100);
+	solver.threads(2);
+	auto potentials = solver.getPotentials(system);
+	for (int i = 0; i < system.size(); i++) {
+		BOOST_REQUIRE_CLOSE(ref[i], potentials[i], 1.0e-11);
+	}
+	BOOST_REQUIRE_EQUAL(1000.0 * 999.0, solver.interactions());
+	BOOST_REQUIRE(solver.seconds() > 0.0);
+	BOOST_REQUIRE(solver.gflops() > 0.0);
+
+	return;
+}
+
+/**
+ * This operation checks that the tile sizes are tuned on the first solve.
+ */
+BOOST_AUTO_TEST_CASE(checkTuning) {
+
+	auto system = getRandomSystem(300);
+	TiledSolver solver;
+	BOOST_REQUIRE_EQUAL(0, solver.targetTileSize());
+	BOOST_REQUIRE_EQUAL(0, solver.sourceTileSize());
+	auto ref = DirectSolver().getPotentials(system);
+	auto potentials = solver.getPotentials(system);
+	BOOST_REQUIRE(solver.targetTileSize() > 0);
+	BOOST_REQUIRE(solver.sourceTileSize() > 0);
+	for (int i = 0; i < system.size(); i++) {
+		BOOST_REQUIRE_CLOSE(ref[i], potentials[i], 1.0e-11);
+	}
+
+	// Tuning is cached
+	int targets = 0, sources = 0;
+	TiledSolver::tune(solver.instructionSet(), targets, sources);
+	BOOST_REQUIRE_EQUAL(solver.targetTileSize(), targets);
+	BOOST_REQUIRE_EQUAL(solver.sourceTileSize(), sources);
+
+	return;
+}